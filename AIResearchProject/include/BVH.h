@@ -8,9 +8,11 @@
 
 struct BVHNode
 {
-	BVHNode* left;
-	BVHNode* right;
-	int height;
+	BVHNode* left{ nullptr };
+	BVHNode* right{ nullptr };
+	BVHNode* parent{ nullptr };
+	int height{};
+	std::vector<Object*> objects;	// Objects bounded by a leaf, empty for inner nodes
 	virtual ~BVHNode() {}
 };
 
@@ -38,6 +40,20 @@ namespace BVHHelpers
 	float ComputeBoundingVolume(const BoundingSphere& sphere);
 	bool CompareAABB(Object* a, Object* b, int axis);
 	bool CompareSphere(Object* a, Object* b, int axis);
+
+	/* REFIT */
+	void SetChildren(BVHNode* node, BVHNode* left, BVHNode* right, BVTYPE type);
+	bool UpdateInnerVolume(BVHNode* node, BVTYPE type);
+	void UpdateLeafVolume(BVHNode* leaf, BVTYPE type);
+	float SurfaceArea(const AABB& aabb);
+	float SurfaceArea(const BoundingSphere& sphere);
+
+	// Recomputes the leaf volume from its objects and propagates up until an ancestor stops changing
+	void RefitLeaf(BVHNode* leaf, BVTYPE type);
+	void RefitLeaves(std::vector<Object*> const& moved, std::unordered_map<Object*, BVHNode*> const& leaf_of, BVTYPE type);
+
+	// Surface area heuristic cost relative to the root, lower is better
+	float SAHCost(BVHNode* root, BVTYPE type);
 }
 
 class BVHTopDown
@@ -49,17 +65,28 @@ public:
 
 	void ClearBVH(BVHNode* node);
 
+	// Updates the bounds of the leaves holding moved objects and their ancestors only
+	void Refit(std::vector<Object*> const& moved);
+	// Current SAH cost over the cost right after the last build, rebuild once this degrades past a threshold
+	float Degradation() const;
+	BVTYPE GetType() const { return m_type; }
+
 private:
 
 	int ChooseSplitAxis(std::vector<Object*> objects, BVTYPE type);
+	BVHNode* BuildRecursive(std::vector<Object*>& objects, BVTYPE type, int depth);
 	void SplitObjects(std::vector<Object*> objects, int axis, std::vector<Object*>& l_objs, std::vector<Object*>& r_objs, BVTYPE type);
-	BVHNode* CreateLeafNode(std::vector<Object*>& objects, BVTYPE type) const;
+	BVHNode* CreateLeafNode(std::vector<Object*>& objects, BVTYPE type);
 
 	float ComputeTotalBoundingVolume(const std::vector<Object*>& objects, int axis, BVTYPE type);
 
 	const int maxHeight = 7;
 
-	BVHNode* root;
+	BVHNode* root{ nullptr };
+
+	BVTYPE m_type{ T_AABB };
+	float m_build_cost{};
+	std::unordered_map<Object*, BVHNode*> m_leaf_of;
 };
 
 class BVHBotUp
@@ -70,12 +97,20 @@ public:
 
 	void ClearBVH(BVHNode* node);
 
+	void Refit(std::vector<Object*> const& moved);
+	float Degradation() const;
+	BVTYPE GetType() const { return m_type; }
+
 private:
 	void FindNodesToMerge(std::vector<BVHNode*> nodes, BVHNode*& first, BVHNode*& second, BVTYPE type);
 	BVHNode* CreateLeafNode(Object* objects, BVTYPE type) const;
 	BVHNode* MergeNode(BVHNode* first, BVHNode* second, BVTYPE type);
 	float CalculateHeuristic(BVHNode* first, BVHNode* second, BVTYPE type);
-	BVHNode* root;
+	BVHNode* root{ nullptr };
+
+	BVTYPE m_type{ T_AABB };
+	float m_build_cost{};
+	std::unordered_map<Object*, BVHNode*> m_leaf_of;
 };
 
 #endif // !BVH_H
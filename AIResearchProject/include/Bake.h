@@ -0,0 +1,29 @@
+#ifndef BAKE_H
+#define BAKE_H
+
+#include "Terrain.h"
+
+/*
+* Headless terrain generation: runs the same Terrain pipeline as the editor from command line settings,
+* without creating a window or a GL context. AIResearchProject --bake [options], PrintUsage in Bake.cpp lists them.
+*/
+namespace BAKE
+{
+	struct Options
+	{
+		TerrainSettings settings;
+		std::vector<std::string> exports;	// Written after generation, format from the extension
+		std::vector<std::string> heightmaps;	// Rasterised once at heightmap_size for all of them
+		glm::ivec2 heightmap_size{ 1024, 1024 };
+	};
+
+	bool Requested(int argc, char** argv);
+
+	// Fills options from the arguments after --bake, false on an unknown option, a missing value or an unknown export format
+	bool ParseOptions(int argc, char** argv, Options& options);
+
+	// Returns the process exit code
+	int Run(int argc, char** argv);
+}
+
+#endif // !BAKE_H
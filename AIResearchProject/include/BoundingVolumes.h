@@ -0,0 +1,50 @@
+#ifndef BOUNDING_VOLUMES_H
+#define BOUNDING_VOLUMES_H
+
+#include "Primitives.h"
+#include "Utils.h"
+
+/*
+* Bounding volume construction over a view of model-space vertices plus a model transform.
+* Points are transformed on the fly, so nothing is copied out of the mesh buffers.
+* Reductions run in SIMD over fixed-size blocks that are spread across UTILS::ParallelFor workers
+* and combined in block order, so results do not depend on the worker count.
+*/
+namespace BOUNDS
+{
+	using Points = UTILS::Span<const glm::vec3>;
+
+	struct Extremes
+	{
+		glm::vec3 min{}, max{};
+		unsigned int min_idx[3]{}, max_idx[3]{};	// Index of the point attaining min/max on each axis
+	};
+
+	struct PCAResult
+	{
+		glm::vec3 mean{};
+		glm::mat3 covariance{};
+		glm::mat3 eigenvectors{};	// Column i pairs with eigenvalues[i], sorted largest first
+		glm::vec3 eigenvalues{};
+	};
+
+	Extremes ComputeExtremes(Points points, glm::mat4 const& transform);
+	AABB ComputeAABB(Points points, glm::mat4 const& transform);
+
+	unsigned int FarthestPoint(Points points, glm::mat4 const& transform, glm::vec3 const& from);
+	void ExtremalPoints(Points points, glm::mat4 const& transform, glm::vec3 const& dir, unsigned int& imin, unsigned int& imax);
+
+	// Ritter's growing pass, enlarges sphere until it holds every point
+	BoundingSphere GrowSphere(Points points, glm::mat4 const& transform, BoundingSphere sphere);
+
+	BoundingSphere Ritters(Points points, glm::mat4 const& transform);
+	BoundingSphere Larsons(Points points, glm::mat4 const& transform);
+	BoundingSphere PCASphere(Points points, glm::mat4 const& transform, PCAResult* pca = nullptr);
+
+	PCAResult ComputePCA(Points points, glm::mat4 const& transform);
+
+	// Closed form eigen decomposition of a symmetric 3x3 matrix, eigenvalues sorted largest first
+	void SymmetricEigen(glm::mat3 const& a, glm::mat3& eigenvectors, glm::vec3& eigenvalues);
+}
+
+#endif // !BOUNDING_VOLUMES_H
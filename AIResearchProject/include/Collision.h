@@ -3,6 +3,7 @@
 
 #include "includes.h"
 #include <Object.h>
+#include "CollisionWorld.h"
 
 class Collision
 {
@@ -12,6 +13,7 @@ public:
 	void End();
 private:
 	std::vector<Object*>* m_objects;
+	CollisionWorld m_world;
 
 };
 
@@ -0,0 +1,195 @@
+#ifndef COLLISION_WORLD_H
+#define COLLISION_WORLD_H
+
+#include "includes.h"
+#include "Primitives.h"
+
+enum PRIMTYPE
+{
+	P_POINT,
+	P_PLANE,
+	P_TRIANGLE,
+	P_SPHERE,
+	P_AABB,
+	P_RAY,
+	P_COUNT
+};
+
+struct ColliderHandle
+{
+	PRIMTYPE type{ P_POINT };
+	unsigned int index{};
+};
+
+/*
+* Structure-of-arrays pools, one per primitive type.
+* Every pool also records an owner id so results can be mapped back to game objects.
+* Clear() empties a pool but keeps its capacity, so refilling it every frame does not allocate.
+*/
+struct PointPool
+{
+	std::vector<float> x, y, z;
+	std::vector<unsigned int> owner;
+	size_t Size() const { return owner.size(); }
+	void Clear()
+	{
+		x.clear();
+		y.clear();
+		z.clear();
+		owner.clear();
+	}
+};
+
+struct PlanePool
+{
+	std::vector<float> nx, ny, nz, d;
+	std::vector<unsigned int> owner;
+	size_t Size() const { return owner.size(); }
+	void Clear()
+	{
+		nx.clear();
+		ny.clear();
+		nz.clear();
+		d.clear();
+		owner.clear();
+	}
+};
+
+struct TrianglePool
+{
+	std::vector<float> ax, ay, az, bx, by, bz, cx, cy, cz;
+	std::vector<unsigned int> owner;
+	size_t Size() const { return owner.size(); }
+	void Clear()
+	{
+		ax.clear();
+		ay.clear();
+		az.clear();
+		bx.clear();
+		by.clear();
+		bz.clear();
+		cx.clear();
+		cy.clear();
+		cz.clear();
+		owner.clear();
+	}
+};
+
+struct SpherePool
+{
+	std::vector<float> x, y, z, r;
+	std::vector<unsigned int> owner;
+	size_t Size() const { return owner.size(); }
+	void Clear()
+	{
+		x.clear();
+		y.clear();
+		z.clear();
+		r.clear();
+		owner.clear();
+	}
+};
+
+struct AABBPool
+{
+	std::vector<float> min_x, min_y, min_z, max_x, max_y, max_z;
+	std::vector<unsigned int> owner;
+	size_t Size() const { return owner.size(); }
+	void Clear()
+	{
+		min_x.clear();
+		min_y.clear();
+		min_z.clear();
+		max_x.clear();
+		max_y.clear();
+		max_z.clear();
+		owner.clear();
+	}
+};
+
+struct RayPool
+{
+	std::vector<float> ox, oy, oz, dx, dy, dz;
+	std::vector<unsigned int> owner;
+	size_t Size() const { return owner.size(); }
+	void Clear()
+	{
+		ox.clear();
+		oy.clear();
+		oz.clear();
+		dx.clear();
+		dy.clear();
+		dz.clear();
+		owner.clear();
+	}
+};
+
+class CollisionWorld
+{
+public:
+	// True when the pair touches; result gets the plane classification (COPLANAR on a hit) or 1 for the other tests
+	using PairTest = bool (*)(CollisionWorld const& world, unsigned int a, unsigned int b, int& result);
+
+	struct Contact
+	{
+		ColliderHandle a;
+		ColliderHandle b;
+		int result;		// As written by the pair's test
+	};
+
+	void Clear();
+
+	ColliderHandle AddPoint(glm::vec3 const& point, unsigned int owner);
+	ColliderHandle AddPlane(Plane const& plane, unsigned int owner);
+	ColliderHandle AddTriangle(Triangle const& triangle, unsigned int owner);
+	ColliderHandle AddSphere(BoundingSphere const& sphere, unsigned int owner);
+	ColliderHandle AddAABB(AABB const& aabb, unsigned int owner);
+	ColliderHandle AddRay(Ray const& ray, unsigned int owner);
+
+	// Narrow-phase test of a single pair through the dispatch table, false when the pair has no test
+	bool Test(ColliderHandle a, ColliderHandle b, int* result = nullptr) const;
+
+	// Tests every pair in the world, batching the hot pairs; only pairs that touch are kept
+	void Update();
+
+	std::vector<Contact> const& GetContacts() const { return m_contacts; }
+	size_t Count(PRIMTYPE type) const;
+	unsigned int GetOwner(ColliderHandle handle) const;
+
+	Point3D			GetPoint(unsigned int i) const;
+	Plane			GetPlane(unsigned int i) const;
+	Triangle		GetTriangle(unsigned int i) const;
+	BoundingSphere	GetSphere(unsigned int i) const;
+	AABB			GetAABB(unsigned int i) const;
+	Ray				GetRay(unsigned int i) const;
+
+	SpherePool const&	GetSpheres() const	{ return m_spheres; }
+	AABBPool const&		GetAABBs() const	{ return m_aabbs; }
+	RayPool const&		GetRays() const		{ return m_rays; }
+
+	/*
+	* BATCHED KERNELS
+	* Test one primitive against pool entries [begin, end), writing 1/0 into hits[0 .. end - begin)
+	*/
+	static void SphereSphereBatch(SpherePool const& pool, BoundingSphere const& sphere, size_t begin, size_t end, unsigned char* hits);
+	static void AABBAABBBatch(AABBPool const& pool, glm::vec3 const& min_p, glm::vec3 const& max_p, size_t begin, size_t end, unsigned char* hits);
+	static void RayAABBBatch(AABBPool const& pool, Ray const& ray, size_t begin, size_t end, unsigned char* hits);
+
+private:
+	static bool IsBatched(PRIMTYPE a, PRIMTYPE b);
+	void PushBatchHits(PRIMTYPE a, unsigned int i, PRIMTYPE b, size_t begin, size_t end);
+
+	static const PairTest s_dispatch[P_COUNT][P_COUNT];
+
+	PointPool		m_points;
+	PlanePool		m_planes;
+	TrianglePool	m_triangles;
+	SpherePool		m_spheres;
+	AABBPool		m_aabbs;
+	RayPool			m_rays;
+
+	std::vector<Contact>		m_contacts;
+	std::vector<unsigned char>	m_hits;
+};
+
+#endif // !COLLISION_WORLD_H
@@ -16,6 +16,10 @@ namespace CMATH
 	float Distance(Point3D const& p1, Point3D const& p2);
 	float Distance(glm::vec3 const& p1, glm::vec3 const& p2);
 	float Clamp(float val, float min, float max);
+
+	// Sine and cosine of an angle in [0, 90] degrees from a fixed series of adds and multiplies. Unlike the CRT's
+	// these round the same on every compiler, so generation that hashes into the --verify goldens uses them.
+	void SinCosDegrees(double degrees, double& sin, double& cos);
 }
 
 #endif // !CUSTOM_MATH_H
@@ -0,0 +1,38 @@
+#ifndef DUAL_VORONOI_H
+#define DUAL_VORONOI_H
+
+#include "HalfEdgeMesh.h"
+#include "FortuneVoronoi.h"
+
+/*
+* Voronoi diagram read off a Delaunay HalfEdgeMesh instead of swept separately:
+* vertices are triangle circumcentres (one per triangle, so vertex t is dual to triangle t),
+* the edge dual to half-edge e joins circumcentres e / 3 and halfedges[e] / 3,
+* and the cell of site v is the fan of triangles around v, walked from incoming[v].
+* The only storage added on top of the mesh is the circumcentre array.
+*/
+class DualVoronoi
+{
+public:
+	// The mesh is referenced, not copied, and must outlive the diagram
+	void Build(HalfEdgeMesh const& mesh);
+	void Clear();
+
+	HalfEdgeMesh const* GetMesh() const { return m_mesh; }
+	std::vector<glm::vec2> const& GetVertices() const { return m_circumcentres; }
+
+	// Cell vertices of site in counter-clockwise order, returns false for open (hull) cells
+	bool Cell(unsigned int site, std::vector<glm::vec2>& polygon) const;
+
+	// Sites whose cells share an edge with site
+	void Neighbours(unsigned int site, std::vector<unsigned int>& sites) const;
+
+	// Finite edges in the same form as FortuneVoronoi, each shared edge reported once
+	void Edges(std::vector<VoronoiEdge>& edges) const;
+
+private:
+	HalfEdgeMesh const* m_mesh{ nullptr };
+	std::vector<glm::vec2> m_circumcentres;
+};
+
+#endif // !DUAL_VORONOI_H
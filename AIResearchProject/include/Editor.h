@@ -44,9 +44,30 @@ public:
 	int				seed{ 1234 };
 	int				no_points{ 10000 };
 	glm::vec3		map_scale{ glm::vec3(10.f) };
+	int				noise_backend{ 0 };	// NOISE::Backend
+	int				landform{ 0 };		// NOISE::Landform
 	int				perlin_oct{ 4 };
 	float			perlin_persistance{ 0.5f };
 	float			perlin_freq{ 10.f };
+	bool			adaptive_density{ false };
+	float			density_ratio{ 4.f };
+	float			min_angle{ 0.f };
+	bool			seed_boundary{ false };
+	float			rock_slope{ 0.f };
+	bool			biomes{ false };
+	float			biome_size{ 8.f };
+	int				cell_feature{ 0 };	// NOISE::CellFeature
+	float			cell_size{ 2.f };
+	float			cell_height{ 0.3f };
+	char			export_path[260]{ "terrain" };	// Without extension, each export button adds its own
+	int				heightmap_size[2]{ 1024, 1024 };
+	bool			hydraulic_erosion{ false };
+	int				erosion_droplets{ 100000 };
+	int				erosion_resolution{ 512 };
+	bool			thermal_erosion{ false };
+	int				thermal_iterations{ 50 };
+	float			talus_angle{ 35.f };
+	bool			release_cpu_buffers{ false };
 
 private:
 	bool ObjAttribEditor(Object* obj, Object::ATTRIBUTES attrib, const char* attrib_name);
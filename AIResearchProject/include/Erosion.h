@@ -0,0 +1,72 @@
+#ifndef EROSION_H
+#define EROSION_H
+
+#include "includes.h"
+
+#include <memory_resource>
+
+namespace EROSION
+{
+	// Square-celled height raster over the map, heights and spacing in world units
+	struct HeightGrid
+	{
+		int width{};
+		int height{};
+		glm::vec2 origin{};				// World (x, z) of sample (0, 0)
+		float cell{ 1.f };				// World distance between neighbouring samples
+		std::vector<float> heights;		// Row per z
+
+		// Covers [min, max] in x and z with resolution samples along the longer side
+		void Resize(glm::vec2 const& min, glm::vec2 const& max, unsigned int resolution);
+
+		float& At(int x, int y) { return heights[static_cast<size_t>(y) * width + x]; }
+		float At(int x, int y) const { return heights[static_cast<size_t>(y) * width + x]; }
+		glm::vec2 Position(int x, int y) const { return origin + glm::vec2(x, y) * cell; }
+
+		// Bilinear height at world (x, z), clamped to the grid
+		float Sample(float x, float z) const;
+		// Gradient of Sample (dh/dx, dh/dz) at world (x, z)
+		glm::vec2 Gradient(float x, float z) const;
+	};
+
+	struct HydraulicSettings
+	{
+		unsigned int droplets{};			// 0 disables the stage
+		unsigned int lifetime{ 30 };		// Steps per droplet
+		float inertia{ 0.05f };			// How much of its direction a droplet keeps against the slope
+		float capacity{ 4.f };			// Sediment carried per unit of slope, speed and water
+		float min_capacity{ 0.01f };
+		float deposit_rate{ 0.3f };
+		float erode_rate{ 0.3f };
+		float evaporation{ 0.01f };
+		float gravity{ 4.f };
+		int radius{ 3 };					// Erosion brush radius in cells
+	};
+
+	/*
+	* Particle erosion after Beyer (2015): droplets roll downhill, pick up sediment while they can carry more and drop it
+	* when they slow down or climb. Work is split into batches over a tiling of the grid that shifts every batch; each tile
+	* runs a fixed number of droplets confined to it from its own random stream (fewer in the last batch, so exactly
+	* `droplets` run in total), and tiles that could interact never run at the same time, so the result depends on seed
+	* alone and not on the number of worker threads.
+	*/
+	void Hydraulic(HeightGrid& grid, HydraulicSettings const& settings, unsigned int seed,
+				   std::pmr::memory_resource* scratch = std::pmr::get_default_resource());
+
+	struct ThermalSettings
+	{
+		unsigned int iterations{};		// 0 disables the stage
+		float talus_angle{ 35.f };		// Degrees, steeper slopes shed material
+		float rate{ 0.5f };				// Share of the steepest excess moved per iteration, in (0, 1]
+	};
+
+	/*
+	* Thermal weathering after Musgrave et al. (1989): wherever the drop to one of the 8 neighbours exceeds the talus slope,
+	* half the largest excess (scaled by rate) slides down, split between the lower neighbours in proportion to their excess.
+	* Each iteration is two SIMD stencil passes, outflow then gather, between ping-pong buffers, so rows run in parallel
+	* and the result does not depend on the number of worker threads. Material is conserved.
+	*/
+	void Thermal(HeightGrid& grid, ThermalSettings const& settings, std::pmr::memory_resource* scratch = std::pmr::get_default_resource());
+}
+
+#endif // !EROSION_H
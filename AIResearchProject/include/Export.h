@@ -0,0 +1,89 @@
+#ifndef EXPORT_H
+#define EXPORT_H
+
+#include "Terrain.h"
+
+/*
+* Export of a generated terrain, either as its mesh (one vertex per mesh point with its normal and colour, indexed
+* triangles) or rasterised to a regular heightmap. Files are written through a StreamWriter a fixed chunk at a time,
+* so no export holds a second copy of its data in memory.
+*/
+namespace EXPORT
+{
+	// Buffered writes straight to a file descriptor. Each chunk goes to the OS in one write, without stdio's buffer in between.
+	class StreamWriter
+	{
+	public:
+		explicit StreamWriter(const char* path, size_t chunk_size = 1 << 20);
+		~StreamWriter();
+		StreamWriter(StreamWriter const&) = delete;
+		StreamWriter& operator=(StreamWriter const&) = delete;
+
+		// False once opening or any write failed
+		bool Good() const { return m_fd >= 0 && m_good; }
+
+		void Write(const void* data, size_t bytes);
+
+		// Room for up to bytes in the chunk, flushing first if needed; bytes must not exceed the chunk size.
+		// Commit how much of it was used before the next call.
+		char* Reserve(size_t bytes);
+		void Commit(size_t bytes) { m_used += bytes; }
+
+		// Flushes and closes, returns Good()
+		bool Close();
+
+	private:
+		void Flush();
+
+		int m_fd{ -1 };
+		bool m_good{ true };
+		std::vector<char> m_chunk;
+		size_t m_used{};
+	};
+
+	enum class Format
+	{
+		GLB,	// Binary glTF 2.0: one interleaved POSITION / NORMAL / COLOR_0 buffer view and 32 bit indices
+		OBJ		// Wavefront OBJ with per-vertex colours after the position, as read by Blender and MeshLab
+	};
+
+	// From the path's extension, false when it is neither .glb nor .obj
+	bool FormatFromPath(std::string const& path, Format& format);
+
+	// False when the terrain is empty or the file could not be written
+	bool Write(Terrain const& terrain, std::string const& path, Format format);
+	bool WriteGLB(Terrain const& terrain, std::string const& path);
+	bool WriteOBJ(Terrain const& terrain, std::string const& path);
+
+	// Terrain heights on a regular grid over the mesh's bounds in x and z, one sample at each pixel centre
+	struct Heightmap
+	{
+		int width{};
+		int height{};
+		glm::vec2 min{};				// World (x, z) of the grid's corners
+		glm::vec2 max{};
+		float min_height{};
+		float max_height{};
+		std::vector<float> heights;		// Row per z
+	};
+
+	/*
+	* Scan-converts the terrain's triangles into a width x height grid, interpolating vertex heights barycentrically.
+	* Triangles are binned into square tiles that are filled in parallel, each pixel is written by its own tile only.
+	* Pixels outside the mesh, at corners the triangulation does not reach, take the lowest height.
+	*/
+	void RasteriseHeights(Terrain const& terrain, int width, int height, Heightmap& out);
+
+	enum class HeightmapFormat
+	{
+		PNG16,	// 16 bit greyscale PNG over [min_height, max_height], the range is kept in a tEXt chunk
+		R32F	// Raw little endian floats in world units, row per z, no header
+	};
+
+	// .png or .r32 / .raw
+	bool HeightmapFormatFromPath(std::string const& path, HeightmapFormat& format);
+
+	bool WriteHeightmap(Heightmap const& heightmap, std::string const& path, HeightmapFormat format);
+}
+
+#endif // !EXPORT_H
@@ -0,0 +1,109 @@
+#ifndef FORTUNE_VORONOI_H
+#define FORTUNE_VORONOI_H
+
+#include "includes.h"
+
+struct VoronoiEdge
+{
+	glm::dvec2 start{};
+	glm::dvec2 end{};
+	unsigned int left_site{};	// Sites whose cells this edge separates
+	unsigned int right_site{};
+};
+
+/*
+* Fortune's sweep over the same beachline tree as vor::Voronoi (internal nodes are edges, leaves are arcs),
+* but every sweep object lives in a pool owned by the engine:
+*	- beachline nodes are index-linked records in one array, freed nodes go on a free list
+*	- edges and circle events are appended to arrays that are cleared, not freed, between runs
+*	- a cancelled circle event is detected by a stamp mismatch with its arc instead of a set lookup
+*	- site events are a pre-sorted index array merged with a binary heap of circle events
+* Reusing one engine for repeated runs allocates nothing once the pools have grown.
+*/
+class FortuneVoronoi
+{
+public:
+	// Sites are expected inside [0, width] x [0, height]; unbounded edges are closed just past that box.
+	// A site repeating an earlier one gets no edges.
+	std::vector<VoronoiEdge> const& Compute(std::vector<glm::dvec2> const& sites, double width, double height);
+
+	std::vector<VoronoiEdge> const& GetEdges() const { return m_output; }
+
+	// Pre-sizes the pools for a given site count
+	void Reserve(size_t site_count);
+
+private:
+	static constexpr int NIL = -1;
+
+	struct BeachNode
+	{
+		int parent{ NIL }, left{ NIL }, right{ NIL };
+		int site{ NIL };			// Arc: focus site
+		int edge{ NIL };			// Internal node: edge traced by the breakpoint
+		unsigned int stamp{};		// Bumped whenever a pending circle event on this arc becomes stale
+		bool leaf{ false };
+	};
+
+	struct Edge
+	{
+		glm::dvec2 start{}, end{}, direction{};
+		int left_site{}, right_site{};
+		int neighbour{ NIL };		// Other half of an edge that grows in both directions
+		bool output{ true };		// Second halves are merged into their neighbour and not emitted
+	};
+
+	// The key is kept next to the index so heap sifts don't touch the event pool
+	struct HeapEntry
+	{
+		double y;
+		int event;
+		// std heap functions build a max-heap, so the highest circle bottom pops first
+		bool operator<(HeapEntry const& other) const { return y < other.y; }
+	};
+
+	struct CircleEvent
+	{
+		glm::dvec2 centre{};		// Circumcentre of the three sites, the Voronoi vertex
+		glm::dvec2 point{};			// Bottom of the circle, where the sweep line triggers it
+		int arc{};
+		unsigned int stamp{};
+	};
+
+	int NewNode(bool leaf, int site);
+	void FreeNode(int node);
+	void SetLeft(int node, int child);
+	void SetRight(int node, int child);
+
+	int NewEdge(glm::dvec2 const& start, int left_site, int right_site);
+
+	void InsertParabola(int site);
+	void RemoveParabola(int event);
+	void FinishEdges();
+	void CheckCircle(int arc);
+	void CancelCircle(int arc);
+
+	double GetXOfEdge(int node, double y) const;
+	int GetParabolaByX(double x) const;
+	double GetY(int site, double x) const;
+
+	int GetLeftParent(int node) const;
+	int GetRightParent(int node) const;
+	int GetLeftChild(int node) const;
+	int GetRightChild(int node) const;
+
+	std::vector<glm::dvec2> const* m_sites{ nullptr };
+	double m_width{}, m_height{};
+	double m_ly{};
+	int m_root{ NIL };
+
+	std::vector<BeachNode>		m_nodes;
+	std::vector<int>			m_free_nodes;
+	std::vector<Edge>			m_edges;
+	std::vector<CircleEvent>	m_events;
+	std::vector<HeapEntry>		m_heap;
+	std::vector<int>			m_site_order;
+	std::vector<int>			m_stack;
+	std::vector<VoronoiEdge>	m_output;
+};
+
+#endif // !FORTUNE_VORONOI_H
@@ -0,0 +1,107 @@
+#ifndef HALF_EDGE_MESH_H
+#define HALF_EDGE_MESH_H
+
+#include "includes.h"
+#include "Utils.h"
+
+#include <memory_resource>
+
+/*
+* Triangle mesh in the compact half-edge layout used by delaunator:
+*	- half-edge e belongs to triangle e / 3 and runs from triangles[e] to triangles[Next(e)], triangles wind clockwise
+*	- halfedges[e] is the twin half-edge in the neighbouring triangle, NONE on the hull
+*	- incoming[v] is a half-edge ending at v, the hull edge for hull vertices so a fan walk from it is complete
+*	- hull lists the boundary vertices in order
+*	- constrained[e] marks both halves of an edge inserted as a segment, flips and insertions never remove it
+*/
+struct HalfEdgeMesh
+{
+	static constexpr unsigned int NONE = 0xFFFFFFFFu;
+
+	std::vector<glm::vec2>		points;
+	std::vector<unsigned int>	triangles;
+	std::vector<unsigned int>	halfedges;
+	std::vector<unsigned int>	incoming;
+	std::vector<unsigned int>	hull;
+	std::vector<unsigned char>	constrained;
+
+	// Delaunay triangulation of points, throws std::runtime_error when all points are collinear. The triangulator's
+	// working memory comes from scratch; Clear keeps capacity, so re-triangulating in place reuses the mesh's buffers.
+	void Triangulate(UTILS::Span<const glm::vec2> pts, std::pmr::memory_resource* scratch = std::pmr::get_default_resource());
+	void Clear();
+
+	size_t TriangleCount() const { return triangles.size() / 3; }
+
+	// Triangle across edge k (0..2) of triangle, NONE on the hull
+	unsigned int Neighbour(unsigned int triangle, unsigned int k) const;
+
+	// Vertices sharing an edge with vertex, in fan order
+	void VertexNeighbours(unsigned int vertex, std::vector<unsigned int>& vertices) const;
+
+	// Triangle containing p by walking from hint, NONE when p is outside the hull
+	unsigned int Locate(glm::vec2 const& p, unsigned int hint = 0) const;
+
+	// Incremental Delaunay insertion of a point inside the hull: walks from the last inserted triangle,
+	// grows the cavity of triangles whose circumcircle holds p over the adjacency and fans p to its boundary.
+	// Returns the new vertex, the existing one for an exact duplicate, or NONE when p is outside the hull.
+	unsigned int Insert(glm::vec2 const& p);
+
+	// Batch insertion in BRIO order (random rounds, Hilbert order within a round) so consecutive walks stay short
+	void Insert(std::vector<glm::vec2> const& pts);
+
+	// Forces the edge a - b into the mesh by flipping away the edges it crosses, then restores the Delaunay
+	// property around it. Vertices lying on the segment split it. Returns false when the segment (or the piece
+	// past a splitting vertex) would cross an existing constrained edge; that piece is left out.
+	bool InsertSegment(unsigned int a, unsigned int b);
+
+	// Inserts the polyline's points and constrains each consecutive pair, false if a point is outside the hull
+	bool InsertPolyline(std::vector<glm::vec2> const& polyline);
+
+	// Delaunay refinement after Ruppert: skinny triangles (smallest angle below min_angle degrees) get a Steiner point
+	// at their circumcentre. A circumcentre beyond a hull or constrained edge splits that edge at its midpoint instead;
+	// a midpoint that rounds off the edge is still placed on it topologically, see SplitSegment. Bounds above about
+	// 20.7 degrees are not guaranteed to terminate, max_steiner caps the insertions (NONE allows as many as the mesh
+	// has points). Returns the number of points added.
+	unsigned int Refine(float min_angle = 20.f, unsigned int max_steiner = NONE);
+
+	// Half-edge from a to b, or from b to a for a hull edge stored only that way; NONE when a and b are not connected
+	unsigned int FindEdge(unsigned int a, unsigned int b) const;
+
+	// Laplacian smoothing of a per-vertex value, each pass moves values by lambda towards their neighbour average
+	void Smooth(std::vector<float>& values, unsigned int iterations = 1, float lambda = 0.5f) const;
+
+	static unsigned int Next(unsigned int e) { return e % 3 == 2 ? e - 2 : e + 1; }
+	static unsigned int Prev(unsigned int e) { return e % 3 == 0 ? e + 2 : e - 1; }
+	static unsigned int TriangleOf(unsigned int e) { return e / 3; }
+
+private:
+	void BuildIncoming();
+
+	// Swaps the diagonal of the two triangles sharing e, e and its twin become the new diagonal
+	void Flip(unsigned int e);
+	bool IsLocallyDelaunay(unsigned int e) const;
+	void Legalize();
+
+	void SetConstrained(unsigned int e);
+
+	// Splits the hull or constrained edge of half-edge e at p as if p lay exactly on it: both pieces keep the edge's
+	// twin side and constraint. NONE when p rounded off the edge would invert a triangle beside it.
+	unsigned int SplitSegment(unsigned int e, glm::vec2 const& p);
+
+	bool IsSkinny(unsigned int t, double sin2_bound) const;
+	// First hull or constrained half-edge between triangle t and c, or one whose diametral circle holds c; NONE if c is free
+	unsigned int BlockingSegment(unsigned int t, glm::vec2 const& c) const;
+
+	unsigned int m_last{};	// Walk hint, a triangle around the previous insertion
+
+	// Scratch for Insert, kept to avoid per-point allocation
+	std::vector<unsigned int> m_cavity;
+	std::vector<unsigned int> m_boundary;
+	std::vector<unsigned int> m_fan;
+	std::vector<unsigned int> m_crossing;	// Vertex pairs
+	std::vector<unsigned int> m_created;	// Vertex pairs
+	std::vector<unsigned int> m_new_edges;
+	std::vector<unsigned int> m_queue;		// Refine's work list
+};
+
+#endif // !HALF_EDGE_MESH_H
@@ -27,13 +27,20 @@ struct Mesh
 	};
 
 	std::vector<MeshEntry> m_mesh_entries{};
+
+	unsigned int m_vertex_cnt{};	// Vertices uploaded, kept for drawing once the CPU buffers are released
+	unsigned int VertexCount() const { return m_position_buffer.empty() ? m_vertex_cnt : static_cast<unsigned int>(m_position_buffer.size()); }
 };
 
 class MeshLoader
 {
 public:
 	void LoadMesh(std::string path);
-	void LoadTerrain(Terrain& terrain, unsigned int seed = 1234, unsigned int no_pts = 10000, glm::vec3 map_scale = glm::vec3(10.f), unsigned int perlin_oct = 4, float perlin_persistance = 0.5f, float perlin_freq = 10.f);
+	void LoadTerrain(Terrain& terrain, TerrainSettings const& settings = TerrainSettings());
+	// Rebuilds the terrain buffers from output, an empty poisson keeps the current sample points
+	void UploadTerrain(TerrainOutput&& output);
+	// Frees the terrain meshes' CPU-side copies once they are on the GPU, only their vertex counts are kept
+	void SetReleaseCPUBuffers(bool release) { m_release_cpu_buffers = release; }
 	Mesh* GetMesh(std::string name);
 	void LoadDebugMesh();
 	std::unordered_map<std::string, Mesh>& GetMeshes() { return m_meshes; }
@@ -42,6 +49,7 @@ private:
 	void SubdivideIcoSphere(const glm::vec3& v1, const glm::vec3& v2, const glm::vec3& v3, int depth, std::vector<glm::vec3>& vertices);
 
 	std::unordered_map<std::string, Mesh> m_meshes;
+	bool m_release_cpu_buffers{ false };
 };
 
 #endif // !MESHLOADER_H
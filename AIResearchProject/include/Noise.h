@@ -0,0 +1,738 @@
+#ifndef NOISE_H
+#define NOISE_H
+
+#include "includes.h"
+#include "SIMD.h"
+#include "Perlin.h"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace NOISE
+{
+	// Lane-generic helpers so one kernel body serves float, double and SIMD::FN
+	template <typename V>
+	struct Lanes
+	{
+		using Scalar = float;
+		static constexpr int WIDTH = V::WIDTH;
+
+		static V Set1(float x) { return V::Set1(x); }
+		static V Load(const float* p) { return V::Load(p); }
+		static void Store(V v, float* p) { v.Store(p); }
+		static V Floor(V v) { return SIMD::Floor(v); }
+		static V Max(V a, V b) { return SIMD::Max(a, b); }
+		static V Min(V a, V b) { return SIMD::Min(a, b); }
+		static V Abs(V v) { return SIMD::Abs(v); }
+		static V Sqrt(V v) { return SIMD::Sqrt(v); }
+		static V Step(V a, V b) { return SIMD::Select(a >= b, V::Set1(1.f), V::Zero()); }	// 1 where a >= b
+
+		using Mask = V;
+		static Mask Less(V a, V b) { return a < b; }
+		static V Select(Mask m, V a, V b) { return SIMD::Select(m, a, b); }
+	};
+
+	template <>
+	struct Lanes<float>
+	{
+		using Scalar = float;
+		static constexpr int WIDTH = 1;
+
+		static float Set1(float x) { return x; }
+		static float Load(const float* p) { return *p; }
+		static void Store(float v, float* p) { *p = v; }
+		static float Floor(float v) { return std::floor(v); }
+		static float Max(float a, float b) { return a < b ? b : a; }
+		static float Min(float a, float b) { return b < a ? b : a; }
+		static float Abs(float v) { return std::fabs(v); }
+		static float Sqrt(float v) { return std::sqrt(v); }
+		static float Step(float a, float b) { return a >= b ? 1.f : 0.f; }
+
+		using Mask = bool;
+		static bool Less(float a, float b) { return a < b; }
+		static float Select(bool m, float a, float b) { return m ? a : b; }
+	};
+
+	// For kernels that mirror siv's double-precision reference
+	template <>
+	struct Lanes<double>
+	{
+		using Scalar = double;
+		static constexpr int WIDTH = 1;
+
+		static double Set1(double x) { return x; }
+		static double Load(const double* p) { return *p; }
+		static void Store(double v, double* p) { *p = v; }
+		static double Floor(double v) { return std::floor(v); }
+		static double Max(double a, double b) { return a < b ? b : a; }
+		static double Min(double a, double b) { return b < a ? b : a; }
+		static double Abs(double v) { return std::fabs(v); }
+		static double Sqrt(double v) { return std::sqrt(v); }
+		static double Step(double a, double b) { return a >= b ? 1.0 : 0.0; }
+
+		using Mask = bool;
+		static bool Less(double a, double b) { return a < b; }
+		static double Select(bool m, double a, double b) { return m ? a : b; }
+	};
+
+	/*
+	* Simplex noise after Perlin (2001) in Gustavson's formulation: the plane is tiled with triangles (tetrahedra in 3D),
+	* so a sample blends three corners instead of four (four instead of eight) and needs no fade or lerp. Values are about
+	* [-1, 1]. Kernels take float or SIMD::FN lanes and give identical results either way; corner hashing is a per-lane
+	* table lookup, the rest is vector arithmetic.
+	*/
+	class Simplex
+	{
+	public:
+		Simplex() : Simplex(0u) {}
+		explicit Simplex(unsigned int seed);
+
+		template <typename V> V Noise2D(V x, V y) const { return Noise2DImpl<false, V>(x, y, nullptr, nullptr); }
+		template <typename V> V Noise3D(V x, V y, V z) const;
+
+		// With the analytic partial derivatives along x and y, the value is the same as without
+		template <typename V> V Noise2D(V x, V y, V& dx, V& dy) const { return Noise2DImpl<true>(x, y, &dx, &dy); }
+
+		// siv's octave2D_11Smooth: octave o samples (x, y) * 2^o / freq_div at amplitude 2^-o, the sum clamped to [-1, 1].
+		// The gradient overload's derivatives are zero where the sum is clamped.
+		template <typename V> V Octave2D_11Smooth(V x, V y, int octaves, float freq_div) const { return OctaveImpl<false, V>(x, y, octaves, freq_div, nullptr, nullptr); }
+		template <typename V> V Octave2D_11Smooth(V x, V y, int octaves, float freq_div, V& dx, V& dy) const { return OctaveImpl<true>(x, y, octaves, freq_div, &dx, &dy); }
+
+		// Batched over count points, SIMD::FN lanes at a time with a scalar tail
+		void Noise2D(const glm::vec2* points, float* out, size_t count) const;
+		void Octave2D_11Smooth(const glm::vec2* points, float* out, size_t count, int octaves, float freq_div) const;
+		void Octave2D_11Smooth(const glm::vec2* points, float* out, glm::vec2* gradients, size_t count, int octaves, float freq_div) const;
+
+	private:
+		template <bool GRAD, typename V> V Noise2DImpl(V x, V y, V* dx, V* dy) const;
+		template <bool GRAD, typename V> V OctaveImpl(V x, V y, int octaves, float freq_div, V* dx, V* dy) const;
+
+		// Doubled so corner offsets never wrap, gradient ids pre-reduced modulo 12
+		std::array<uint8_t, 512> m_perm;
+		std::array<uint8_t, 512> m_grad;
+	};
+
+	/*
+	* siv::BasicPerlinNoise's 2D noise (its 3D noise at SIVPERLIN_DEFAULT_Z) over float, double or SIMD::FN lanes, bit for
+	* bit with siv in the same precision: each corner's gradient is a per-lane coefficient triple in {-1, 0, 1} over
+	* (x, y, z) with two nonzero entries, which sums exactly as siv's signed selections do. Fixed octave kernels take the
+	* octave count as a template parameter. Gradient overloads differentiate the fade curves and lerps analytically.
+	*/
+	class Perlin
+	{
+	public:
+		// siv seeds the permutation the same way in either precision
+		template <typename F>
+		explicit Perlin(siv::BasicPerlinNoise<F> const& source) : m_perm(source.serialize()) {}
+
+		template <typename V> V Noise2D(V x, V y) const { return Noise2DImpl<false, V>(x, y, nullptr, nullptr); }
+		template <typename V> V Noise2D(V x, V y, V& dx, V& dy) const { return Noise2DImpl<true>(x, y, &dx, &dy); }
+
+		// siv's octave2D_11Smooth with its gradient, zero where the sum is clamped
+		template <typename V>
+		V Octave2D_11Smooth(V x, V y, int octaves, typename Lanes<V>::Scalar freq_div, V& dx, V& dy) const;
+
+		// siv's octave2D_11SmoothFixed<OCTAVES>
+		template <int OCTAVES, typename V>
+		V Octave2D_11SmoothFixed(V x, V y, float freq_div) const
+		{
+			static_assert(OCTAVES >= 1, "Octave2D_11SmoothFixed needs at least one octave");
+			return OctaveFixed(x, y, freq_div, std::make_integer_sequence<int, OCTAVES>{});
+		}
+
+		template <int OCTAVES, typename V>
+		V Octave2D_11SmoothFixed(V x, V y, float freq_div, V& dx, V& dy) const;
+
+	private:
+		template <bool GRAD, typename V> V Noise2DImpl(V x, V y, V* dx, V* dy) const;
+
+		template <typename V, int... O>
+		V OctaveFixed(V x, V y, float freq_div, std::integer_sequence<int, O...>) const;
+
+		siv::PerlinNoiseF::state_type m_perm;
+	};
+
+	// A Worley lookup in cell units: the two nearest feature distances, their cells' ids and the unit directions from
+	// each feature to the sample, which are the gradients of F1 and F2
+	template <typename V>
+	struct CellSample
+	{
+		V f1, f2;
+		V id1, id2;			// 24 bits of the cell hash, exact in float
+		V dir1x, dir1y;
+		V dir2x, dir2y;
+	};
+
+	/*
+	* Worley (cellular) noise on a hashed jittered grid: one feature point per unit cell, up to jitter / 2 from the cell
+	* centre each way, found among the 3x3 cells around the sample. Cell hashing is per lane, distances and the running
+	* F1 / F2 are vector arithmetic. As usual for a 3x3 search, a large jitter can occasionally put the true F2 outside it.
+	*/
+	class Worley
+	{
+	public:
+		explicit Worley(unsigned int seed = 0u, float jitter = 1.f) : m_seed(seed), m_jitter(jitter) {}
+
+		template <typename V> CellSample<V> Evaluate(V x, V y) const;
+
+		// Batched at frequency cells per world unit, SIMD::FN lanes at a time with a scalar tail
+		void Evaluate(const glm::vec2* points, CellSample<float>* out, size_t count, float frequency) const;
+
+	private:
+		uint32_t m_seed;
+		float m_jitter;
+	};
+
+	enum class Backend
+	{
+		PERLIN,			// siv::PerlinNoise in double precision, the reference
+		SIMPLEX,
+		PERLIN_FLOAT	// The same Perlin noise in float, up to MAX_FIXED_OCTAVES through fully unrolled SIMD kernels
+	};
+
+	// Shape of the heightfield, every landform but OCTAVES is a fixed NoiseGraph over simplex sources
+	enum class Landform
+	{
+		OCTAVES,	// The backend's octave noise alone
+		ALPINE,		// Ridged ranges rising out of rolling lowlands
+		MESAS,		// Domain-warped fBm cut into terraces
+		BADLANDS	// Billowed hills pocked with Worley basins
+	};
+
+	struct LandformGraph;
+
+	// Worley height layer added on top of the heightfield noise
+	enum class CellFeature
+	{
+		NONE,
+		PLATEAUS,	// Each cell raised flat to its own level, sloping down at the borders
+		CRATERS,	// A rimmed bowl around every feature point
+		ROCKS		// A boulder on every feature point
+	};
+
+	struct CellSettings
+	{
+		CellFeature feature{ CellFeature::NONE };
+		float size{ 2.f };		// World units per cell
+		float amount{ 0.3f };	// Layer height against the noise's [-1, 1]
+	};
+
+	// Heightfield noise in [-1, 1]. OCTAVES follows siv's octave2D_11Smooth on every backend: as in siv's Smooth variant
+	// the amplitude halves per octave, persistence is carried for the Perlin call only. Other landforms run their graph
+	// with octaves and freq_div setting the detail and the base feature size; the graph is picked once per batch.
+	class HeightNoise
+	{
+	public:
+		// Octave counts with a compile-time PERLIN_FLOAT kernel, more fall back to siv's loop
+		static constexpr int MAX_FIXED_OCTAVES = 12;
+
+		HeightNoise(Backend backend, unsigned int seed, int octaves, float persistence, float freq_div,
+					Landform landform = Landform::OCTAVES, CellSettings const& cells = CellSettings());
+
+		float Sample(double x, double y) const;
+		void Sample(const glm::vec2* points, float* out, size_t count) const;
+
+		// The same values with their partial derivatives along x and y from the same evaluation.
+		// Landform graphs have no analytic form and take central differences instead.
+		float Sample(double x, double y, glm::vec2& gradient) const;
+		void Sample(const glm::vec2* points, float* out, glm::vec2* gradients, size_t count) const;
+
+	private:
+		float SampleBase(double x, double y) const;
+		void SampleBase(const glm::vec2* points, float* out, size_t count) const;
+		float SampleBase(double x, double y, glm::vec2& gradient) const;
+		void SampleBase(const glm::vec2* points, float* out, glm::vec2* gradients, size_t count) const;
+
+		// Adds the cell layer to count samples, and its gradient when gradients is not null
+		void AddCells(const glm::vec2* points, float* out, glm::vec2* gradients, size_t count) const;
+
+		Backend m_backend;
+		int m_octaves;
+		float m_persistence;
+		float m_freq_div;
+		siv::PerlinNoise m_perlin;
+		siv::PerlinNoiseF m_perlin_f;
+		Perlin m_perlin_lanes;		// The shared permutation, for batches and gradients
+		Simplex m_simplex;
+		std::shared_ptr<const LandformGraph> m_landform;	// Null for OCTAVES
+		CellSettings m_cells;
+		Worley m_worley;
+	};
+
+	namespace detail
+	{
+		// Gustavson's 12 edge-midpoint gradients of the cube, the 2D kernel uses their x and y
+		constexpr float GRAD3[12][3] =
+		{
+			{ 1.f, 1.f, 0.f }, { -1.f, 1.f, 0.f }, { 1.f, -1.f, 0.f }, { -1.f, -1.f, 0.f },
+			{ 1.f, 0.f, 1.f }, { -1.f, 0.f, 1.f }, { 1.f, 0.f, -1.f }, { -1.f, 0.f, -1.f },
+			{ 0.f, 1.f, 1.f }, { 0.f, -1.f, 1.f }, { 0.f, 1.f, -1.f }, { 0.f, -1.f, -1.f }
+		};
+
+		constexpr float F2 = 0.366025403784f;	// (sqrt(3) - 1) / 2
+		constexpr float G2 = 0.211324865405f;	// (3 - sqrt(3)) / 6
+		constexpr float F3 = 1.f / 3.f;
+		constexpr float G3 = 1.f / 6.f;
+
+		// Bring the corner sums to about [-1, 1]
+		constexpr float SCALE2D = 70.f;
+		constexpr float SCALE3D = 76.8f;
+
+		// Corner falloff (r0 - |d|^2)^4 times the gradient ramp, zero outside the corner's radius.
+		// With GRAD its derivative t^4 g - 8 t^3 (g . d) d is added to (ddx, ddy).
+		template <bool GRAD, typename V>
+		inline V Corner2D(V dx, V dy, V gx, V gy, V* ddx, V* ddy)
+		{
+			using L = Lanes<V>;
+			const V t = L::Max(L::Set1(0.5f) - dx * dx - dy * dy, L::Set1(0.f));
+			const V t2 = t * t;
+			const V dot = gx * dx + gy * dy;
+			if constexpr (GRAD)
+			{
+				const V t4 = t2 * t2;
+				const V k = t2 * t * dot * L::Set1(8.f);
+				*ddx = *ddx + t4 * gx - k * dx;
+				*ddy = *ddy + t4 * gy - k * dy;
+			}
+			return t2 * t2 * dot;
+		}
+
+		template <typename V>
+		inline V Corner3D(V dx, V dy, V dz, V gx, V gy, V gz)
+		{
+			using L = Lanes<V>;
+			V t = L::Max(L::Set1(0.5f) - dx * dx - dy * dy - dz * dz, L::Set1(0.f));
+			t = t * t;
+			return t * t * (gx * dx + gy * dy + gz * dz);
+		}
+
+		inline int Wrap(float cell) { return static_cast<int>(cell) & 255; }
+
+		// Integer hash of a lattice cell (lowbias32 finaliser)
+		inline uint32_t CellHash(int x, int y, uint32_t seed)
+		{
+			uint32_t h = seed ^ (static_cast<uint32_t>(x) * 0x8DA6B343u) ^ (static_cast<uint32_t>(y) * 0xD8163841u);
+			h ^= h >> 16; h *= 0x7FEB352Du;
+			h ^= h >> 15; h *= 0x846CA68Bu;
+			h ^= h >> 16;
+			return h;
+		}
+
+		// siv's Grad(hash, x, y, z) as coefficients of x, y and z, indexed by hash & 15
+		constexpr float PERLIN_GRAD[16][3] =
+		{
+			{ 1.f, 1.f, 0.f }, { -1.f, 1.f, 0.f }, { 1.f, -1.f, 0.f }, { -1.f, -1.f, 0.f },
+			{ 1.f, 0.f, 1.f }, { -1.f, 0.f, 1.f }, { 1.f, 0.f, -1.f }, { -1.f, 0.f, -1.f },
+			{ 0.f, 1.f, 1.f }, { 0.f, -1.f, 1.f }, { 0.f, 1.f, -1.f }, { 0.f, -1.f, -1.f },
+			{ 1.f, 1.f, 0.f }, { 0.f, -1.f, 1.f }, { -1.f, 1.f, 0.f }, { 0.f, -1.f, -1.f }
+		};
+
+		template <typename V>
+		inline V Fade(V t)
+		{
+			using L = Lanes<V>;
+			return t * t * t * (t * (t * L::Set1(6.f) - L::Set1(15.f)) + L::Set1(10.f));
+		}
+
+		// d Fade / dt = 30 t^2 (t - 1)^2
+		template <typename V>
+		inline V FadeDerivative(V t)
+		{
+			using L = Lanes<V>;
+			const V s = t * (t - L::Set1(1.f));
+			return s * s * L::Set1(30.f);
+		}
+
+		template <typename V>
+		inline V Lerp(V a, V b, V t) { return a + (b - a) * t; }
+
+		// Zeroes the gradient where sum is clamped to [-1, 1]
+		template <typename V>
+		inline V Clamp11(V sum, V* dx, V* dy)
+		{
+			using L = Lanes<V>;
+			const V inside = L::Step(sum, L::Set1(-1.f)) * L::Step(L::Set1(1.f), sum);
+			*dx = *dx * inside;
+			*dy = *dy * inside;
+			return L::Min(L::Max(sum, L::Set1(-1.f)), L::Set1(1.f));
+		}
+	}
+
+	template <bool GRAD, typename V>
+	V Perlin::Noise2DImpl(V x, V y, V* dx, V* dy) const
+	{
+		using L = Lanes<V>;
+		using S = typename L::Scalar;
+		constexpr int W = L::WIDTH;
+
+		// The z lattice coordinate is the same for every sample
+		const S z = static_cast<S>(SIVPERLIN_DEFAULT_Z);
+		const S z_floor = std::floor(z);
+		const int iz = static_cast<int>(z_floor) & 255;
+		const S fz = z - z_floor;
+		const V w = L::Set1(siv::perlin_detail::Fade(fz));
+
+		const V x_floor = L::Floor(x);
+		const V y_floor = L::Floor(y);
+		const V fx = x - x_floor;
+		const V fy = y - y_floor;
+		const V u = detail::Fade(fx);
+		const V v = detail::Fade(fy);
+
+		S cx[W], cy[W];
+		L::Store(x_floor, cx);
+		L::Store(y_floor, cy);
+
+		// Gradient coefficients per corner in siv's p0..p7 order
+		S g[8][3][W];
+		for (int l{}; l < W; ++l)
+		{
+			const int ix = static_cast<int>(cx[l]) & 255;
+			const int iy = static_cast<int>(cy[l]) & 255;
+
+			const int A = (m_perm[ix] + iy) & 255;
+			const int B = (m_perm[(ix + 1) & 255] + iy) & 255;
+			const int AA = (m_perm[A] + iz) & 255;
+			const int AB = (m_perm[(A + 1) & 255] + iz) & 255;
+			const int BA = (m_perm[B] + iz) & 255;
+			const int BB = (m_perm[(B + 1) & 255] + iz) & 255;
+
+			const int hash[8] =
+			{
+				m_perm[AA], m_perm[BA], m_perm[AB], m_perm[BB],
+				m_perm[(AA + 1) & 255], m_perm[(BA + 1) & 255], m_perm[(AB + 1) & 255], m_perm[(BB + 1) & 255]
+			};
+			for (int c{}; c < 8; ++c)
+				for (int k{}; k < 3; ++k)
+					g[c][k][l] = static_cast<S>(detail::PERLIN_GRAD[hash[c] & 15][k]);
+		}
+
+		const V one = L::Set1(1.f);
+		const V fx1 = fx - one, fy1 = fy - one;
+		const V z0 = L::Set1(fz), z1 = L::Set1(fz - 1);
+		auto grad = [&](int c, V gx, V gy, V gz) { return L::Load(g[c][0]) * gx + L::Load(g[c][1]) * gy + L::Load(g[c][2]) * gz; };
+
+		const V p[8] =
+		{
+			grad(0, fx, fy, z0), grad(1, fx1, fy, z0), grad(2, fx, fy1, z0), grad(3, fx1, fy1, z0),
+			grad(4, fx, fy, z1), grad(5, fx1, fy, z1), grad(6, fx, fy1, z1), grad(7, fx1, fy1, z1)
+		};
+		const V q0 = detail::Lerp(p[0], p[1], u);
+		const V q1 = detail::Lerp(p[2], p[3], u);
+		const V q2 = detail::Lerp(p[4], p[5], u);
+		const V q3 = detail::Lerp(p[6], p[7], u);
+
+		if constexpr (GRAD)
+		{
+			// Each corner ramp's derivative is its coefficient, the fade curves add the slope between corner pairs
+			const V du = detail::FadeDerivative(fx);
+			const V dv = detail::FadeDerivative(fy);
+
+			V qx[4], qy[4];
+			const V qs[4] = { q0, q1, q2, q3 };
+			for (int k{}; k < 4; ++k)
+			{
+				const int a = 2 * k, b = 2 * k + 1;
+				qx[k] = detail::Lerp(L::Load(g[a][0]), L::Load(g[b][0]), u) + (p[b] - p[a]) * du;
+				qy[k] = detail::Lerp(L::Load(g[a][1]), L::Load(g[b][1]), u);
+			}
+
+			const V r0x = detail::Lerp(qx[0], qx[1], v), r1x = detail::Lerp(qx[2], qx[3], v);
+			const V r0y = detail::Lerp(qy[0], qy[1], v) + (qs[1] - qs[0]) * dv;
+			const V r1y = detail::Lerp(qy[2], qy[3], v) + (qs[3] - qs[2]) * dv;
+			*dx = detail::Lerp(r0x, r1x, w);
+			*dy = detail::Lerp(r0y, r1y, w);
+		}
+
+		return detail::Lerp(detail::Lerp(q0, q1, v), detail::Lerp(q2, q3, v), w);
+	}
+
+	template <typename V>
+	V Perlin::Octave2D_11Smooth(V x, V y, int octaves, typename Lanes<V>::Scalar freq_div, V& dx, V& dy) const
+	{
+		using L = Lanes<V>;
+		using S = typename L::Scalar;
+
+		// siv's loop, including where it divides by freq_div, so values match its octave2D_11Smooth
+		V sum = L::Set1(0.f);
+		V gx = L::Set1(0.f), gy = L::Set1(0.f);
+		S frequency = 1;
+		S amplitude = 1;
+		for (int o{}; o < octaves; ++o)
+		{
+			V nx, ny;
+			const V n = Noise2D(x * L::Set1(frequency) / L::Set1(freq_div), y * L::Set1(frequency) / L::Set1(freq_div), nx, ny);
+			sum = sum + n * L::Set1(amplitude);
+
+			const V k = L::Set1(frequency / freq_div * amplitude);
+			gx = gx + nx * k;
+			gy = gy + ny * k;
+			frequency *= 2;
+			amplitude /= 2;
+		}
+
+		dx = gx;
+		dy = gy;
+		return detail::Clamp11(sum, &dx, &dy);
+	}
+
+	template <typename V, int... O>
+	V Perlin::OctaveFixed(V x, V y, float freq_div, std::integer_sequence<int, O...>) const
+	{
+		using L = Lanes<V>;
+
+		// Same scales, amplitudes and summation order as siv's Octave2DSmoothFixed
+		const float inv_freq_div = 1.f / freq_div;
+		const float scale[] = { static_cast<float>(int64_t(1) << O) * inv_freq_div... };
+		constexpr float amplitude[] = { 1.f / static_cast<float>(int64_t(1) << O)... };
+
+		const V sum = (L::Set1(0.f) + ... + (Noise2D(x * L::Set1(scale[O]), y * L::Set1(scale[O])) * L::Set1(amplitude[O])));
+		return L::Min(L::Max(sum, L::Set1(-1.f)), L::Set1(1.f));
+	}
+
+	template <int OCTAVES, typename V>
+	V Perlin::Octave2D_11SmoothFixed(V x, V y, float freq_div, V& dx, V& dy) const
+	{
+		static_assert(OCTAVES >= 1, "Octave2D_11SmoothFixed needs at least one octave");
+		using L = Lanes<V>;
+
+		// The fold's scales and order as a loop with a constant trip count, so it unrolls the same way
+		const float inv_freq_div = 1.f / freq_div;
+		V sum = L::Set1(0.f);
+		V gx = L::Set1(0.f), gy = L::Set1(0.f);
+		for (int o{}; o < OCTAVES; ++o)
+		{
+			const float scale = static_cast<float>(int64_t(1) << o) * inv_freq_div;
+			const float amplitude = 1.f / static_cast<float>(int64_t(1) << o);
+
+			V nx, ny;
+			sum = sum + Noise2D(x * L::Set1(scale), y * L::Set1(scale), nx, ny) * L::Set1(amplitude);
+			gx = gx + nx * L::Set1(scale * amplitude);
+			gy = gy + ny * L::Set1(scale * amplitude);
+		}
+
+		dx = gx;
+		dy = gy;
+		return detail::Clamp11(sum, &dx, &dy);
+	}
+
+	template <bool GRAD, typename V>
+	V Simplex::Noise2DImpl(V x, V y, V* dx, V* dy) const
+	{
+		using L = Lanes<V>;
+		constexpr int W = L::WIDTH;
+
+		// Skew to the square grid, find the cell and which of its two triangles holds the sample
+		const V s = (x + y) * L::Set1(detail::F2);
+		const V i = L::Floor(x + s);
+		const V j = L::Floor(y + s);
+		const V t = (i + j) * L::Set1(detail::G2);
+		const V x0 = x - (i - t);
+		const V y0 = y - (j - t);
+		const V i1 = L::Step(x0, y0);
+		const V j1 = L::Set1(1.f) - i1;
+
+		const V x1 = x0 - i1 + L::Set1(detail::G2);
+		const V y1 = y0 - j1 + L::Set1(detail::G2);
+		const V x2 = x0 + L::Set1(2.f * detail::G2 - 1.f);
+		const V y2 = y0 + L::Set1(2.f * detail::G2 - 1.f);
+
+		float ci[W], cj[W], co[W];
+		L::Store(i, ci);
+		L::Store(j, cj);
+		L::Store(i1, co);
+
+		float g[6][W];
+		for (int l{}; l < W; ++l)
+		{
+			const int ii = detail::Wrap(ci[l]);
+			const int jj = detail::Wrap(cj[l]);
+			const int o = static_cast<int>(co[l]);
+
+			const float* g0 = detail::GRAD3[m_grad[ii + m_perm[jj]]];
+			const float* g1 = detail::GRAD3[m_grad[ii + o + m_perm[jj + 1 - o]]];
+			const float* g2 = detail::GRAD3[m_grad[ii + 1 + m_perm[jj + 1]]];
+			g[0][l] = g0[0]; g[1][l] = g0[1];
+			g[2][l] = g1[0]; g[3][l] = g1[1];
+			g[4][l] = g2[0]; g[5][l] = g2[1];
+		}
+
+		// Separate statements: the corners accumulate into ddx and ddy, which must happen in one order for every lane type
+		V ddx = L::Set1(0.f), ddy = L::Set1(0.f);
+		const V n0 = detail::Corner2D<GRAD>(x0, y0, L::Load(g[0]), L::Load(g[1]), &ddx, &ddy);
+		const V n1 = detail::Corner2D<GRAD>(x1, y1, L::Load(g[2]), L::Load(g[3]), &ddx, &ddy);
+		const V n2 = detail::Corner2D<GRAD>(x2, y2, L::Load(g[4]), L::Load(g[5]), &ddx, &ddy);
+		const V n = n0 + n1 + n2;
+		if constexpr (GRAD)
+		{
+			*dx = ddx * L::Set1(detail::SCALE2D);
+			*dy = ddy * L::Set1(detail::SCALE2D);
+		}
+		return n * L::Set1(detail::SCALE2D);
+	}
+
+	template <typename V>
+	V Simplex::Noise3D(V x, V y, V z) const
+	{
+		using L = Lanes<V>;
+		constexpr int W = L::WIDTH;
+
+		const V s = (x + y + z) * L::Set1(detail::F3);
+		const V i = L::Floor(x + s);
+		const V j = L::Floor(y + s);
+		const V k = L::Floor(z + s);
+		const V t = (i + j + k) * L::Set1(detail::G3);
+		const V x0 = x - (i - t);
+		const V y0 = y - (j - t);
+		const V z0 = z - (k - t);
+
+		// Rank the offsets to pick the tetrahedron: i1 steps along the largest axis, i2 along the two largest
+		const V one = L::Set1(1.f);
+		const V gx = L::Step(x0, y0), gy = L::Step(y0, z0), gz = L::Step(z0, x0);
+		const V lx = one - gx, ly = one - gy, lz = one - gz;
+		const V i1 = L::Min(gx, lz), j1 = L::Min(gy, lx), k1 = L::Min(gz, ly);
+		const V i2 = L::Max(gx, lz), j2 = L::Max(gy, lx), k2 = L::Max(gz, ly);
+
+		const V g3 = L::Set1(detail::G3);
+		const V x1 = x0 - i1 + g3, y1 = y0 - j1 + g3, z1 = z0 - k1 + g3;
+		const V x2 = x0 - i2 + g3 + g3, y2 = y0 - j2 + g3 + g3, z2 = z0 - k2 + g3 + g3;
+		const V last = L::Set1(3.f * detail::G3 - 1.f);
+		const V x3 = x0 + last, y3 = y0 + last, z3 = z0 + last;
+
+		float ci[W], cj[W], ck[W], o1[3][W], o2[3][W];
+		L::Store(i, ci); L::Store(j, cj); L::Store(k, ck);
+		L::Store(i1, o1[0]); L::Store(j1, o1[1]); L::Store(k1, o1[2]);
+		L::Store(i2, o2[0]); L::Store(j2, o2[1]); L::Store(k2, o2[2]);
+
+		float g[12][W];
+		for (int l{}; l < W; ++l)
+		{
+			const int ii = detail::Wrap(ci[l]);
+			const int jj = detail::Wrap(cj[l]);
+			const int kk = detail::Wrap(ck[l]);
+			const int a[3] = { static_cast<int>(o1[0][l]), static_cast<int>(o1[1][l]), static_cast<int>(o1[2][l]) };
+			const int b[3] = { static_cast<int>(o2[0][l]), static_cast<int>(o2[1][l]), static_cast<int>(o2[2][l]) };
+
+			const float* c[4] =
+			{
+				detail::GRAD3[m_grad[ii + m_perm[jj + m_perm[kk]]]],
+				detail::GRAD3[m_grad[ii + a[0] + m_perm[jj + a[1] + m_perm[kk + a[2]]]]],
+				detail::GRAD3[m_grad[ii + b[0] + m_perm[jj + b[1] + m_perm[kk + b[2]]]]],
+				detail::GRAD3[m_grad[ii + 1 + m_perm[jj + 1 + m_perm[kk + 1]]]]
+			};
+			for (int n{}; n < 4; ++n)
+			{
+				g[n * 3][l] = c[n][0];
+				g[n * 3 + 1][l] = c[n][1];
+				g[n * 3 + 2][l] = c[n][2];
+			}
+		}
+
+		const V n = detail::Corner3D(x0, y0, z0, L::Load(g[0]), L::Load(g[1]), L::Load(g[2]))
+				  + detail::Corner3D(x1, y1, z1, L::Load(g[3]), L::Load(g[4]), L::Load(g[5]))
+				  + detail::Corner3D(x2, y2, z2, L::Load(g[6]), L::Load(g[7]), L::Load(g[8]))
+				  + detail::Corner3D(x3, y3, z3, L::Load(g[9]), L::Load(g[10]), L::Load(g[11]));
+		return n * L::Set1(detail::SCALE3D);
+	}
+
+	template <bool GRAD, typename V>
+	V Simplex::OctaveImpl(V x, V y, int octaves, float freq_div, V* dx, V* dy) const
+	{
+		using L = Lanes<V>;
+
+		V sum = L::Set1(0.f);
+		V gx = L::Set1(0.f), gy = L::Set1(0.f);
+		float frequency = 1.f;
+		float amplitude = 1.f;
+		for (int o{}; o < octaves; ++o)
+		{
+			const V scale = L::Set1(frequency / freq_div);
+			V nx, ny;
+			sum = sum + Noise2DImpl<GRAD>(x * scale, y * scale, &nx, &ny) * L::Set1(amplitude);
+			if constexpr (GRAD)
+			{
+				// Chain rule through the octave's scale
+				const V k = scale * L::Set1(amplitude);
+				gx = gx + nx * k;
+				gy = gy + ny * k;
+			}
+			frequency *= 2.f;
+			amplitude *= 0.5f;
+		}
+
+		if constexpr (GRAD)
+		{
+			*dx = gx;
+			*dy = gy;
+			return detail::Clamp11(sum, dx, dy);
+		}
+		return L::Min(L::Max(sum, L::Set1(-1.f)), L::Set1(1.f));
+	}
+
+	template <typename V>
+	CellSample<V> Worley::Evaluate(V x, V y) const
+	{
+		using L = Lanes<V>;
+		constexpr int W = L::WIDTH;
+
+		const V cx = L::Floor(x), cy = L::Floor(y);
+		const V rx = x - cx, ry = y - cy;
+
+		float ci[W], cj[W];
+		L::Store(cx, ci);
+		L::Store(cy, cj);
+
+		const V far = L::Set1(8.f);
+		const V zero = L::Set1(0.f);
+		V d1 = far, d2 = far;
+		V id1 = zero, id2 = zero;
+		V o1x = zero, o1y = zero, o2x = zero, o2y = zero;
+		for (int dy = -1; dy <= 1; ++dy)
+			for (int dx = -1; dx <= 1; ++dx)
+			{
+				float jx[W], jy[W], id[W];
+				for (int l{}; l < W; ++l)
+				{
+					const uint32_t h = detail::CellHash(static_cast<int>(ci[l]) + dx, static_cast<int>(cj[l]) + dy, m_seed);
+					jx[l] = static_cast<float>(h & 0xFFFFu) * (1.f / 65536.f);
+					jy[l] = static_cast<float>(h >> 16) * (1.f / 65536.f);
+					id[l] = static_cast<float>((h * 0x9E3779B1u) >> 8);
+				}
+
+				// Sample relative to the feature point
+				const V px = rx - (L::Set1(dx + 0.5f) + (L::Load(jx) - L::Set1(0.5f)) * L::Set1(m_jitter));
+				const V py = ry - (L::Set1(dy + 0.5f) + (L::Load(jy) - L::Set1(0.5f)) * L::Set1(m_jitter));
+				const V d = px * px + py * py;
+				const V cell = L::Load(id);
+
+				// A new nearest pushes the old one to second, otherwise it may still beat the second
+				const auto nearest = L::Less(d, d1);
+				const auto second = L::Less(d, d2);
+				d2 = L::Select(nearest, d1, L::Select(second, d, d2));
+				id2 = L::Select(nearest, id1, L::Select(second, cell, id2));
+				o2x = L::Select(nearest, o1x, L::Select(second, px, o2x));
+				o2y = L::Select(nearest, o1y, L::Select(second, py, o2y));
+				d1 = L::Select(nearest, d, d1);
+				id1 = L::Select(nearest, cell, id1);
+				o1x = L::Select(nearest, px, o1x);
+				o1y = L::Select(nearest, py, o1y);
+			}
+
+		CellSample<V> s;
+		const V tiny = L::Set1(1e-12f);
+		s.f1 = L::Sqrt(L::Max(d1, tiny));
+		s.f2 = L::Sqrt(L::Max(d2, tiny));
+		s.id1 = id1;
+		s.id2 = id2;
+		const V inv1 = L::Set1(1.f) / s.f1, inv2 = L::Set1(1.f) / s.f2;
+		s.dir1x = o1x * inv1;
+		s.dir1y = o1y * inv1;
+		s.dir2x = o2x * inv2;
+		s.dir2y = o2y * inv2;
+		return s;
+	}
+}
+
+#endif // !NOISE_H
@@ -0,0 +1,364 @@
+#ifndef NOISE_GRAPH_H
+#define NOISE_GRAPH_H
+
+#include "Noise.h"
+
+/*
+* Composable noise graphs. Every node is a small value type with a templated Eval(x, y) over float or SIMD::FN lanes and
+* combinators hold their inputs by value, so a graph is one nested type whose Eval inlines into a single per-sample
+* kernel: no virtual calls, no intermediate buffers. Build graphs with the factory functions at the bottom and run them
+* over points with Evaluate. Inputs are world coordinates, sources apply their own frequency; nodes return about [-1, 1].
+*/
+namespace NOISE
+{
+	namespace GRAPH
+	{
+		namespace detail
+		{
+			template <typename V>
+			inline V Clamp01(V v)
+			{
+				using L = Lanes<V>;
+				return L::Min(L::Max(v, L::Set1(0.f)), L::Set1(1.f));
+			}
+
+			template <typename V>
+			inline V SmoothStep(V t)
+			{
+				using L = Lanes<V>;
+				return t * t * (L::Set1(3.f) - t * L::Set1(2.f));
+			}
+		}
+
+		struct ConstantNode
+		{
+			float value{};
+
+			template <typename V> V Eval(V, V) const { return Lanes<V>::Set1(value); }
+		};
+
+		// Single octave of simplex noise
+		struct SimplexNode
+		{
+			Simplex noise;
+			float frequency{ 1.f };
+
+			template <typename V>
+			V Eval(V x, V y) const
+			{
+				const V f = Lanes<V>::Set1(frequency);
+				return noise.Noise2D(x * f, y * f);
+			}
+		};
+
+		enum class CellOutput
+		{
+			F1,		// Distance to the nearest feature point: -1 on it, 1 a cell's width or more away
+			F2,		// The same for the second nearest
+			EDGE,	// F2 - F1: -1 on the border between two cells
+			CELL	// The nearest cell's id spread over [-1, 1], flat across each cell
+		};
+
+		// Worley noise at frequency cells per world unit
+		template <CellOutput OUTPUT>
+		struct WorleyNode
+		{
+			Worley cells;
+			float frequency{ 1.f };
+
+			template <typename V>
+			V Eval(V x, V y) const
+			{
+				using L = Lanes<V>;
+
+				const CellSample<V> s = cells.Evaluate(x * L::Set1(frequency), y * L::Set1(frequency));
+				if constexpr (OUTPUT == CellOutput::CELL)
+					return s.id1 * L::Set1(2.f / 16777216.f) - L::Set1(1.f);
+
+				V d;
+				if constexpr (OUTPUT == CellOutput::F1)
+					d = s.f1;
+				else if constexpr (OUTPUT == CellOutput::F2)
+					d = s.f2;
+				else
+					d = s.f2 - s.f1;
+				return L::Min(d, L::Set1(1.f)) * L::Set1(2.f) - L::Set1(1.f);
+			}
+		};
+
+		// Fractal sum of the source over octaves, each lacunarity times the frequency and gain times the amplitude of the last
+		template <typename S>
+		struct FBmNode
+		{
+			S source;
+			int octaves{ 4 };
+			float lacunarity{ 2.f };
+			float gain{ 0.5f };
+
+			template <typename V>
+			V Eval(V x, V y) const
+			{
+				using L = Lanes<V>;
+
+				V sum = L::Set1(0.f);
+				float frequency = 1.f, amplitude = 1.f, total{};
+				for (int o{}; o < octaves; ++o)
+				{
+					const V f = L::Set1(frequency);
+					sum = sum + source.Eval(x * f, y * f) * L::Set1(amplitude);
+					total += amplitude;
+					frequency *= lacunarity;
+					amplitude *= gain;
+				}
+				return sum * L::Set1(total > 0.f ? 1.f / total : 0.f);
+			}
+		};
+
+		// Musgrave's ridged multifractal: octaves of (offset - |n|)^2, each weighted by the previous one times weight_gain
+		// so detail gathers on the ridges and the valleys stay smooth
+		template <typename S>
+		struct RidgedNode
+		{
+			S source;
+			int octaves{ 4 };
+			float lacunarity{ 2.f };
+			float gain{ 0.5f };
+			float offset{ 1.f };
+			float weight_gain{ 2.f };
+
+			template <typename V>
+			V Eval(V x, V y) const
+			{
+				using L = Lanes<V>;
+
+				V sum = L::Set1(0.f);
+				V weight = L::Set1(1.f);
+				float frequency = 1.f, amplitude = 1.f, total{};
+				for (int o{}; o < octaves; ++o)
+				{
+					const V f = L::Set1(frequency);
+					V signal = L::Set1(offset) - L::Abs(source.Eval(x * f, y * f));
+					signal = signal * signal * weight;
+					weight = detail::Clamp01(signal * L::Set1(weight_gain));
+					sum = sum + signal * L::Set1(amplitude);
+					total += amplitude * offset * offset;
+					frequency *= lacunarity;
+					amplitude *= gain;
+				}
+				return sum * L::Set1(total > 0.f ? 2.f / total : 0.f) - L::Set1(1.f);
+			}
+		};
+
+		// fBm of 2|n| - 1: rounded hills meeting in creases
+		template <typename S>
+		struct BillowNode
+		{
+			S source;
+			int octaves{ 4 };
+			float lacunarity{ 2.f };
+			float gain{ 0.5f };
+
+			template <typename V>
+			V Eval(V x, V y) const
+			{
+				using L = Lanes<V>;
+
+				V sum = L::Set1(0.f);
+				float frequency = 1.f, amplitude = 1.f, total{};
+				for (int o{}; o < octaves; ++o)
+				{
+					const V f = L::Set1(frequency);
+					const V n = L::Abs(source.Eval(x * f, y * f)) * L::Set1(2.f) - L::Set1(1.f);
+					sum = sum + n * L::Set1(amplitude);
+					total += amplitude;
+					frequency *= lacunarity;
+					amplitude *= gain;
+				}
+				return sum * L::Set1(total > 0.f ? 1.f / total : 0.f);
+			}
+		};
+
+		// Samples the source at (x, y) displaced by amount world units times the two warp fields
+		template <typename S, typename WX, typename WY>
+		struct WarpNode
+		{
+			S source;
+			WX warp_x;
+			WY warp_y;
+			float amount{ 1.f };
+
+			template <typename V>
+			V Eval(V x, V y) const
+			{
+				const V a = Lanes<V>::Set1(amount);
+				return source.Eval(x + warp_x.Eval(x, y) * a, y + warp_y.Eval(x, y) * a);
+			}
+		};
+
+		// Piecewise-linear remap through control points sorted by x, flat beyond the first and last.
+		// Each segment adds its rise times how far the value is across it, so there is no per-lane search.
+		template <typename S, size_t N>
+		struct CurveNode
+		{
+			static_assert(N >= 2, "A curve needs at least two control points");
+
+			S source;
+			std::array<glm::vec2, N> points;
+
+			template <typename V>
+			V Eval(V x, V y) const
+			{
+				using L = Lanes<V>;
+
+				const V v = source.Eval(x, y);
+				V out = L::Set1(points[0].y);
+				for (size_t k{}; k + 1 < N; ++k)
+				{
+					const float width = points[k + 1].x - points[k].x;
+					const V t = width > 0.f ? detail::Clamp01((v - L::Set1(points[k].x)) * L::Set1(1.f / width))
+											: L::Step(v, L::Set1(points[k].x));
+					out = out + t * L::Set1(points[k + 1].y - points[k].y);
+				}
+				return out;
+			}
+		};
+
+		template <typename A, typename B>
+		struct AddNode
+		{
+			A a;
+			B b;
+
+			template <typename V> V Eval(V x, V y) const { return a.Eval(x, y) + b.Eval(x, y); }
+		};
+
+		template <typename A, typename B>
+		struct MulNode
+		{
+			A a;
+			B b;
+
+			template <typename V> V Eval(V x, V y) const { return a.Eval(x, y) * b.Eval(x, y); }
+		};
+
+		template <typename S>
+		struct ScaleBiasNode
+		{
+			S source;
+			float scale{ 1.f };
+			float bias{};
+
+			template <typename V> V Eval(V x, V y) const { return source.Eval(x, y) * Lanes<V>::Set1(scale) + Lanes<V>::Set1(bias); }
+		};
+
+		// a where control is below threshold, b above, blended smoothly over threshold +- falloff.
+		// Lanes disagree on the branch, so both inputs are always evaluated.
+		template <typename C, typename A, typename B>
+		struct SelectNode
+		{
+			C control;
+			A a;
+			B b;
+			float threshold{};
+			float falloff{};
+
+			template <typename V>
+			V Eval(V x, V y) const
+			{
+				using L = Lanes<V>;
+
+				const V c = control.Eval(x, y);
+				const V t = falloff > 0.f
+					? detail::SmoothStep(detail::Clamp01((c - L::Set1(threshold - falloff)) * L::Set1(0.5f / falloff)))
+					: L::Step(c, L::Set1(threshold));
+				const V va = a.Eval(x, y);
+				return va + (b.Eval(x, y) - va) * t;
+			}
+		};
+
+		// Quantises [-1, 1] into steps flat terraces; the last ramp share of each step climbs smoothly to the next
+		template <typename S>
+		struct TerraceNode
+		{
+			S source;
+			int steps{ 4 };
+			float ramp{ 0.25f };
+
+			template <typename V>
+			V Eval(V x, V y) const
+			{
+				using L = Lanes<V>;
+
+				const float n = static_cast<float>(steps);
+				const V u = (source.Eval(x, y) + L::Set1(1.f)) * L::Set1(0.5f * n);
+				const V level = L::Floor(u);
+				const V t = detail::SmoothStep(detail::Clamp01((u - level - L::Set1(1.f - ramp)) * L::Set1(1.f / ramp)));
+				return (level + t) * L::Set1(2.f / n) - L::Set1(1.f);
+			}
+		};
+
+		inline ConstantNode Constant(float value) { return { value }; }
+		inline SimplexNode Simplex2D(unsigned int seed, float frequency) { return { Simplex(seed), frequency }; }
+
+		template <CellOutput OUTPUT = CellOutput::F1>
+		WorleyNode<OUTPUT> Worley2D(unsigned int seed, float frequency, float jitter = 1.f) { return { Worley(seed, jitter), frequency }; }
+
+		template <typename S>
+		FBmNode<S> FBm(S source, int octaves, float lacunarity = 2.f, float gain = 0.5f) { return { source, octaves, lacunarity, gain }; }
+
+		template <typename S>
+		RidgedNode<S> Ridged(S source, int octaves, float lacunarity = 2.f, float gain = 0.5f, float offset = 1.f, float weight_gain = 2.f)
+		{
+			return { source, octaves, lacunarity, gain, offset, weight_gain };
+		}
+
+		template <typename S>
+		BillowNode<S> Billow(S source, int octaves, float lacunarity = 2.f, float gain = 0.5f) { return { source, octaves, lacunarity, gain }; }
+
+		template <typename S, typename WX, typename WY>
+		WarpNode<S, WX, WY> Warp(S source, WX warp_x, WY warp_y, float amount) { return { source, warp_x, warp_y, amount }; }
+
+		template <typename S, size_t N>
+		CurveNode<S, N> Curve(S source, std::array<glm::vec2, N> const& points) { return { source, points }; }
+
+		template <typename A, typename B>
+		AddNode<A, B> Add(A a, B b) { return { a, b }; }
+
+		template <typename A, typename B>
+		MulNode<A, B> Mul(A a, B b) { return { a, b }; }
+
+		template <typename S>
+		ScaleBiasNode<S> ScaleBias(S source, float scale, float bias) { return { source, scale, bias }; }
+
+		template <typename C, typename A, typename B>
+		SelectNode<C, A, B> Select(C control, A a, B b, float threshold, float falloff) { return { control, a, b, threshold, falloff }; }
+
+		template <typename S>
+		TerraceNode<S> Terrace(S source, int steps, float ramp = 0.25f) { return { source, steps, ramp > 1e-3f ? ramp : 1e-3f }; }
+
+		// Runs the graph over count points, SIMD::FN lanes at a time with a scalar tail
+		template <typename Node>
+		void Evaluate(Node const& node, const glm::vec2* points, float* out, size_t count)
+		{
+			using FN = SIMD::FN;
+			constexpr int W = FN::WIDTH;
+
+			size_t i{};
+			for (; i + W <= count; i += W)
+			{
+				float xs[W], ys[W];
+				for (int l{}; l < W; ++l)
+				{
+					xs[l] = points[i + l].x;
+					ys[l] = points[i + l].y;
+				}
+				node.Eval(FN::Load(xs), FN::Load(ys)).Store(out + i);
+			}
+
+			for (; i < count; ++i)
+				out[i] = node.Eval(points[i].x, points[i].y);
+		}
+	}
+}
+
+#endif // !NOISE_GRAPH_H
@@ -19,14 +19,20 @@ namespace OGLWRAPPER
 	void PopulateEBO(unsigned int ebo_id, std::vector<unsigned int> const& buffer);
 
 	template <typename T>
-	void PopulateBuffer(unsigned int id, std::vector<T> const& buffer, size_t size, unsigned int val_type, unsigned int attrib_ptr, unsigned int cnt)
+	void PopulateBuffer(unsigned int id, T const* data, size_t count, size_t size, unsigned int val_type, unsigned int attrib_ptr, unsigned int cnt)
 	{
 		GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, id));
-		GL_CALL(glBufferData(GL_ARRAY_BUFFER, size * buffer.size(), &buffer[0], GL_STATIC_DRAW));
+		GL_CALL(glBufferData(GL_ARRAY_BUFFER, size * count, data, GL_STATIC_DRAW));
 		GL_CALL(glEnableVertexAttribArray(attrib_ptr));
 		GL_CALL(glVertexAttribPointer(attrib_ptr, cnt, val_type, GL_FALSE, 0, 0));
 	}
 
+	template <typename T>
+	void PopulateBuffer(unsigned int id, std::vector<T> const& buffer, size_t size, unsigned int val_type, unsigned int attrib_ptr, unsigned int cnt)
+	{
+		PopulateBuffer(id, buffer.data(), buffer.size(), size, val_type, attrib_ptr, cnt);
+	}
+
 	template <typename T>
 	unsigned int CreateDynamicBuffer(unsigned int buffer_cnt, unsigned int val_type, unsigned int attrib_ptr, unsigned int cnt)
 	{
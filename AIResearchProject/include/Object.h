@@ -4,6 +4,7 @@
 #include "Primitives.h"
 #include "MeshLoader.h"
 #include "Camera.h"
+#include "BoundingVolumes.h"
 
 class Object
 {
@@ -57,7 +58,6 @@ public:
 	void CalculateBoundingSphere(METHOD method);
 	void CalculateAABB();
 	void Transform();
-	glm::mat3 PCA(std::vector<glm::vec3> const& points, glm::vec3& mean, glm::mat3& eigenvectors, glm::vec3& eigenvalues);
 
 private:
 	// Attributes
@@ -87,14 +87,8 @@ private:
 	void CalculateLarsons();
 	void CalculateRitters();
 
-	std::vector<glm::vec3> GetVertices();
-
-	// PCA
-	glm::vec3 ComputeMean(std::vector<glm::vec3> const& points);
-	glm::mat3 ComputeCovarianceMatrix(std::vector<glm::vec3> const& points, glm::vec3 const& mean);
-	void Jacobi(glm::mat3& matrix, glm::mat3& v);
-	void SymSchur2(glm::mat3 const& a, int p, int q, float& c, float& s);
-	void FindExtremalPoints(glm::vec3 dir, std::vector<glm::vec3> const& pts, int* imin, int* imax);
+	// Model-space vertices of the mesh, bounding volumes apply m_transform on the fly
+	BOUNDS::Points GetPoints() const;
 };
 
 #endif // !OBJECT_H
@@ -28,6 +28,7 @@
 # pragma once
 # include <cstdint>
 # include <algorithm>
+# include <utility>
 # include <array>
 # include <iterator>
 # include <numeric>
@@ -195,6 +196,12 @@ namespace siv
 		value_type octave2D_11(value_type x, value_type y, std::int32_t octaves, value_type persistence = value_type(0.5)) const noexcept;
 		value_type octave2D_11Smooth(value_type x, value_type y, std::int32_t octaves, value_type persistence = value_type(0.5), value_type freq_div = value_type(10)) const noexcept;
 
+		// octave2D_11Smooth with the octave count fixed at compile time so the loop unrolls, the per-octave scales
+		// 2^i / freq_div computed once per call. Rounds differently from the runtime version, which stays the reference.
+		template <std::int32_t Octaves>
+		[[nodiscard]]
+		value_type octave2D_11SmoothFixed(value_type x, value_type y, value_type freq_div = value_type(10)) const noexcept;
+
 		[[nodiscard]]
 		value_type octave3D_11(value_type x, value_type y, value_type z, std::int32_t octaves, value_type persistence = value_type(0.5)) const noexcept;
 
@@ -247,6 +254,7 @@ namespace siv
 	};
 
 	using PerlinNoise = BasicPerlinNoise<double>;
+	using PerlinNoiseF = BasicPerlinNoise<float>;
 
 	namespace perlin_detail
 	{
@@ -392,6 +400,18 @@ namespace siv
 		}
 
 
+		template <class Noise, class Float, std::int32_t... Octave>
+		[[nodiscard]]
+		inline Float Octave2DSmoothFixed(const Noise& noise, const Float x, const Float y, const Float freq_div, std::integer_sequence<std::int32_t, Octave...>) noexcept
+		{
+			const Float inv_freq_div = Float(1) / freq_div;
+			const Float scale[] = { Float(std::int64_t(1) << Octave) * inv_freq_div... };
+			constexpr Float amplitude[] = { Float(1) / Float(std::int64_t(1) << Octave)... };
+
+			// Left fold, so octaves accumulate in the same order as the loop
+			return (Float(0) + ... + (noise.noise2D(x * scale[Octave], y * scale[Octave]) * amplitude[Octave]));
+		}
+
 		template <class Noise, class Float>
 		[[nodiscard]]
 		inline auto Octave3D(const Noise& noise, Float x, Float y, Float z, const std::int32_t octaves, const Float persistence) noexcept
@@ -626,6 +646,14 @@ namespace siv
 		return perlin_detail::Clamp_11(octave2DSmooth(x, y, octaves, persistence, freq_div));
 	}
 
+	template <class Float>
+	template <std::int32_t Octaves>
+	inline typename BasicPerlinNoise<Float>::value_type BasicPerlinNoise<Float>::octave2D_11SmoothFixed(const value_type x, const value_type y, const value_type freq_div) const noexcept
+	{
+		static_assert(Octaves >= 1, "octave2D_11SmoothFixed needs at least one octave");
+		return perlin_detail::Clamp_11(perlin_detail::Octave2DSmoothFixed(*this, x, y, freq_div, std::make_integer_sequence<std::int32_t, Octaves>{}));
+	}
+
 	template <class Float>
 	inline typename BasicPerlinNoise<Float>::value_type BasicPerlinNoise<Float>::octave3D_11(const value_type x, const value_type y, const value_type z, const std::int32_t octaves, const value_type persistence) const noexcept
 	{
@@ -3,6 +3,7 @@
 
 #include <stdint.h>
 #include <vector>
+#include <memory_resource>
 
 #include "includes.h"
 #include "Utils.h"
@@ -32,7 +33,7 @@ namespace Poisson
 
 	struct Grid
 	{
-		Grid(int w, int h, float cellSize);
+		Grid(int w, int h, float cellSize, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 		void insert(const glm::vec2& p);
 		bool IsInNeighbourhood(const glm::vec2& point, float minDist, float cellSize);
 
@@ -40,10 +41,10 @@ namespace Poisson
 		int w_;
 		int h_;
 		float cellSize_;
-		std::vector<std::vector<glm::vec2>> grid_;
+		std::pmr::vector<glm::vec2> grid_;	// Column-major, w_ x h_
 	};
 
-	glm::vec2 PopRandom(std::vector<glm::vec2>& points, DefaultPRNG& rng);
+	glm::vec2 PopRandom(std::pmr::vector<glm::vec2>& points, DefaultPRNG& rng);
 
 	glm::vec2 GenerateRandomPointAround(const glm::vec2& p, float minDist, DefaultPRNG& rng);
 
@@ -51,10 +52,34 @@ namespace Poisson
 	bool InRectangle(glm::vec2 point);
 	GridPoint ImageToGrid(const glm::vec2& P, float cellSize);
 
-	std::vector<glm::vec2> GeneratePoissonPoints(uint32_t numPoints,
-												 unsigned int rng,
-												 uint32_t newPointsCount = 30,
-												 float minDist = -1.f);
+	// The points and all working memory come from resource
+	std::pmr::vector<glm::vec2> GeneratePoissonPoints(uint32_t numPoints,
+													  unsigned int rng,
+													  uint32_t newPointsCount = 30,
+													  float minDist = -1.f,
+													  std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+	// Replaces the points within spacing / 2 of the unit square's border by evenly spaced border points, corners included,
+	// so the convex hull is the square itself
+	void AddBoundaryPoints(std::pmr::vector<glm::vec2>& points, float spacing);
+
+	// Spacing over the unit square, stored on a resolution x resolution raster (row per y) and sampled bilinearly
+	struct RadiusField
+	{
+		int resolution{};
+		std::pmr::vector<float> radii;
+		float min_radius{};
+		float max_radius{};
+
+		float Sample(const glm::vec2& p) const;
+	};
+
+	// Variable-radius Bridson sampling: two points p, q are kept at least (r(p) + r(q)) / 2 apart,
+	// so small radii concentrate points and large ones thin them out
+	std::pmr::vector<glm::vec2> GenerateAdaptivePoissonPoints(const RadiusField& field,
+															  unsigned int rng,
+															  uint32_t newPointsCount = 30,
+															  std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 } // namespace PoissonGenerator
 
 #endif // !POISSON_H
\ No newline at end of file
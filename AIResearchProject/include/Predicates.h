@@ -0,0 +1,64 @@
+#ifndef PREDICATES_H
+#define PREDICATES_H
+
+#include <cmath>
+#include <limits>
+
+/*
+* Robust orientation and in-circle tests after Shewchuk's adaptive predicates.
+* The determinant is first evaluated in plain doubles and returned when it clears a forward error bound;
+* only near-degenerate inputs fall through to the exact expansion arithmetic in Predicates.cpp.
+* Only the sign of the result is meaningful on the exact path.
+*/
+namespace PREDICATES
+{
+	constexpr double EPS = std::numeric_limits<double>::epsilon() * 0.5;
+	constexpr double CCW_ERRBOUND = (3.0 + 16.0 * EPS) * EPS;
+	constexpr double ICC_ERRBOUND = (10.0 + 96.0 * EPS) * EPS;
+
+	double Orient2DExact(double ax, double ay, double bx, double by, double cx, double cy);
+	double InCircleExact(double ax, double ay, double bx, double by, double cx, double cy, double dx, double dy);
+
+	// Positive when a, b, c wind counter-clockwise, negative when clockwise, zero when collinear
+	inline double Orient2D(double ax, double ay, double bx, double by, double cx, double cy)
+	{
+		double detleft = (ax - cx) * (by - cy);
+		double detright = (ay - cy) * (bx - cx);
+		double det = detleft - detright;
+
+		double errbound = CCW_ERRBOUND * (std::fabs(detleft) + std::fabs(detright));
+		if (det > errbound || -det > errbound)
+			return det;
+
+		return Orient2DExact(ax, ay, bx, by, cx, cy);
+	}
+
+	// Positive when d lies inside the circle through counter-clockwise a, b, c, negative outside, zero when cocircular
+	inline double InCircle(double ax, double ay, double bx, double by, double cx, double cy, double dx, double dy)
+	{
+		double adx = ax - dx, ady = ay - dy;
+		double bdx = bx - dx, bdy = by - dy;
+		double cdx = cx - dx, cdy = cy - dy;
+
+		double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+		double cdxady = cdx * ady, adxcdy = adx * cdy;
+		double adxbdy = adx * bdy, bdxady = bdx * ady;
+
+		double alift = adx * adx + ady * ady;
+		double blift = bdx * bdx + bdy * bdy;
+		double clift = cdx * cdx + cdy * cdy;
+
+		double det = alift * (bdxcdy - cdxbdy) + blift * (cdxady - adxcdy) + clift * (adxbdy - bdxady);
+
+		double permanent = (std::fabs(bdxcdy) + std::fabs(cdxbdy)) * alift
+						 + (std::fabs(cdxady) + std::fabs(adxcdy)) * blift
+						 + (std::fabs(adxbdy) + std::fabs(bdxady)) * clift;
+		double errbound = ICC_ERRBOUND * permanent;
+		if (det > errbound || -det > errbound)
+			return det;
+
+		return InCircleExact(ax, ay, bx, by, cx, cy, dx, dy);
+	}
+}
+
+#endif // !PREDICATES_H
@@ -3,6 +3,7 @@
 
 #include <glm/glm.hpp>
 #include "includes.h"
+#include "HalfEdgeMesh.h"
 
 #define COPLANAR 0
 #define INSIDE 1
@@ -144,7 +145,8 @@ namespace TESTS
 	bool EqualEpsilon(float x, float y, int ulp = 2);
 	bool EqualEpsilon(glm::vec2 const& a, glm::vec2 const& b);
 
-	std::vector<Triangle2D> Triangulate(std::vector<glm::vec2>& points);
+	// Delaunay triangulation with connectivity, see HalfEdgeMesh
+	HalfEdgeMesh Triangulate(std::vector<glm::vec2> const& points);
 }
 
 #endif // !PRIMITIVES_H
@@ -24,7 +24,8 @@ public:
 	BVHBotUp&				GetBVHBotUp()			{ return m_BVH_botup; }
 
 	Terrain terrain;
-	void GenerateTerrain(unsigned int seed, unsigned int no_pts, glm::vec3 map_scale, unsigned int perlin_oct, float perlin_persistance, float perlin_freq);
+	void GenerateTerrain(TerrainSettings const& settings);
+	void ErodeTerrain(EROSION::ThermalSettings const& thermal);
 
 private:
 	void RenderScene(Camera& camera, bool thicken = false);
@@ -0,0 +1,157 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <cstdint>
+#include <cmath>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMD_SSE2
+#include <immintrin.h>
+#endif
+
+#if defined(SIMD_SSE2) && defined(__AVX__)
+#define SIMD_AVX
+#endif
+
+/*
+* Thin lane wrappers so kernels can be written once and instantiated 4-wide (SSE2, always on x64)
+* or 8-wide (AVX, when the project is compiled with /arch:AVX or higher).
+* Comparisons return lane masks; Select/Mask consume them.
+*/
+namespace SIMD
+{
+	struct F4
+	{
+		static constexpr int WIDTH = 4;
+
+#ifdef SIMD_SSE2
+		__m128 v;
+
+		static F4 Set1(float x) { return { _mm_set1_ps(x) }; }
+		static F4 Zero() { return { _mm_setzero_ps() }; }
+		static F4 Load(const float* p) { return { _mm_loadu_ps(p) }; }
+		void Store(float* p) const { _mm_storeu_ps(p, v); }
+#else
+		float v[4];
+
+		static F4 Set1(float x) { return { { x, x, x, x } }; }
+		static F4 Zero() { return Set1(0.f); }
+		static F4 Load(const float* p) { return { { p[0], p[1], p[2], p[3] } }; }
+		void Store(float* p) const { for (int i{}; i < 4; ++i) p[i] = v[i]; }
+#endif
+	};
+
+#ifdef SIMD_SSE2
+	inline F4 operator+(F4 a, F4 b) { return { _mm_add_ps(a.v, b.v) }; }
+	inline F4 operator-(F4 a, F4 b) { return { _mm_sub_ps(a.v, b.v) }; }
+	inline F4 operator*(F4 a, F4 b) { return { _mm_mul_ps(a.v, b.v) }; }
+	inline F4 operator/(F4 a, F4 b) { return { _mm_div_ps(a.v, b.v) }; }
+	inline F4 Min(F4 a, F4 b) { return { _mm_min_ps(a.v, b.v) }; }
+	inline F4 Max(F4 a, F4 b) { return { _mm_max_ps(a.v, b.v) }; }
+	inline F4 Sqrt(F4 a) { return { _mm_sqrt_ps(a.v) }; }
+	inline F4 Abs(F4 a) { return { _mm_andnot_ps(_mm_set1_ps(-0.f), a.v) }; }
+	inline F4 Floor(F4 a)
+	{
+#if defined(__SSE4_1__) || defined(SIMD_AVX)
+		return { _mm_floor_ps(a.v) };
+#else
+		__m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(a.v));
+		return { _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, a.v), _mm_set1_ps(1.f))) };
+#endif
+	}
+
+	inline F4 operator<(F4 a, F4 b) { return { _mm_cmplt_ps(a.v, b.v) }; }
+	inline F4 operator<=(F4 a, F4 b) { return { _mm_cmple_ps(a.v, b.v) }; }
+	inline F4 operator>(F4 a, F4 b) { return { _mm_cmpgt_ps(a.v, b.v) }; }
+	inline F4 operator>=(F4 a, F4 b) { return { _mm_cmpge_ps(a.v, b.v) }; }
+	inline F4 operator&(F4 a, F4 b) { return { _mm_and_ps(a.v, b.v) }; }
+	inline F4 operator|(F4 a, F4 b) { return { _mm_or_ps(a.v, b.v) }; }
+	inline F4 Select(F4 mask, F4 a, F4 b) { return { _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v)) }; }
+	inline int Mask(F4 mask) { return _mm_movemask_ps(mask.v); }
+
+	inline float ReduceMin(F4 a)
+	{
+		__m128 m = _mm_min_ps(a.v, _mm_shuffle_ps(a.v, a.v, _MM_SHUFFLE(2, 3, 0, 1)));
+		m = _mm_min_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 0, 3, 2)));
+		return _mm_cvtss_f32(m);
+	}
+
+	inline float ReduceMax(F4 a)
+	{
+		__m128 m = _mm_max_ps(a.v, _mm_shuffle_ps(a.v, a.v, _MM_SHUFFLE(2, 3, 0, 1)));
+		m = _mm_max_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 0, 3, 2)));
+		return _mm_cvtss_f32(m);
+	}
+#else
+#define SIMD_F4_BINARY(op_name, expr) \
+	inline F4 op_name(F4 a, F4 b) { F4 r; for (int i{}; i < 4; ++i) { float x = a.v[i], y = b.v[i]; r.v[i] = (expr); } return r; }
+#define SIMD_F4_COMPARE(op_name, op) \
+	inline F4 op_name(F4 a, F4 b) { F4 r; for (int i{}; i < 4; ++i) r.v[i] = (a.v[i] op b.v[i]) ? -1.f : 0.f; return r; }
+
+	SIMD_F4_BINARY(operator+, x + y)
+	SIMD_F4_BINARY(operator-, x - y)
+	SIMD_F4_BINARY(operator*, x * y)
+	SIMD_F4_BINARY(operator/, x / y)
+	SIMD_F4_BINARY(Min, y < x ? y : x)
+	SIMD_F4_BINARY(Max, x < y ? y : x)
+	SIMD_F4_COMPARE(operator<, <)
+	SIMD_F4_COMPARE(operator<=, <=)
+	SIMD_F4_COMPARE(operator>, >)
+	SIMD_F4_COMPARE(operator>=, >=)
+	SIMD_F4_BINARY(operator&, (x != 0.f && y != 0.f) ? -1.f : 0.f)
+	SIMD_F4_BINARY(operator|, (x != 0.f || y != 0.f) ? -1.f : 0.f)
+
+#undef SIMD_F4_BINARY
+#undef SIMD_F4_COMPARE
+
+	inline F4 Sqrt(F4 a) { for (auto& x : a.v) x = std::sqrt(x); return a; }
+	inline F4 Abs(F4 a) { for (auto& x : a.v) x = std::fabs(x); return a; }
+	inline F4 Floor(F4 a) { for (auto& x : a.v) x = std::floor(x); return a; }
+	inline F4 Select(F4 mask, F4 a, F4 b) { for (int i{}; i < 4; ++i) a.v[i] = mask.v[i] != 0.f ? a.v[i] : b.v[i]; return a; }
+	inline int Mask(F4 mask) { int m{}; for (int i{}; i < 4; ++i) m |= (mask.v[i] != 0.f) << i; return m; }
+	inline float ReduceMin(F4 a) { float m = a.v[0]; for (int i{ 1 }; i < 4; ++i) m = a.v[i] < m ? a.v[i] : m; return m; }
+	inline float ReduceMax(F4 a) { float m = a.v[0]; for (int i{ 1 }; i < 4; ++i) m = a.v[i] > m ? a.v[i] : m; return m; }
+#endif
+
+#ifdef SIMD_AVX
+	struct F8
+	{
+		static constexpr int WIDTH = 8;
+
+		__m256 v;
+
+		static F8 Set1(float x) { return { _mm256_set1_ps(x) }; }
+		static F8 Zero() { return { _mm256_setzero_ps() }; }
+		static F8 Load(const float* p) { return { _mm256_loadu_ps(p) }; }
+		void Store(float* p) const { _mm256_storeu_ps(p, v); }
+	};
+
+	inline F8 operator+(F8 a, F8 b) { return { _mm256_add_ps(a.v, b.v) }; }
+	inline F8 operator-(F8 a, F8 b) { return { _mm256_sub_ps(a.v, b.v) }; }
+	inline F8 operator*(F8 a, F8 b) { return { _mm256_mul_ps(a.v, b.v) }; }
+	inline F8 operator/(F8 a, F8 b) { return { _mm256_div_ps(a.v, b.v) }; }
+	inline F8 Min(F8 a, F8 b) { return { _mm256_min_ps(a.v, b.v) }; }
+	inline F8 Max(F8 a, F8 b) { return { _mm256_max_ps(a.v, b.v) }; }
+	inline F8 Sqrt(F8 a) { return { _mm256_sqrt_ps(a.v) }; }
+	inline F8 Abs(F8 a) { return { _mm256_andnot_ps(_mm256_set1_ps(-0.f), a.v) }; }
+	inline F8 Floor(F8 a) { return { _mm256_floor_ps(a.v) }; }
+
+	inline F8 operator<(F8 a, F8 b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ) }; }
+	inline F8 operator<=(F8 a, F8 b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ) }; }
+	inline F8 operator>(F8 a, F8 b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ) }; }
+	inline F8 operator>=(F8 a, F8 b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ) }; }
+	inline F8 operator&(F8 a, F8 b) { return { _mm256_and_ps(a.v, b.v) }; }
+	inline F8 operator|(F8 a, F8 b) { return { _mm256_or_ps(a.v, b.v) }; }
+	inline F8 Select(F8 mask, F8 a, F8 b) { return { _mm256_blendv_ps(b.v, a.v, mask.v) }; }
+	inline int Mask(F8 mask) { return _mm256_movemask_ps(mask.v); }
+
+	inline float ReduceMin(F8 a) { return ReduceMin(F4{ _mm_min_ps(_mm256_castps256_ps128(a.v), _mm256_extractf128_ps(a.v, 1)) }); }
+	inline float ReduceMax(F8 a) { return ReduceMax(F4{ _mm_max_ps(_mm256_castps256_ps128(a.v), _mm256_extractf128_ps(a.v, 1)) }); }
+
+	using FN = F8;
+#else
+	using FN = F4;
+#endif
+}
+
+#endif // !SIMD_H
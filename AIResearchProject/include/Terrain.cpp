@@ -1,11 +1,12 @@
 #include "Terrain.h"
 #include <Utils.h>
 #include "PoissonDiskSampling.h"
-#include "Perlin.h"
+#include "Noise.h"
 #include "delaunay.h"
 #include "vector2.h"
 #include <chrono>
 #include <Primitives.h>
+#include "CustomMath.h"
 
 static unsigned int GenerateSeed()
 {
@@ -61,90 +62,286 @@ static glm::vec3 GetColor(float value)
 	else return white;
 }
 
-static glm::vec3 ComputeFaceNormal(const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2)
+// Blends towards rock over 5 degrees either side of rock_slope
+static glm::vec3 RockBlend(glm::vec3 const& colour, float slope, float rock_slope)
 {
-	glm::vec3 edge1 = v1 - v0;
-	glm::vec3 edge2 = v2 - v0;
-	glm::vec3 normal = glm::normalize(glm::cross(edge1, edge2));
-	return normal;
+	static const glm::vec3 rock = glm::vec3(110.f / 255.f, 100.f / 255.f, 90.f / 255.f);
+
+	float t = (slope - (rock_slope - 5.f)) / 10.f;
+	if (t <= 0.f)
+		return colour;
+	if (t > 1.f) t = 1.f;
+	return InterpolateColor(colour, rock, t * t * (3.f - 2.f * t));
 }
 
-static void CalculateVertexNormals(std::vector<glm::vec3>& normals, const std::vector<glm::vec3>& vertices)
+// Arid and tundra alternatives to GetColor over the same [0, 1] height range
+static glm::vec3 GetBiomeColor(unsigned int biome, float value)
 {
-	normals.clear();
-	// Initialize vertex normals to zero
-	for (auto& vertex : vertices)
-		normals.emplace_back(glm::vec3(0.f));
+	static const glm::vec3 sand = glm::vec3(222.f / 255.f, 196.f / 255.f, 140.f / 255.f);
+	static const glm::vec3 clay = glm::vec3(176.f / 255.f, 96.f / 255.f, 60.f / 255.f);
+	static const glm::vec3 moss = glm::vec3(120.f / 255.f, 130.f / 255.f, 100.f / 255.f);
+	static const glm::vec3 ice = glm::vec3(225.f / 255.f, 235.f / 255.f, 245.f / 255.f);
 
-	// Accumulate face normals into vertex normals
-	for (size_t i{}; i < vertices.size(); i += 3)
+	value = std::clamp(value, 0.f, 1.f);
+	switch (biome % 3)
 	{
-		glm::vec3 normal = ComputeFaceNormal(vertices[i], vertices[i + 1], vertices[i + 2]);
-
-		for (int j = 0; j < 3; ++j)
-			normals[i + j] += normal;
+	case 1:		return InterpolateColor(sand, clay, std::min(value / 0.5f, 1.f));
+	case 2:		return InterpolateColor(moss, ice, std::min(value / 0.3f, 1.f));
+	default:	return GetColor(value);
 	}
+}
 
-	// Normalize the vertex normals
-	for (auto& vertex : normals)
-		vertex = glm::normalize(vertex);
+static NOISE::HeightNoise MakeNoise(TerrainSettings const& settings)
+{
+	return NOISE::HeightNoise(settings.noise, settings.seed, static_cast<int>(settings.perlin_oct), settings.perlin_persistance, settings.perlin_freq,
+							  settings.landform, settings.cells);
 }
 
-void Terrain::GeneratePoints(unsigned int seed,unsigned int no_pts, glm::vec3 map_scale, unsigned int perlin_oct, float perlin_persistance, float perlin_freq)
+// Spacing over the unit sample square: min_radius where the heightfield is steepest, min_radius * ratio where it is flat
+static Poisson::RadiusField BuildDensityField(NOISE::HeightNoise const& noise, float min_radius, TerrainSettings const& settings,
+											  std::pmr::memory_resource* scratch)
 {
-	m_terrain_vtx.clear();
-	m_nml.clear();
-	m_clrs.clear();
-	m_indices.clear();
+	const glm::vec3 map_scale = settings.map_scale;
 
-	std::vector<glm::vec2> points = Poisson::GeneratePoissonPoints(no_pts, seed);
+	constexpr int RESOLUTION = 128;
 
-	float min_x = std::numeric_limits<float>::max();
-	float max_x = std::numeric_limits<float>::lowest();
-	float min_y = std::numeric_limits<float>::max();
-	float max_y = std::numeric_limits<float>::lowest();
+	Poisson::RadiusField field{ RESOLUTION, std::pmr::vector<float>(static_cast<size_t>(RESOLUTION) * RESOLUTION, scratch) };
+	field.min_radius = min_radius;
+	field.max_radius = min_radius * CMAX(settings.density_ratio, 1.f);
 
-	for (const auto& p : points)
+	// Slope magnitude in world units on the raster nodes from the noise gradient, u and v in [0, 1] map to
+	// [-scale, scale] in x and z
+	UTILS::ParallelFor(RESOLUTION, 8, [&](size_t begin, size_t end)
 	{
-		if (p.x < min_x) min_x = p.x;
-		if (p.x > max_x) max_x = p.x;
-		if (p.y < min_y) min_y = p.y;
-		if (p.y > max_y) max_y = p.y;
+		glm::vec2 positions[RESOLUTION];
+		glm::vec2 gradients[RESOLUTION];
+		float heights[RESOLUTION];
+		for (size_t j = begin; j < end; ++j)
+		{
+			for (int i{}; i < RESOLUTION; ++i)
+				positions[i] = glm::vec2((2.f * i / (RESOLUTION - 1) - 1.f) * map_scale.x, (2.f * j / (RESOLUTION - 1) - 1.f) * map_scale.z);
+
+			noise.Sample(positions, heights, gradients, RESOLUTION);
+			for (int i{}; i < RESOLUTION; ++i)
+				field.radii[j * RESOLUTION + i] = glm::length(gradients[i]) * std::fabs(map_scale.y);
+		}
+	});
+
+	float max_slope{};
+	for (float slope : field.radii)
+		max_slope = CMAX(max_slope, slope);
+
+	for (float& r : field.radii)
+	{
+		float t = max_slope > 0.f ? r / max_slope : 0.f;
+		r = field.max_radius + (field.min_radius - field.max_radius) * t;
 	}
 
+	return field;
+}
+
+// Noise heights in world units over the whole map
+static void RasteriseHeights(EROSION::HeightGrid& grid, NOISE::HeightNoise const& noise, TerrainSettings const& settings, unsigned int resolution)
+{
+	constexpr int BATCH = 256;
+
+	glm::vec2 extent(settings.map_scale.x, settings.map_scale.z);
+	grid.Resize(-extent, extent, resolution);
+
+	UTILS::ParallelFor(static_cast<size_t>(grid.height), 16, [&](size_t begin, size_t end)
+	{
+		glm::vec2 positions[BATCH];
+		for (int y = static_cast<int>(begin); y < static_cast<int>(end); ++y)
+			for (int x0{}; x0 < grid.width; x0 += BATCH)
+			{
+				int count = std::min(BATCH, grid.width - x0);
+				for (int i{}; i < count; ++i)
+					positions[i] = grid.Position(x0 + i, y);
+
+				float* row = &grid.At(x0, y);
+				noise.Sample(positions, row, static_cast<size_t>(count));
+				for (int i{}; i < count; ++i)
+					row[i] *= settings.map_scale.y;
+			}
+	});
+}
+
+void Terrain::GeneratePoints(TerrainSettings const& settings)
+{
+	m_settings = settings;
+	m_poisson_points.clear();
+	m_scratch.Reset();
+
+	const glm::vec3 map_scale = settings.map_scale;
+	const NOISE::HeightNoise noise = MakeNoise(settings);
+
+	// Uniform spacing of point_count samples over the unit square
+	const float spacing = 1.f / std::sqrt(2.f * static_cast<float>(settings.point_count));
+
+	// Adaptive sampling keeps the uniform spacing on the steepest slopes and thins out flat ground,
+	// so point_count becomes an upper bound
+	std::pmr::vector<glm::vec2> points = settings.adaptive_density
+		? Poisson::GenerateAdaptivePoissonPoints(BuildDensityField(noise, spacing, settings, &m_scratch), settings.seed, 30, &m_scratch)
+		: Poisson::GeneratePoissonPoints(settings.point_count, settings.seed, 30, -1.f, &m_scratch);
+
+	// Refinement needs the border: unseeded, the hull is a chain of tiny edges whose midpoints round off it
+	if (settings.seed_boundary || settings.min_angle > 0.f)
+		Poisson::AddBoundaryPoints(points, spacing);
+
+	// The unit square maps straight onto [-scale, scale], a square border stays axis aligned
+	m_poisson_points.reserve(points.size());
 	for (auto& p : points)
 	{
-		float normalized_x = 2.f * (p.x - min_x) / (max_x - min_x) - 1.f;
-		float normalized_y = 2.f * (p.y - min_y) / (max_y - min_y) - 1.f;
-		p.x = normalized_x * map_scale.x;
-		p.y = normalized_y * map_scale.z;
+		p.x = (2.f * p.x - 1.f) * map_scale.x;
+		p.y = (2.f * p.y - 1.f) * map_scale.z;
 
 		m_poisson_points.emplace_back(glm::vec3(p.x, 0.f, p.y));
 	}
 
-	std::vector<Triangle2D> triangles = TESTS::Triangulate(points);
-	for (auto& tri : triangles)
+	// In place, so the mesh keeps its buffers from the last generation
+	m_mesh.Triangulate(points, &m_scratch);
+	if (settings.min_angle > 0.f)
+		m_mesh.Refine(settings.min_angle);
+
+	// Heightmap and its gradient in one evaluation, batched so the SIMD backends run a vector of points at a time
+	m_base_heights.resize(m_mesh.points.size());
+	m_base_gradients.resize(m_mesh.points.size());
+	UTILS::ParallelFor(m_mesh.points.size(), 4096, [&](size_t begin, size_t end)
 	{
-		m_terrain_vtx.emplace_back(tri.p1.x, 0.f, tri.p1.y);
-		m_terrain_vtx.emplace_back(tri.p2.x, 0.f, tri.p2.y);
-		m_terrain_vtx.emplace_back(tri.p3.x, 0.f, tri.p3.y);
+		noise.Sample(&m_mesh.points[begin], &m_base_heights[begin], &m_base_gradients[begin], end - begin);
+		for (size_t i = begin; i < end; ++i)
+		{
+			m_base_heights[i] *= map_scale.y;
+			m_base_gradients[i] *= map_scale.y;
+		}
+	});
+
+	// Erosion runs on a raster of the noise, the vertices take the height change it made
+	m_erosion_grid.heights.clear();
+	m_erosion_base.heights.clear();
+	if (settings.hydraulic.droplets > 0 || settings.thermal.iterations > 0)
+	{
+		RasteriseHeights(m_erosion_grid, noise, settings, settings.erosion_resolution);
+		m_erosion_base = m_erosion_grid;
+
+		EROSION::Hydraulic(m_erosion_grid, settings.hydraulic, settings.seed, &m_scratch);
+		EROSION::Thermal(m_erosion_grid, settings.thermal, &m_scratch);
 	}
 
-	// Heightmap
-	const siv::PerlinNoise::seed_type perlin_seed = seed;
-	const siv::PerlinNoise perlin{ perlin_seed };
+	UpdateSurface();
+}
 
-	for (auto& p : m_terrain_vtx)
+void Terrain::ApplyThermal(EROSION::ThermalSettings const& thermal)
+{
+	if (m_mesh.points.empty() || thermal.iterations == 0)
+		return;
+
+	m_scratch.Reset();
+
+	if (m_erosion_grid.heights.empty())
 	{
-		p.y = (float)perlin.octave2D_11Smooth((double)p.x, (double)p.z, perlin_oct, perlin_persistance, perlin_freq);
+		RasteriseHeights(m_erosion_grid, MakeNoise(m_settings), m_settings, m_settings.erosion_resolution);
+		m_erosion_base = m_erosion_grid;
+	}
+
+	EROSION::Thermal(m_erosion_grid, thermal, &m_scratch);
+	UpdateSurface();
+}
+
+TerrainOutput Terrain::TakeOutput()
+{
+	TerrainOutput output;
+	output.positions = std::move(m_terrain_vtx);
+	output.normals = std::move(m_nml);
+	output.colours = std::move(m_clrs);
+	output.poisson = std::move(m_poisson_points);
 
-		if (p.y < 0.f)
-			m_clrs.emplace_back(BlueToBlack(p.y));
+	m_terrain_vtx.clear();
+	m_nml.clear();
+	m_clrs.clear();
+	m_poisson_points.clear();
+	return output;
+}
+
+void Terrain::UpdateSurface()
+{
+	m_terrain_vtx.clear();
+	m_vertices.clear();
+	m_vertex_nmls.clear();
+	m_vertex_clrs.clear();
+	m_nml.clear();
+	m_clrs.clear();
+
+	const glm::vec3 map_scale = m_settings.map_scale;
+	const bool eroded = !m_erosion_grid.heights.empty();
+
+	// Height, normal and colour are evaluated once per mesh vertex, the rendered soup copies them per corner.
+	// Normals come straight from the surface gradient: h(x, z) has normal (-dh/dx, 1, -dh/dz).
+	m_vertices.reserve(m_mesh.points.size());
+	m_vertex_nmls.reserve(m_mesh.points.size());
+	m_vertex_clrs.reserve(m_mesh.points.size());
+
+	// Biome cells on a seed of their own so they do not line up with a cell height layer
+	std::pmr::vector<NOISE::CellSample<float>> biomes(&m_scratch);
+	if (m_settings.biomes)
+	{
+		biomes.resize(m_mesh.points.size());
+		const NOISE::Worley cells(m_settings.seed ^ 0xB105EEDu);
+		const float frequency = 1.f / std::max(m_settings.biome_size, 1e-3f);
+		UTILS::ParallelFor(m_mesh.points.size(), 4096, [&](size_t begin, size_t end)
+			{
+				cells.Evaluate(m_mesh.points.data() + begin, biomes.data() + begin, end - begin, frequency);
+			});
+	}
+
+	for (size_t i{}; i < m_mesh.points.size(); ++i)
+	{
+		glm::vec2 const& p = m_mesh.points[i];
+		float height = m_base_heights[i];
+		glm::vec2 gradient = m_base_gradients[i];
+		if (eroded)
+		{
+			height += m_erosion_grid.Sample(p.x, p.y) - m_erosion_base.Sample(p.x, p.y);
+			gradient += m_erosion_grid.Gradient(p.x, p.y) - m_erosion_base.Gradient(p.x, p.y);
+		}
+
+		m_vertex_nmls.emplace_back(glm::normalize(glm::vec3(-gradient.x, 1.f, -gradient.y)));
+
+		// Colours follow the unscaled noise range
+		float t = map_scale.y != 0.f ? height / map_scale.y : 0.f;
+		glm::vec3 colour;
+		if (t < 0.f)
+			colour = BlueToBlack(t);
+		else if (m_settings.biomes)
+		{
+			// Half and half on a border, the own cell's palette alone a fifth of a cell inside it
+			NOISE::CellSample<float> const& cell = biomes[i];
+			const float edge = std::min((cell.f2 - cell.f1) / 0.2f, 1.f);
+			const float w = 0.5f * (1.f - edge * edge * (3.f - 2.f * edge));
+			colour = InterpolateColor(GetBiomeColor(static_cast<unsigned int>(cell.id1), t), GetBiomeColor(static_cast<unsigned int>(cell.id2), t), w);
+		}
 		else
-			m_clrs.emplace_back(GetColor(p.y));
+			colour = GetColor(t);
+		if (t >= 0.f && m_settings.rock_slope > 0.f)
+			colour = RockBlend(colour, glm::degrees(std::atan(glm::length(gradient))), m_settings.rock_slope);
+		m_vertex_clrs.emplace_back(colour);
 
-		p.y *= map_scale.y;
+		m_vertices.emplace_back(p.x, height, p.y);
 	}
 
-	CalculateVertexNormals(m_nml, m_terrain_vtx);
-}
\ No newline at end of file
+	// Clockwise in (x, y) maps to upward face normals once y becomes z, so mesh order is kept
+	m_indices = m_mesh.triangles;
+
+	m_terrain_vtx.reserve(m_indices.size());
+	m_nml.reserve(m_indices.size());
+	m_clrs.reserve(m_indices.size());
+	for (unsigned int idx : m_indices)
+	{
+		m_terrain_vtx.push_back(m_vertices[idx]);
+		m_nml.push_back(m_vertex_nmls[idx]);
+		m_clrs.push_back(m_vertex_clrs[idx]);
+	}
+
+	m_ray_query.Build(m_vertices, m_indices, &m_scratch);
+	m_height_query.Build(m_vertices, m_indices, &m_scratch);
+}
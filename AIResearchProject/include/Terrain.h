@@ -2,24 +2,100 @@
 #define TERRAIN_H
 
 #include <includes.h>
+#include "TerrainRayQuery.h"
+#include "TerrainHeightQuery.h"
+#include "HalfEdgeMesh.h"
+#include "Erosion.h"
+#include "Utils.h"
+#include "Noise.h"
+
+struct TerrainSettings
+{
+	unsigned int seed{ 1234 };
+	unsigned int point_count{ 10000 };
+	glm::vec3 map_scale{ 10.f };
+	NOISE::Backend noise{ NOISE::Backend::PERLIN };	// Heightfield noise, the octave settings below apply to either
+	NOISE::Landform landform{ NOISE::Landform::OCTAVES };	// Any other landform is built from simplex sources whatever the backend
+	unsigned int perlin_oct{ 4 };
+	float perlin_persistance{ 0.5f };
+	float perlin_freq{ 10.f };
+
+	bool adaptive_density{ false };	// Steep ground sampled up to density_ratio times more finely than flat ground, point_count becomes an upper bound
+	float density_ratio{ 4.f };
+	float min_angle{ 0.f };			// Refines the triangulation to this smallest angle in degrees when > 0, implies seed_boundary
+	bool seed_boundary{ false };	// Lines the map border with evenly spaced points so border triangles can be refined as well
+	float rock_slope{ 0.f };		// Degrees, ground above sea level steeper than this turns to rock; 0 disables
+	NOISE::CellSettings cells;		// Worley height layer over the noise
+	bool biomes{ false };			// Colours land from one palette per Worley cell, blended across cell borders
+	float biome_size{ 8.f };		// World units per biome cell
+
+	unsigned int erosion_resolution{ 512 };	// Erosion grid samples along the longer side of the map
+	EROSION::HydraulicSettings hydraulic;
+	EROSION::ThermalSettings thermal;
+};
+
+// Render buffers of a generated terrain, moved out of the Terrain so they exist once on their way to the GPU
+struct TerrainOutput
+{
+	std::vector<glm::vec3> positions;	// Triangle soup, three vertices per triangle
+	std::vector<glm::vec3> normals;
+	std::vector<glm::vec3> colours;
+	std::vector<glm::vec3> poisson;		// Empty when the sample points did not change since the last TakeOutput
+};
 
 class Terrain
 {
 public:
-	void GeneratePoints(unsigned int seed = 1234, unsigned int no_pts = 10000, glm::vec3 map_scale = glm::vec3(10.f), unsigned int perlin_oct = 4, float perlin_persistance = 0.5f, float perlin_freq = 10.f);
+	void GeneratePoints(TerrainSettings const& settings = TerrainSettings());
+
+	// Further thermal iterations on the erosion grid of the current terrain, vertices and buffers are updated in place
+	void ApplyThermal(EROSION::ThermalSettings const& thermal);
 
-	std::vector<glm::vec3> GetVtx()  const { return m_terrain_vtx; }
-	std::vector<glm::vec3> GetNml()  const { return m_nml; }
-	std::vector<glm::vec3> GetClr()  const { return m_clrs; }
-	std::vector<unsigned int> GetIndices()  const { return m_indices; }
-	std::vector<glm::vec3> GetPoisson() const { return m_poisson_points; }
+	// Triangle soup for rendering, three vertices per triangle of GetIndices(); empty after TakeOutput
+	std::vector<glm::vec3> const& GetVtx()  const { return m_terrain_vtx; }
+	std::vector<glm::vec3> const& GetNml()  const { return m_nml; }
+	std::vector<glm::vec3> const& GetClr()  const { return m_clrs; }
+	std::vector<unsigned int> const& GetIndices()  const { return m_indices; }	// Into GetSharedVtx()
+	std::vector<glm::vec3> const& GetSharedVtx() const { return m_vertices; }	// One vertex per mesh point
+	std::vector<glm::vec3> const& GetSharedNml() const { return m_vertex_nmls; }
+	std::vector<glm::vec3> const& GetSharedClr() const { return m_vertex_clrs; }
+	HalfEdgeMesh const& GetMesh() const { return m_mesh; }
+	std::vector<glm::vec3> const& GetPoisson() const { return m_poisson_points; }
+
+	// Moves the render buffers out, the mesh, shared vertex attributes and queries stay. ApplyThermal rebuilds the soup.
+	TerrainOutput TakeOutput();
+
+	TerrainRayQuery const& GetRayQuery() const { return m_ray_query; }
+	TerrainHeightQuery const& GetHeightQuery() const { return m_height_query; }
 
 private:
+	// Vertex heights and gradients from the base values plus the erosion grid's change, then normals, colours, soup and queries
+	void UpdateSurface();
+
+	TerrainSettings m_settings;
+
 	std::vector<glm::vec3> m_poisson_points;
 	std::vector<glm::vec3> m_terrain_vtx;
 	std::vector<glm::vec3> m_nml;
 	std::vector<glm::vec3> m_clrs;
 	std::vector<unsigned int> m_indices;
+	std::vector<glm::vec3> m_vertices;
+	std::vector<glm::vec3> m_vertex_nmls;
+	std::vector<glm::vec3> m_vertex_clrs;
+	std::vector<float> m_base_heights;	// Noise height per mesh point, before erosion
+	std::vector<glm::vec2> m_base_gradients;	// Its analytic (dh/dx, dh/dz) in world units
+
+	HalfEdgeMesh m_mesh;
+
+	EROSION::HeightGrid m_erosion_grid;	// Empty until an erosion stage runs
+	EROSION::HeightGrid m_erosion_base;	// The grid as rasterised, before erosion
+
+	TerrainRayQuery m_ray_query;
+	TerrainHeightQuery m_height_query;
+
+	// Generation context: every stage's temporary buffers come from here, reset at the start of each pass.
+	// Output buffers above are cleared rather than replaced, so repeated passes reuse their capacity.
+	UTILS::Arena m_scratch;
 };
 
 #endif // !TERRAIN_H
@@ -0,0 +1,64 @@
+#ifndef TERRAIN_HEIGHT_QUERY_H
+#define TERRAIN_HEIGHT_QUERY_H
+
+#include "includes.h"
+
+#include <memory_resource>
+
+struct HeightSample
+{
+	static constexpr unsigned int NONE = 0xFFFFFFFFu;
+
+	float height{};
+	glm::vec3 normal{ 0.f, 1.f, 0.f };
+	unsigned int triangle{ NONE };	// Triangle index into the source mesh, NONE when (x, z) is off the terrain
+
+	bool Valid() const { return triangle != NONE; }
+};
+
+/*
+* Height lookups on a heightfield-like triangle mesh (the generated terrain).
+* A uniform xz grid maps each cell to the triangles overlapping it (CSR layout: cell -> [start, start + count)),
+* so a lookup touches one cell and a handful of triangles regardless of terrain size.
+*/
+class TerrainHeightQuery
+{
+public:
+	// vertices are read as triangles, either through indices or three consecutive vertices per triangle when indices is empty
+	void Build(std::vector<glm::vec3> const& vertices, std::vector<unsigned int> const& indices = {},
+			   std::pmr::memory_resource* scratch = std::pmr::get_default_resource());
+	void Clear();
+
+	bool Empty() const { return m_triangles.empty(); }
+
+	// Barycentric height and face normal of the terrain at (x, z)
+	HeightSample Sample(float x, float z) const;
+	float Height(float x, float z, float fallback = 0.f) const;
+
+	// Batched lookup, split across UTILS::ParallelFor workers
+	void Sample(glm::vec2 const* xz, size_t count, HeightSample* samples) const;
+
+private:
+	struct GridTriangle
+	{
+		glm::vec2 origin;		// v0.xz
+		glm::vec2 inv_row0;		// Rows of the inverse of [e1.xz e2.xz], maps xz to (u, v)
+		glm::vec2 inv_row1;
+		float y0, dy1, dy2;		// v0.y, e1.y, e2.y
+		glm::vec3 normal;
+	};
+
+	int CellX(float x) const;
+	int CellZ(float z) const;
+
+	glm::vec2 m_min{}, m_max{};
+	glm::vec2 m_inv_cell_size{};
+	int m_cells_x{}, m_cells_z{};
+
+	std::vector<GridTriangle>	m_triangles;
+	std::vector<unsigned int>	m_triangle_ids;
+	std::vector<unsigned int>	m_cell_start;	// m_cells_x * m_cells_z + 1 offsets into m_cell_triangles
+	std::vector<unsigned int>	m_cell_triangles;
+};
+
+#endif // !TERRAIN_HEIGHT_QUERY_H
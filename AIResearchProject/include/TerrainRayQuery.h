@@ -0,0 +1,89 @@
+#ifndef TERRAIN_RAY_QUERY_H
+#define TERRAIN_RAY_QUERY_H
+
+#include "includes.h"
+#include "Primitives.h"
+#include "SIMD.h"
+
+#include <limits>
+#include <memory_resource>
+
+struct RayHit
+{
+	static constexpr unsigned int NONE = 0xFFFFFFFFu;
+
+	float t{};
+	float u{}, v{};					// Barycentric coordinates of the hit on the triangle
+	unsigned int triangle{ NONE };	// Triangle index into the source mesh
+
+	bool Hit() const { return triangle != NONE; }
+};
+
+/*
+* Ray queries against a static triangle mesh (the generated terrain).
+* Triangles are sorted into a flat BVH whose leaves each hold one block of LANES triangles in SoA form,
+* so a single ray is tested against a whole leaf with one 4/8-wide Moller-Trumbore pass.
+* Packet queries split the rays across UTILS::ParallelFor workers.
+*/
+class TerrainRayQuery
+{
+public:
+	static constexpr int LANES = SIMD::FN::WIDTH;
+
+	// vertices are read as triangles, either through indices or three consecutive vertices per triangle when indices is empty
+	void Build(std::vector<glm::vec3> const& vertices, std::vector<unsigned int> const& indices = {},
+			   std::pmr::memory_resource* scratch = std::pmr::get_default_resource());
+	void Clear();
+
+	bool Empty() const { return m_nodes.empty(); }
+	size_t TriangleCount() const { return m_triangle_count; }
+
+	// Closest hit along origin + t * direction for t in (0, t_max]
+	RayHit Cast(Ray const& ray, float t_max = std::numeric_limits<float>::max()) const;
+
+	// True if anything is hit for t in (0, t_max]; stops at the first hit
+	bool Occluded(Ray const& ray, float t_max = std::numeric_limits<float>::max()) const;
+
+	/*
+	* PACKETS
+	*/
+	void Cast(Ray const* rays, size_t count, RayHit* hits, float t_max = std::numeric_limits<float>::max()) const;
+
+	// Line of sight between from[i] and to[i], writes 1 into visible[i] when the segment is unobstructed
+	void LineOfSight(glm::vec3 const* from, glm::vec3 const* to, size_t count, unsigned char* visible) const;
+
+private:
+	struct Node
+	{
+		glm::vec3 min;
+		unsigned int index;	// Leaf: triangle block, inner: right child (left child is the next node)
+		glm::vec3 max;
+		unsigned int leaf;
+	};
+
+	struct TriangleBlock
+	{
+		float v0x[LANES], v0y[LANES], v0z[LANES];
+		float e1x[LANES], e1y[LANES], e1z[LANES];
+		float e2x[LANES], e2y[LANES], e2z[LANES];
+		unsigned int id[LANES];
+	};
+
+	struct BuildTriangle
+	{
+		glm::vec3 v0, v1, v2;
+		glm::vec3 min, max, centroid;
+		unsigned int id;
+	};
+
+	unsigned int BuildRecursive(std::pmr::vector<BuildTriangle>& tris, size_t begin, size_t end);
+
+	template <bool ANY_HIT>
+	bool Traverse(Ray const& ray, float t_max, RayHit& hit) const;
+
+	std::vector<Node>			m_nodes;
+	std::vector<TriangleBlock>	m_blocks;
+	size_t						m_triangle_count{};
+};
+
+#endif // !TERRAIN_RAY_QUERY_H
@@ -3,7 +3,9 @@
 
 #include <includes.h>
 
+#include <memory_resource>
 #include <random>
+#include <thread>
 
 namespace UTILS
 {
@@ -18,6 +20,101 @@ namespace UTILS
 		void SetSeed(unsigned int seed) { dre.seed(seed); }
 		T getRNG() { return urdf(dre); }
 	};
+
+	// Non-owning view over contiguous elements, stands in for std::span until the project moves past C++17
+	template <typename T>
+	struct Span
+	{
+		T* data{ nullptr };
+		size_t size{};
+
+		Span() = default;
+		Span(T* ptr, size_t count) : data(ptr), size(count) {}
+		template <typename U, typename A>
+		Span(std::vector<U, A>& v) : data(v.data()), size(v.size()) {}
+		template <typename U, typename A>
+		Span(std::vector<U, A> const& v) : data(v.data()), size(v.size()) {}
+
+		T& operator[](size_t i) const { return data[i]; }
+		T* begin() const { return data; }
+		T* end() const { return data + size; }
+		bool empty() const { return size == 0; }
+		Span Sub(size_t offset, size_t count) const { return Span(data + offset, count); }
+	};
+
+	/*
+	* Monotonic scratch memory for one generation pass, handed to std::pmr containers. Deallocation is a no-op and
+	* Reset() rewinds the whole block at once. Requests past the block spill to the heap and the next Reset() grows
+	* the block to the pass's high-water mark, so repeated passes of the same size stop allocating after the first.
+	* Not thread safe, allocate from the calling thread only.
+	*/
+	class Arena : public std::pmr::memory_resource
+	{
+	public:
+		explicit Arena(size_t capacity = 0);
+		~Arena() override;
+		Arena(Arena const&) = delete;
+		Arena& operator=(Arena const&) = delete;
+
+		void Reset();
+
+		size_t Capacity() const { return m_capacity; }
+		size_t Used() const { return m_used; }	// Bytes handed out since the last Reset, padding included
+
+	private:
+		void* do_allocate(size_t bytes, size_t alignment) override;
+		void do_deallocate(void*, size_t, size_t) override {}
+		bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override { return this == &other; }
+
+		struct Spill
+		{
+			void* ptr;
+			size_t alignment;
+		};
+
+		unsigned char* m_block{ nullptr };
+		size_t m_capacity{};
+		size_t m_offset{};
+		size_t m_used{};
+		std::vector<Spill> m_spills;
+	};
+
+	/* THREADING */
+	// Number of threads used by ParallelFor, 0 picks std::thread::hardware_concurrency
+	void SetWorkerCount(unsigned int count);
+	unsigned int GetWorkerCount();
+
+	// Runs call(context, begin, end) on the ranges of chunk elements covering [0, count), the calling thread takes the
+	// first range and workers of a pool that lives for the whole process the rest. Calls made from inside a range, or
+	// while another thread has the pool, run every range inline.
+	void RunRanges(size_t count, size_t chunk, void (*call)(void*, size_t, size_t), void* context);
+
+	// Splits [0, count) into contiguous ranges of at least min_chunk and calls fn(begin, end) on each.
+	// The calling thread takes the first range, so a single worker runs inline.
+	template <typename F>
+	void ParallelFor(size_t count, size_t min_chunk, F&& fn)
+	{
+		if (count == 0)
+			return;
+
+		size_t workers = GetWorkerCount();
+		if (min_chunk == 0)
+			min_chunk = 1;
+		if (workers > (count + min_chunk - 1) / min_chunk)
+			workers = (count + min_chunk - 1) / min_chunk;
+
+		if (workers <= 1)
+		{
+			fn(size_t{ 0 }, count);
+			return;
+		}
+
+		using Fn = std::remove_reference_t<F>;
+		RunRanges(count, (count + workers - 1) / workers, [](void* context, size_t begin, size_t end)
+		{
+			(*static_cast<Fn*>(context))(begin, end);
+		}, const_cast<void*>(static_cast<void const*>(&fn)));
+	}
 }
 
 #endif // !UTILS_H
@@ -0,0 +1,22 @@
+#ifndef VERIFY_H
+#define VERIFY_H
+
+/*
+* Headless determinism check: generates a fixed matrix of terrains (seeds, sizes, noise backends, landforms, refinement
+* and erosion) at several worker counts, hashes the shared vertex positions and triangle indices of each, and compares
+* them against the golden hashes committed with the project. Every worker count must give the same hash, and that
+* hash must match the golden one. A few structural checks on the geometry code follow, each a regression for a case
+* that once broke. Run it before and after any change meant to keep output as it is.
+*	AIResearchProject --verify [--goldens PATH] [--record]
+* --record rewrites the goldens from this run, for changes that alter output on purpose. The exit code is 0 when every
+* case matches.
+*/
+namespace VERIFY
+{
+	bool Requested(int argc, char** argv);
+
+	// Returns the process exit code
+	int Run(int argc, char** argv);
+}
+
+#endif // !VERIFY_H
@@ -6,9 +6,13 @@
 #include <iostream>
 #include <limits>
 #include <memory>
+#include <memory_resource>
+#include <stdexcept>
 #include <utility>
 #include <vector>
 
+#include "Predicates.h"
+
 namespace delaunator
 {
 
@@ -19,7 +23,7 @@ namespace delaunator
     }
 
     // Kahan and Babuska summation, Neumaier variant; accumulates less FP error
-    inline double sum(const std::vector<double>& x)
+    inline double sum(const std::pmr::vector<double>& x)
     {
         double sum = x[0];
         double err = 0.0;
@@ -83,7 +87,7 @@ namespace delaunator
         const double rx,
         const double ry)
     {
-        return (qy - py) * (rx - qx) - (qx - px) * (ry - qy) < 0.0;
+        return PREDICATES::Orient2D(px, py, qx, qy, rx, ry) > 0.0;
     }
 
     inline std::pair<double, double> circumcenter(
@@ -112,7 +116,7 @@ namespace delaunator
     struct compare
     {
 
-        std::vector<double> const& coords;
+        std::pmr::vector<double> const& coords;
         double cx;
         double cy;
 
@@ -149,20 +153,7 @@ namespace delaunator
         const double px,
         const double py)
     {
-        const double dx = ax - px;
-        const double dy = ay - py;
-        const double ex = bx - px;
-        const double ey = by - py;
-        const double fx = cx - px;
-        const double fy = cy - py;
-
-        const double ap = dx * dx + dy * dy;
-        const double bp = ex * ex + ey * ey;
-        const double cp = fx * fx + fy * fy;
-
-        return (dx * (ey * cp - bp * fy) -
-                dy * (ex * cp - bp * fx) +
-                ap * (ex * fy - ey * fx)) < 0.0;
+        return PREDICATES::InCircle(ax, ay, bx, by, cx, cy, px, py) < 0.0;
     }
 
     constexpr double EPSILON = std::numeric_limits<double>::epsilon();
@@ -196,24 +187,25 @@ namespace delaunator
     {
 
     public:
-        std::vector<double> const& coords;
-        std::vector<std::size_t> triangles;
-        std::vector<std::size_t> halfedges;
-        std::vector<std::size_t> hull_prev;
-        std::vector<std::size_t> hull_next;
-        std::vector<std::size_t> hull_tri;
+        std::pmr::vector<double> const& coords;
+        std::pmr::vector<std::size_t> triangles;
+        std::pmr::vector<std::size_t> halfedges;
+        std::pmr::vector<std::size_t> hull_prev;
+        std::pmr::vector<std::size_t> hull_next;
+        std::pmr::vector<std::size_t> hull_tri;
         std::size_t hull_start;
 
-        Delaunator(std::vector<double> const& in_coords);
+        // Every working and output buffer comes from resource
+        Delaunator(std::pmr::vector<double> const& in_coords, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 
         double get_hull_area();
 
     private:
-        std::vector<std::size_t> m_hash;
+        std::pmr::vector<std::size_t> m_hash;
         double m_center_x;
         double m_center_y;
         std::size_t m_hash_size;
-        std::vector<std::size_t> m_edge_stack;
+        std::pmr::vector<std::size_t> m_edge_stack;
 
         std::size_t legalize(std::size_t a);
         std::size_t hash_key(double x, double y) const;
@@ -227,19 +219,19 @@ namespace delaunator
         void link(std::size_t a, std::size_t b);
     };
 
-    Delaunator::Delaunator(std::vector<double> const& in_coords)
+    inline Delaunator::Delaunator(std::pmr::vector<double> const& in_coords, std::pmr::memory_resource* resource)
         : coords(in_coords),
-        triangles(),
-        halfedges(),
-        hull_prev(),
-        hull_next(),
-        hull_tri(),
+        triangles(resource),
+        halfedges(resource),
+        hull_prev(resource),
+        hull_next(resource),
+        hull_tri(resource),
         hull_start(),
-        m_hash(),
+        m_hash(resource),
         m_center_x(),
         m_center_y(),
         m_hash_size(),
-        m_edge_stack()
+        m_edge_stack(resource)
     {
         std::size_t n = coords.size() >> 1;
 
@@ -247,7 +239,7 @@ namespace delaunator
         double max_y = std::numeric_limits<double>::min();
         double min_x = std::numeric_limits<double>::max();
         double min_y = std::numeric_limits<double>::max();
-        std::vector<std::size_t> ids;
+        std::pmr::vector<std::size_t> ids(resource);
         ids.reserve(n);
 
         for (std::size_t i = 0; i < n; i++)
@@ -467,9 +459,9 @@ namespace delaunator
         }
     }
 
-    double Delaunator::get_hull_area()
+    inline double Delaunator::get_hull_area()
     {
-        std::vector<double> hull_area;
+        std::pmr::vector<double> hull_area;
         size_t e = hull_start;
         do
         {
@@ -479,7 +471,7 @@ namespace delaunator
         return sum(hull_area);
     }
 
-    std::size_t Delaunator::legalize(std::size_t a)
+    inline std::size_t Delaunator::legalize(std::size_t a)
     {
         std::size_t i = 0;
         std::size_t ar = 0;
@@ -605,7 +597,7 @@ namespace delaunator
             m_hash_size);
     }
 
-    std::size_t Delaunator::add_triangle(
+    inline std::size_t Delaunator::add_triangle(
         std::size_t i0,
         std::size_t i1,
         std::size_t i2,
@@ -623,7 +615,7 @@ namespace delaunator
         return t;
     }
 
-    void Delaunator::link(const std::size_t a, const std::size_t b)
+    inline void Delaunator::link(const std::size_t a, const std::size_t b)
     {
         std::size_t s = halfedges.size();
         if (a == s)
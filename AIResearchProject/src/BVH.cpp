@@ -4,6 +4,16 @@
 #include <Engine.h>
 
 BVHNode* BVHTopDown::Build(std::vector<Object*>& objects, BVTYPE type, int depth)
+{
+	m_type = type;
+	m_leaf_of.clear();
+
+	BVHNode* node = BuildRecursive(objects, type, depth);
+	m_build_cost = BVHHelpers::SAHCost(node, type);
+	return node;
+}
+
+BVHNode* BVHTopDown::BuildRecursive(std::vector<Object*>& objects, BVTYPE type, int depth)
 {
 	if (objects.empty())
 		return nullptr;
@@ -19,20 +29,18 @@ BVHNode* BVHTopDown::Build(std::vector<Object*>& objects, BVTYPE type, int depth
 	if (type == T_AABB)
 	{
 		AABBNode* node = new AABBNode();
-		node->left = Build(l_objs, type, depth + 1);
-		node->right = Build(r_objs, type, depth + 1);
-		if (node->left && node->right)
-			node->aabb = BVHHelpers::CombineAABB(reinterpret_cast<AABBNode*>(node->left)->aabb, reinterpret_cast<AABBNode*>(node->right)->aabb);
+		node->left = BuildRecursive(l_objs, type, depth + 1);
+		node->right = BuildRecursive(r_objs, type, depth + 1);
+		BVHHelpers::SetChildren(node, node->left, node->right, type);
 		node->height = depth;
 		return node;
 	}
 	else
 	{
 		BSNode* node = new BSNode();
-		node->left = Build(l_objs, type, depth + 1);
-		node->right = Build(r_objs, type, depth + 1);
-		if (node->left && node->right)
-			node->bs = BVHHelpers::CombineBS(reinterpret_cast<BSNode*>(node->left)->bs, reinterpret_cast<BSNode*>(node->right)->bs);
+		node->left = BuildRecursive(l_objs, type, depth + 1);
+		node->right = BuildRecursive(r_objs, type, depth + 1);
+		BVHHelpers::SetChildren(node, node->left, node->right, type);
 		node->height = depth;
 		return node;
 	}
@@ -64,24 +72,23 @@ void BVHBotUp::ClearBVH(BVHNode* node)
 	node = nullptr;
 }
 
-BVHNode* BVHTopDown::CreateLeafNode(std::vector<Object*>& objects, BVTYPE type) const
+BVHNode* BVHTopDown::CreateLeafNode(std::vector<Object*>& objects, BVTYPE type)
 {
+	BVHNode* leaf;
 	if (type == T_AABB)
-	{
-		AABBNode* leaf = new AABBNode();
-		leaf->aabb = objects.front()->GetAABB();
-		leaf->left = leaf->right = nullptr;
-		leaf->height = maxHeight;
-		return leaf;
-	}
+		leaf = new AABBNode();
 	else
-	{
-		BSNode* leaf = new BSNode();
-		leaf->bs = objects.front()->GetSphere();
-		leaf->left = leaf->right = nullptr;
-		leaf->height = maxHeight;
-		return leaf;
-	}
+		leaf = new BSNode();
+
+	// A leaf at max height can hold several objects, its volume has to cover all of them
+	leaf->objects = objects;
+	leaf->height = maxHeight;
+	BVHHelpers::UpdateLeafVolume(leaf, type);
+
+	for (auto& obj : objects)
+		m_leaf_of[obj] = leaf;
+
+	return leaf;
 }
 
 int BVHTopDown::ChooseSplitAxis(std::vector<Object*> objects, BVTYPE type)
@@ -247,10 +254,16 @@ float BVHTopDown::ComputeTotalBoundingVolume(const std::vector<Object*>& objects
 
 BVHNode* BVHBotUp::Build(std::vector<Object*>& objects, BVTYPE type)
 {
+	m_type = type;
+	m_leaf_of.clear();
+
 	std::vector<BVHNode*> nodes{};
 
 	for (auto& obj : objects)
+	{
 		nodes.emplace_back(CreateLeafNode(obj, type));
+		m_leaf_of[obj] = nodes.back();
+	}
 
 	while (nodes.size() > 1)
 	{
@@ -267,7 +280,9 @@ BVHNode* BVHBotUp::Build(std::vector<Object*>& objects, BVTYPE type)
 		nodes.emplace_back(parent);
 	}
 
-	return nodes.empty() ? nullptr : nodes[0];
+	BVHNode* root_node = nodes.empty() ? nullptr : nodes[0];
+	m_build_cost = BVHHelpers::SAHCost(root_node, type);
+	return root_node;
 }
 
 void BVHBotUp::FindNodesToMerge(std::vector<BVHNode*> nodes, BVHNode*& first, BVHNode*& second, BVTYPE type)
@@ -296,12 +311,14 @@ BVHNode* BVHBotUp::CreateLeafNode(Object* object, BVTYPE type) const
 	{
 		AABBNode* node = new AABBNode();
 		node->aabb = object->GetAABB();
+		node->objects.push_back(object);
 		return node;
 	}
 	else
 	{
 		BSNode* node = new BSNode();
 		node->bs = object->GetSphere();
+		node->objects.push_back(object);
 		return node;
 	}
 }
@@ -311,17 +328,13 @@ BVHNode* BVHBotUp::MergeNode(BVHNode* first, BVHNode* second, BVTYPE type)
 	if (type == T_AABB)
 	{
 		AABBNode* parent = new AABBNode();
-		parent->aabb = BVHHelpers::CombineAABB(reinterpret_cast<AABBNode*>(first)->aabb, reinterpret_cast<AABBNode*>(second)->aabb);
-		parent->left = first;
-		parent->right = second;
+		BVHHelpers::SetChildren(parent, first, second, type);
 		return parent;
 	}
 	else
 	{
 		BSNode* parent = new BSNode();
-		parent->bs = BVHHelpers::CombineBS(reinterpret_cast<BSNode*>(first)->bs, reinterpret_cast<BSNode*>(second)->bs);
-		parent->left = first;
-		parent->right = second;
+		BVHHelpers::SetChildren(parent, first, second, type);
 		return parent;
 	}
 }
@@ -357,4 +370,155 @@ float BVHBotUp::CalculateHeuristic(BVHNode* first, BVHNode* second, BVTYPE type)
 
 		return distance + comb_vol + relative_increase;
 	}
-}
\ No newline at end of file
+}
+
+void BVHTopDown::Refit(std::vector<Object*> const& moved)
+{
+	BVHHelpers::RefitLeaves(moved, m_leaf_of, m_type);
+}
+
+float BVHTopDown::Degradation() const
+{
+	return m_build_cost > 0.f ? BVHHelpers::SAHCost(root, m_type) / m_build_cost : 1.f;
+}
+
+void BVHBotUp::Refit(std::vector<Object*> const& moved)
+{
+	BVHHelpers::RefitLeaves(moved, m_leaf_of, m_type);
+}
+
+float BVHBotUp::Degradation() const
+{
+	return m_build_cost > 0.f ? BVHHelpers::SAHCost(root, m_type) / m_build_cost : 1.f;
+}
+
+void BVHHelpers::SetChildren(BVHNode* node, BVHNode* left, BVHNode* right, BVTYPE type)
+{
+	node->left = left;
+	node->right = right;
+	if (left)
+		left->parent = node;
+	if (right)
+		right->parent = node;
+
+	UpdateInnerVolume(node, type);
+}
+
+bool BVHHelpers::UpdateInnerVolume(BVHNode* node, BVTYPE type)
+{
+	BVHNode* only = node->left ? node->left : node->right;
+	if (!only)
+		return false;
+
+	if (type == T_AABB)
+	{
+		AABB& aabb = reinterpret_cast<AABBNode*>(node)->aabb;
+		AABB combined = reinterpret_cast<AABBNode*>(only)->aabb;
+		if (node->left && node->right)
+			combined = CombineAABB(reinterpret_cast<AABBNode*>(node->left)->aabb, reinterpret_cast<AABBNode*>(node->right)->aabb);
+
+		bool changed = combined.center.p != aabb.center.p || combined.half_extent.p != aabb.half_extent.p;
+		aabb = combined;
+		return changed;
+	}
+	else
+	{
+		BoundingSphere& bs = reinterpret_cast<BSNode*>(node)->bs;
+		BoundingSphere combined = reinterpret_cast<BSNode*>(only)->bs;
+		if (node->left && node->right)
+			combined = CombineBS(reinterpret_cast<BSNode*>(node->left)->bs, reinterpret_cast<BSNode*>(node->right)->bs);
+
+		bool changed = combined.position.p != bs.position.p || combined.radius != bs.radius;
+		bs = combined;
+		return changed;
+	}
+}
+
+void BVHHelpers::UpdateLeafVolume(BVHNode* leaf, BVTYPE type)
+{
+	if (leaf->objects.empty())
+		return;
+
+	if (type == T_AABB)
+	{
+		AABB aabb = leaf->objects.front()->GetAABB();
+		for (size_t i{ 1 }; i < leaf->objects.size(); ++i)
+			aabb = CombineAABB(aabb, leaf->objects[i]->GetAABB());
+		reinterpret_cast<AABBNode*>(leaf)->aabb = aabb;
+	}
+	else
+	{
+		BoundingSphere bs = leaf->objects.front()->GetSphere();
+		for (size_t i{ 1 }; i < leaf->objects.size(); ++i)
+			bs = CombineBS(bs, leaf->objects[i]->GetSphere());
+		reinterpret_cast<BSNode*>(leaf)->bs = bs;
+	}
+}
+
+void BVHHelpers::RefitLeaf(BVHNode* leaf, BVTYPE type)
+{
+	UpdateLeafVolume(leaf, type);
+
+	for (BVHNode* node = leaf->parent; node; node = node->parent)
+	{
+		if (!UpdateInnerVolume(node, type))
+			break;
+	}
+}
+
+void BVHHelpers::RefitLeaves(std::vector<Object*> const& moved, std::unordered_map<Object*, BVHNode*> const& leaf_of, BVTYPE type)
+{
+	for (auto& obj : moved)
+	{
+		auto it = leaf_of.find(obj);
+		if (it != leaf_of.end())
+			RefitLeaf(it->second, type);
+	}
+}
+
+float BVHHelpers::SurfaceArea(const AABB& aabb)
+{
+	glm::vec3 e = aabb.half_extent.p * 2.f;
+	return 2.f * (e.x * e.y + e.y * e.z + e.z * e.x);
+}
+
+float BVHHelpers::SurfaceArea(const BoundingSphere& sphere)
+{
+	return 4.f * static_cast<float>(M_PI) * sphere.radius * sphere.radius;
+}
+
+float BVHHelpers::SAHCost(BVHNode* root, BVTYPE type)
+{
+	if (!root)
+		return 0.f;
+
+	auto area = [type](BVHNode* node)
+	{
+		return type == T_AABB ? SurfaceArea(reinterpret_cast<AABBNode*>(node)->aabb) : SurfaceArea(reinterpret_cast<BSNode*>(node)->bs);
+	};
+
+	float root_area = area(root);
+	if (root_area <= 0.f)
+		return 0.f;
+
+	// Traversal cost for inner nodes, one intersection per object for leaves
+	float cost{};
+	std::vector<BVHNode*> stack{ root };
+	while (!stack.empty())
+	{
+		BVHNode* node = stack.back();
+		stack.pop_back();
+
+		if (!node->left && !node->right)
+		{
+			cost += area(node) * static_cast<float>(node->objects.size());
+			continue;
+		}
+
+		cost += area(node);
+		if (node->left) stack.push_back(node->left);
+		if (node->right) stack.push_back(node->right);
+	}
+
+	return cost / root_area;
+}
@@ -0,0 +1,225 @@
+#include "Bake.h"
+#include "Export.h"
+#include "Utils.h"
+#include "CustomMath.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+	void PrintUsage()
+	{
+		std::cout << "Usage: AIResearchProject --bake [--seed N] [--points N] [--scale X Y Z] [--noise perlin|simplex|perlin-float]\n"
+					 "                         [--landform octaves|alpine|mesas|badlands] [--octaves N] [--persistance F] [--frequency F]\n"
+					 "                         [--cells none|plateaus|craters|rocks] [--cell-size F] [--cell-height F]\n"
+					 "                         [--adaptive] [--density-ratio F] [--min-angle F] [--seed-boundary] [--rock-slope F]\n"
+					 "                         [--biomes] [--biome-size F]\n"
+					 "                         [--droplets N] [--thermal N] [--talus F] [--erosion-resolution N] [--threads N]\n"
+					 "                         [--export PATH.glb|PATH.obj]... [--heightmap PATH.png|PATH.r32]... [--heightmap-size W H]\n";
+	}
+}
+
+bool BAKE::Requested(int argc, char** argv)
+{
+	return argc > 1 && std::strcmp(argv[1], "--bake") == 0;
+}
+
+bool BAKE::ParseOptions(int argc, char** argv, Options& options)
+{
+	TerrainSettings& settings = options.settings;
+	for (int i = 2; i < argc; ++i)
+	{
+		const char* arg = argv[i];
+
+		// Options taking values read them through next(), which fails past the end of argv
+		bool ok = true;
+		auto next = [&]() -> const char*
+		{
+			if (i + 1 >= argc)
+			{
+				ok = false;
+				return "0";
+			}
+			return argv[++i];
+		};
+		auto next_uint = [&]() { return static_cast<unsigned int>(std::strtoul(next(), nullptr, 10)); };
+		auto next_float = [&]() { return std::strtof(next(), nullptr); };
+
+		if (!std::strcmp(arg, "--seed"))					settings.seed = next_uint();
+		else if (!std::strcmp(arg, "--points"))				settings.point_count = std::max(next_uint(), 1u);
+		else if (!std::strcmp(arg, "--scale"))
+		{
+			settings.map_scale.x = next_float();
+			settings.map_scale.y = next_float();
+			settings.map_scale.z = next_float();
+		}
+		else if (!std::strcmp(arg, "--noise"))
+		{
+			const char* name = next();
+			if (!std::strcmp(name, "perlin"))				settings.noise = NOISE::Backend::PERLIN;
+			else if (!std::strcmp(name, "simplex"))			settings.noise = NOISE::Backend::SIMPLEX;
+			else if (!std::strcmp(name, "perlin-float"))	settings.noise = NOISE::Backend::PERLIN_FLOAT;
+			else if (ok)
+			{
+				std::cout << "Unknown noise " << name << "\n";
+				return false;
+			}
+		}
+		else if (!std::strcmp(arg, "--landform"))
+		{
+			const char* name = next();
+			if (!std::strcmp(name, "octaves"))				settings.landform = NOISE::Landform::OCTAVES;
+			else if (!std::strcmp(name, "alpine"))			settings.landform = NOISE::Landform::ALPINE;
+			else if (!std::strcmp(name, "mesas"))			settings.landform = NOISE::Landform::MESAS;
+			else if (!std::strcmp(name, "badlands"))		settings.landform = NOISE::Landform::BADLANDS;
+			else if (ok)
+			{
+				std::cout << "Unknown landform " << name << "\n";
+				return false;
+			}
+		}
+		else if (!std::strcmp(arg, "--cells"))
+		{
+			const char* name = next();
+			if (!std::strcmp(name, "none"))					settings.cells.feature = NOISE::CellFeature::NONE;
+			else if (!std::strcmp(name, "plateaus"))		settings.cells.feature = NOISE::CellFeature::PLATEAUS;
+			else if (!std::strcmp(name, "craters"))			settings.cells.feature = NOISE::CellFeature::CRATERS;
+			else if (!std::strcmp(name, "rocks"))			settings.cells.feature = NOISE::CellFeature::ROCKS;
+			else if (ok)
+			{
+				std::cout << "Unknown cell feature " << name << "\n";
+				return false;
+			}
+		}
+		else if (!std::strcmp(arg, "--cell-size"))			settings.cells.size = next_float();
+		else if (!std::strcmp(arg, "--cell-height"))		settings.cells.amount = next_float();
+		else if (!std::strcmp(arg, "--octaves"))			settings.perlin_oct = std::max(next_uint(), 1u);
+		else if (!std::strcmp(arg, "--persistance"))		settings.perlin_persistance = next_float();
+		else if (!std::strcmp(arg, "--frequency"))			settings.perlin_freq = next_float();
+		else if (!std::strcmp(arg, "--adaptive"))			settings.adaptive_density = true;
+		else if (!std::strcmp(arg, "--density-ratio"))		settings.density_ratio = next_float();
+		else if (!std::strcmp(arg, "--min-angle"))			settings.min_angle = next_float();
+		else if (!std::strcmp(arg, "--seed-boundary"))		settings.seed_boundary = true;
+		else if (!std::strcmp(arg, "--rock-slope"))			settings.rock_slope = next_float();
+		else if (!std::strcmp(arg, "--biomes"))				settings.biomes = true;
+		else if (!std::strcmp(arg, "--biome-size"))			settings.biome_size = next_float();
+		else if (!std::strcmp(arg, "--droplets"))			settings.hydraulic.droplets = next_uint();
+		else if (!std::strcmp(arg, "--thermal"))			settings.thermal.iterations = next_uint();
+		else if (!std::strcmp(arg, "--talus"))				settings.thermal.talus_angle = next_float();
+		else if (!std::strcmp(arg, "--erosion-resolution"))	settings.erosion_resolution = next_uint();
+		else if (!std::strcmp(arg, "--threads"))			UTILS::SetWorkerCount(next_uint());
+		else if (!std::strcmp(arg, "--export"))
+		{
+			const char* path = next();
+			EXPORT::Format format;
+			if (ok && !EXPORT::FormatFromPath(path, format))
+			{
+				std::cout << "Unknown export format " << path << "\n";
+				return false;
+			}
+			options.exports.emplace_back(path);
+		}
+		else if (!std::strcmp(arg, "--heightmap"))
+		{
+			const char* path = next();
+			EXPORT::HeightmapFormat format;
+			if (ok && !EXPORT::HeightmapFormatFromPath(path, format))
+			{
+				std::cout << "Unknown heightmap format " << path << "\n";
+				return false;
+			}
+			options.heightmaps.emplace_back(path);
+		}
+		else if (!std::strcmp(arg, "--heightmap-size"))
+		{
+			options.heightmap_size.x = static_cast<int>(std::max(next_uint(), 1u));
+			options.heightmap_size.y = static_cast<int>(std::max(next_uint(), 1u));
+		}
+		else
+		{
+			std::cout << "Unknown option " << arg << "\n";
+			return false;
+		}
+
+		if (!ok)
+		{
+			std::cout << "Missing value for " << arg << "\n";
+			return false;
+		}
+	}
+
+	return true;
+}
+
+int BAKE::Run(int argc, char** argv)
+{
+	Options options;
+	if (!ParseOptions(argc, argv, options))
+	{
+		PrintUsage();
+		return 1;
+	}
+	TerrainSettings const& settings = options.settings;
+
+	auto start = std::chrono::steady_clock::now();
+
+	Terrain terrain;
+	terrain.GeneratePoints(settings);
+
+	auto end = std::chrono::steady_clock::now();
+
+	float min_height = std::numeric_limits<float>::max();
+	float max_height = std::numeric_limits<float>::lowest();
+	for (auto const& v : terrain.GetSharedVtx())
+	{
+		min_height = CMIN(min_height, v.y);
+		max_height = CMAX(max_height, v.y);
+	}
+
+	std::cout << "Baked " << terrain.GetSharedVtx().size() << " vertices, " << terrain.GetMesh().TriangleCount() << " triangles, heights ["
+			  << min_height << ", " << max_height << "] in " << std::chrono::duration<double, std::milli>(end - start).count() << " ms\n";
+
+	for (std::string const& path : options.exports)
+	{
+		EXPORT::Format format{};
+		EXPORT::FormatFromPath(path, format);
+
+		start = std::chrono::steady_clock::now();
+		if (!EXPORT::Write(terrain, path, format))
+		{
+			std::cout << "Failed to write " << path << "\n";
+			return 1;
+		}
+		end = std::chrono::steady_clock::now();
+		std::cout << "Wrote " << path << " in " << std::chrono::duration<double, std::milli>(end - start).count() << " ms\n";
+	}
+
+	if (!options.heightmaps.empty())
+	{
+		start = std::chrono::steady_clock::now();
+		EXPORT::Heightmap heightmap;
+		EXPORT::RasteriseHeights(terrain, options.heightmap_size.x, options.heightmap_size.y, heightmap);
+		end = std::chrono::steady_clock::now();
+		std::cout << "Rasterised " << heightmap.width << "x" << heightmap.height << " heightmap in "
+				  << std::chrono::duration<double, std::milli>(end - start).count() << " ms\n";
+
+		for (std::string const& path : options.heightmaps)
+		{
+			EXPORT::HeightmapFormat format{};
+			EXPORT::HeightmapFormatFromPath(path, format);
+
+			start = std::chrono::steady_clock::now();
+			if (!EXPORT::WriteHeightmap(heightmap, path, format))
+			{
+				std::cout << "Failed to write " << path << "\n";
+				return 1;
+			}
+			end = std::chrono::steady_clock::now();
+			std::cout << "Wrote " << path << " in " << std::chrono::duration<double, std::milli>(end - start).count() << " ms\n";
+		}
+	}
+	return 0;
+}
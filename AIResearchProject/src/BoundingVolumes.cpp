@@ -0,0 +1,596 @@
+#include "BoundingVolumes.h"
+#include "CustomMath.h"
+#include "SIMD.h"
+
+#include <cmath>
+#include <limits>
+
+namespace
+{
+	using FN = SIMD::FN;
+	constexpr int W = FN::WIDTH;
+
+	// Points per reduction block; lane-local indices stay below 2^24 so they are exact as floats
+	constexpr size_t BLOCK_SIZE = 1 << 14;
+
+	struct Transform
+	{
+		FN m[4][3];
+		glm::mat4 mtx;
+
+		explicit Transform(glm::mat4 const& t) : mtx(t)
+		{
+			for (int c{}; c < 4; ++c)
+				for (int r{}; r < 3; ++r)
+					m[c][r] = FN::Set1(t[c][r]);
+		}
+
+		glm::vec3 Apply(glm::vec3 const& p) const { return glm::vec3(mtx * glm::vec4(p, 1.f)); }
+
+		// Transforms W consecutive points into SoA lanes
+		void Apply(const glm::vec3* p, FN& x, FN& y, FN& z) const
+		{
+			alignas(32) float lx[W], ly[W], lz[W];
+			for (int k{}; k < W; ++k)
+			{
+				lx[k] = p[k].x;
+				ly[k] = p[k].y;
+				lz[k] = p[k].z;
+			}
+
+			FN px = FN::Load(lx), py = FN::Load(ly), pz = FN::Load(lz);
+			x = m[0][0] * px + m[1][0] * py + m[2][0] * pz + m[3][0];
+			y = m[0][1] * px + m[1][1] * py + m[2][1] * pz + m[3][1];
+			z = m[0][2] * px + m[1][2] * py + m[2][2] * pz + m[3][2];
+		}
+	};
+
+	// Lane-wise arg-min, arg-max is tracked as the arg-min of the negated value
+	struct LaneArgMin
+	{
+		FN value = FN::Set1(std::numeric_limits<float>::max());
+		FN index = FN::Zero();
+
+		void Update(FN v, FN idx)
+		{
+			FN better = v < value;
+			value = SIMD::Select(better, v, value);
+			index = SIMD::Select(better, idx, index);
+		}
+
+		// Lowest value across lanes, ties go to the lowest index
+		void Reduce(float& best, unsigned int& best_idx, unsigned int base) const
+		{
+			alignas(32) float v[W], i[W];
+			value.Store(v);
+			index.Store(i);
+			for (int k{}; k < W; ++k)
+			{
+				unsigned int idx = base + static_cast<unsigned int>(i[k]);
+				if (v[k] < best || (v[k] == best && idx < best_idx))
+				{
+					best = v[k];
+					best_idx = idx;
+				}
+			}
+		}
+	};
+
+	struct ArgResult
+	{
+		float value{ std::numeric_limits<float>::max() };
+		unsigned int index{};
+
+		void Update(float v, unsigned int idx)
+		{
+			if (v < value || (v == value && idx < index))
+			{
+				value = v;
+				index = idx;
+			}
+		}
+	};
+
+	// Runs kernel(block_begin, block_end, result) for every block in parallel, results are left in block order
+	template <typename R, typename F>
+	std::vector<R> ForEachBlock(size_t count, F&& kernel)
+	{
+		size_t blocks = (count + BLOCK_SIZE - 1) / BLOCK_SIZE;
+		std::vector<R> results(blocks);
+
+		UTILS::ParallelFor(blocks, 1, [&](size_t begin, size_t end)
+		{
+			for (size_t b = begin; b < end; ++b)
+			{
+				size_t first = b * BLOCK_SIZE;
+				size_t last = first + BLOCK_SIZE < count ? first + BLOCK_SIZE : count;
+				kernel(first, last, results[b]);
+			}
+		});
+
+		return results;
+	}
+
+	FN LaneOffsets()
+	{
+		alignas(32) float offsets[W];
+		for (int k{}; k < W; ++k)
+			offsets[k] = static_cast<float>(k);
+		return FN::Load(offsets);
+	}
+
+	// Returns index of the point with the lowest score(x, y, z) and of the highest
+	template <typename Score, typename ScalarScore>
+	void ArgMinMax(BOUNDS::Points points, Transform const& xf, Score score, ScalarScore scalar_score, unsigned int& imin, unsigned int& imax)
+	{
+		struct Partial { ArgResult lo, hi; };
+
+		std::vector<Partial> partials = ForEachBlock<Partial>(points.size, [&](size_t first, size_t last, Partial& out)
+		{
+			LaneArgMin lo, hi;
+			FN idx = LaneOffsets();
+			const FN step = FN::Set1(static_cast<float>(W));
+
+			size_t i = first;
+			for (; i + W <= last; i += W, idx = idx + step)
+			{
+				FN x, y, z;
+				xf.Apply(&points[i], x, y, z);
+				FN s = score(x, y, z);
+				lo.Update(s, idx);
+				hi.Update(FN::Zero() - s, idx);
+			}
+
+			unsigned int base = static_cast<unsigned int>(first);
+			lo.Reduce(out.lo.value, out.lo.index, base);
+			hi.Reduce(out.hi.value, out.hi.index, base);
+
+			for (; i < last; ++i)
+			{
+				float s = scalar_score(xf.Apply(points[i]));
+				out.lo.Update(s, static_cast<unsigned int>(i));
+				out.hi.Update(-s, static_cast<unsigned int>(i));
+			}
+		});
+
+		ArgResult lo, hi;
+		for (auto const& p : partials)
+		{
+			lo.Update(p.lo.value, p.lo.index);
+			hi.Update(p.hi.value, p.hi.index);
+		}
+
+		imin = lo.index;
+		imax = hi.index;
+	}
+
+	BoundingSphere SphereFromDiameter(glm::vec3 const& a, glm::vec3 const& b)
+	{
+		return BoundingSphere{ Point3D((a + b) * 0.5f), glm::length(b - a) * 0.5f };
+	}
+}
+
+BOUNDS::Extremes BOUNDS::ComputeExtremes(Points points, glm::mat4 const& transform)
+{
+	Extremes result;
+	if (points.empty())
+		return result;
+
+	Transform xf(transform);
+
+	struct Partial { ArgResult lo[3], hi[3]; };
+
+	std::vector<Partial> partials = ForEachBlock<Partial>(points.size, [&](size_t first, size_t last, Partial& out)
+	{
+		LaneArgMin lo[3], hi[3];
+		FN idx = LaneOffsets();
+		const FN step = FN::Set1(static_cast<float>(W));
+		const FN zero = FN::Zero();
+
+		size_t i = first;
+		for (; i + W <= last; i += W, idx = idx + step)
+		{
+			FN p[3];
+			xf.Apply(&points[i], p[0], p[1], p[2]);
+			for (int a{}; a < 3; ++a)
+			{
+				lo[a].Update(p[a], idx);
+				hi[a].Update(zero - p[a], idx);
+			}
+		}
+
+		unsigned int base = static_cast<unsigned int>(first);
+		for (int a{}; a < 3; ++a)
+		{
+			lo[a].Reduce(out.lo[a].value, out.lo[a].index, base);
+			hi[a].Reduce(out.hi[a].value, out.hi[a].index, base);
+		}
+
+		for (; i < last; ++i)
+		{
+			glm::vec3 p = xf.Apply(points[i]);
+			for (int a{}; a < 3; ++a)
+			{
+				out.lo[a].Update(p[a], static_cast<unsigned int>(i));
+				out.hi[a].Update(-p[a], static_cast<unsigned int>(i));
+			}
+		}
+	});
+
+	for (int a{}; a < 3; ++a)
+	{
+		ArgResult lo, hi;
+		for (auto const& p : partials)
+		{
+			lo.Update(p.lo[a].value, p.lo[a].index);
+			hi.Update(p.hi[a].value, p.hi[a].index);
+		}
+
+		result.min[a] = lo.value;
+		result.max[a] = -hi.value;
+		result.min_idx[a] = lo.index;
+		result.max_idx[a] = hi.index;
+	}
+
+	return result;
+}
+
+AABB BOUNDS::ComputeAABB(Points points, glm::mat4 const& transform)
+{
+	AABB aabb;
+	if (points.empty())
+		return aabb;
+
+	Transform xf(transform);
+
+	struct Partial { glm::vec3 min, max; };
+
+	std::vector<Partial> partials = ForEachBlock<Partial>(points.size, [&](size_t first, size_t last, Partial& out)
+	{
+		const FN lowest = FN::Set1(std::numeric_limits<float>::lowest());
+		const FN highest = FN::Set1(std::numeric_limits<float>::max());
+		FN min_x = highest, min_y = highest, min_z = highest;
+		FN max_x = lowest, max_y = lowest, max_z = lowest;
+
+		size_t i = first;
+		for (; i + W <= last; i += W)
+		{
+			FN x, y, z;
+			xf.Apply(&points[i], x, y, z);
+			min_x = SIMD::Min(min_x, x); max_x = SIMD::Max(max_x, x);
+			min_y = SIMD::Min(min_y, y); max_y = SIMD::Max(max_y, y);
+			min_z = SIMD::Min(min_z, z); max_z = SIMD::Max(max_z, z);
+		}
+
+		out.min = glm::vec3(SIMD::ReduceMin(min_x), SIMD::ReduceMin(min_y), SIMD::ReduceMin(min_z));
+		out.max = glm::vec3(SIMD::ReduceMax(max_x), SIMD::ReduceMax(max_y), SIMD::ReduceMax(max_z));
+
+		for (; i < last; ++i)
+		{
+			glm::vec3 p = xf.Apply(points[i]);
+			out.min = glm::min(out.min, p);
+			out.max = glm::max(out.max, p);
+		}
+	});
+
+	glm::vec3 min_p{ std::numeric_limits<float>::max() };
+	glm::vec3 max_p{ std::numeric_limits<float>::lowest() };
+	for (auto const& p : partials)
+	{
+		min_p = glm::min(min_p, p.min);
+		max_p = glm::max(max_p, p.max);
+	}
+
+	aabb.center = (min_p + max_p) * 0.5f;
+	aabb.half_extent = (max_p - min_p) * 0.5f;
+	return aabb;
+}
+
+unsigned int BOUNDS::FarthestPoint(Points points, glm::mat4 const& transform, glm::vec3 const& from)
+{
+	if (points.empty())
+		return 0;
+
+	const FN fx = FN::Set1(from.x), fy = FN::Set1(from.y), fz = FN::Set1(from.z);
+	unsigned int imin, imax;
+
+	ArgMinMax(points, Transform(transform),
+		[&](FN x, FN y, FN z) { FN dx = x - fx, dy = y - fy, dz = z - fz; return dx * dx + dy * dy + dz * dz; },
+		[&](glm::vec3 const& p) { glm::vec3 d = p - from; return glm::dot(d, d); },
+		imin, imax);
+
+	return imax;
+}
+
+void BOUNDS::ExtremalPoints(Points points, glm::mat4 const& transform, glm::vec3 const& dir, unsigned int& imin, unsigned int& imax)
+{
+	imin = imax = 0;
+	if (points.empty())
+		return;
+
+	const FN dx = FN::Set1(dir.x), dy = FN::Set1(dir.y), dz = FN::Set1(dir.z);
+
+	ArgMinMax(points, Transform(transform),
+		[&](FN x, FN y, FN z) { return x * dx + y * dy + z * dz; },
+		[&](glm::vec3 const& p) { return glm::dot(p, dir); },
+		imin, imax);
+}
+
+BoundingSphere BOUNDS::GrowSphere(Points points, glm::mat4 const& transform, BoundingSphere sphere)
+{
+	Transform xf(transform);
+	glm::vec3 center = sphere.position.p;
+	float radius = sphere.radius;
+
+	// Each growth step depends on the previous one, so this pass stays sequential;
+	// SIMD only filters out the (vast majority of) points already inside
+	size_t i{};
+	for (; i + W <= points.size; i += W)
+	{
+		FN x, y, z;
+		xf.Apply(&points[i], x, y, z);
+
+		FN dx = x - FN::Set1(center.x), dy = y - FN::Set1(center.y), dz = z - FN::Set1(center.z);
+		int outside = SIMD::Mask(dx * dx + dy * dy + dz * dz > FN::Set1(radius * radius));
+		if (!outside)
+			continue;
+
+		for (int k{}; k < W; ++k)
+		{
+			if (!(outside & (1 << k)))
+				continue;
+
+			glm::vec3 p = xf.Apply(points[i + k]);
+			float dist_sq = CMATH::DistanceSquared(center, p);
+			if (dist_sq <= radius * radius)
+				continue;
+
+			float dist = std::sqrt(dist_sq);
+			float new_radius = (radius + dist) * 0.5f;
+			center += (p - center) * ((new_radius - radius) / dist);
+			radius = new_radius;
+		}
+	}
+
+	for (; i < points.size; ++i)
+	{
+		glm::vec3 p = xf.Apply(points[i]);
+		float dist_sq = CMATH::DistanceSquared(center, p);
+		if (dist_sq <= radius * radius)
+			continue;
+
+		float dist = std::sqrt(dist_sq);
+		float new_radius = (radius + dist) * 0.5f;
+		center += (p - center) * ((new_radius - radius) / dist);
+		radius = new_radius;
+	}
+
+	return BoundingSphere{ Point3D(center), radius };
+}
+
+BoundingSphere BOUNDS::Ritters(Points points, glm::mat4 const& transform)
+{
+	if (points.empty())
+		return BoundingSphere{};
+
+	Transform xf(transform);
+	glm::vec3 a = xf.Apply(points[0]);
+	glm::vec3 b = xf.Apply(points[FarthestPoint(points, transform, a)]);
+	glm::vec3 c = xf.Apply(points[FarthestPoint(points, transform, b)]);
+
+	return GrowSphere(points, transform, SphereFromDiameter(b, c));
+}
+
+BoundingSphere BOUNDS::Larsons(Points points, glm::mat4 const& transform)
+{
+	if (points.size < 2)
+		return BoundingSphere{};
+
+	Transform xf(transform);
+	Extremes ext = ComputeExtremes(points, transform);
+
+	glm::vec3 candidates[6];
+	for (int a{}; a < 3; ++a)
+	{
+		candidates[a * 2] = xf.Apply(points[ext.min_idx[a]]);
+		candidates[a * 2 + 1] = xf.Apply(points[ext.max_idx[a]]);
+	}
+
+	glm::vec3 far_a = candidates[0], far_b = candidates[1];
+	float max_dist_sq = -1.f;
+	for (int i{}; i < 6; ++i)
+	{
+		for (int j{ i + 1 }; j < 6; ++j)
+		{
+			float dist_sq = CMATH::DistanceSquared(candidates[i], candidates[j]);
+			if (dist_sq > max_dist_sq)
+			{
+				max_dist_sq = dist_sq;
+				far_a = candidates[i];
+				far_b = candidates[j];
+			}
+		}
+	}
+
+	return GrowSphere(points, transform, SphereFromDiameter(far_a, far_b));
+}
+
+BoundingSphere BOUNDS::PCASphere(Points points, glm::mat4 const& transform, PCAResult* pca)
+{
+	if (points.empty())
+		return BoundingSphere{};
+
+	PCAResult result = ComputePCA(points, transform);
+	if (pca)
+		*pca = result;
+
+	unsigned int imin, imax;
+	ExtremalPoints(points, transform, result.eigenvectors[0], imin, imax);
+
+	Transform xf(transform);
+	return GrowSphere(points, transform, SphereFromDiameter(xf.Apply(points[imin]), xf.Apply(points[imax])));
+}
+
+BOUNDS::PCAResult BOUNDS::ComputePCA(Points points, glm::mat4 const& transform)
+{
+	PCAResult result;
+	if (points.empty())
+		return result;
+
+	Transform xf(transform);
+
+	// Sums are taken relative to the first point to keep float accumulation well conditioned
+	const glm::vec3 shift = xf.Apply(points[0]);
+
+	struct Partial { double s[3]{}, ss[6]{}; };
+
+	std::vector<Partial> partials = ForEachBlock<Partial>(points.size, [&](size_t first, size_t last, Partial& out)
+	{
+		const FN cx = FN::Set1(shift.x), cy = FN::Set1(shift.y), cz = FN::Set1(shift.z);
+		FN sx = FN::Zero(), sy = FN::Zero(), sz = FN::Zero();
+		FN sxx = FN::Zero(), syy = FN::Zero(), szz = FN::Zero();
+		FN sxy = FN::Zero(), sxz = FN::Zero(), syz = FN::Zero();
+
+		size_t i = first;
+		for (; i + W <= last; i += W)
+		{
+			FN x, y, z;
+			xf.Apply(&points[i], x, y, z);
+			x = x - cx; y = y - cy; z = z - cz;
+
+			sx = sx + x; sy = sy + y; sz = sz + z;
+			sxx = sxx + x * x; syy = syy + y * y; szz = szz + z * z;
+			sxy = sxy + x * y; sxz = sxz + x * z; syz = syz + y * z;
+		}
+
+		FN lanes[9] = { sx, sy, sz, sxx, syy, szz, sxy, sxz, syz };
+		double totals[9]{};
+		for (int s{}; s < 9; ++s)
+		{
+			alignas(32) float v[W];
+			lanes[s].Store(v);
+			for (int k{}; k < W; ++k)
+				totals[s] += v[k];
+		}
+
+		for (; i < last; ++i)
+		{
+			glm::vec3 p = xf.Apply(points[i]) - shift;
+			totals[0] += p.x; totals[1] += p.y; totals[2] += p.z;
+			totals[3] += p.x * p.x; totals[4] += p.y * p.y; totals[5] += p.z * p.z;
+			totals[6] += p.x * p.y; totals[7] += p.x * p.z; totals[8] += p.y * p.z;
+		}
+
+		for (int s{}; s < 3; ++s)
+			out.s[s] = totals[s];
+		for (int s{}; s < 6; ++s)
+			out.ss[s] = totals[s + 3];
+	});
+
+	double s[3]{}, ss[6]{};
+	for (auto const& p : partials)
+	{
+		for (int k{}; k < 3; ++k) s[k] += p.s[k];
+		for (int k{}; k < 6; ++k) ss[k] += p.ss[k];
+	}
+
+	double oon = 1.0 / static_cast<double>(points.size);
+	double m[3] = { s[0] * oon, s[1] * oon, s[2] * oon };
+
+	result.mean = shift + glm::vec3(static_cast<float>(m[0]), static_cast<float>(m[1]), static_cast<float>(m[2]));
+
+	glm::mat3& c = result.covariance;
+	c[0][0] = static_cast<float>(ss[0] * oon - m[0] * m[0]);
+	c[1][1] = static_cast<float>(ss[1] * oon - m[1] * m[1]);
+	c[2][2] = static_cast<float>(ss[2] * oon - m[2] * m[2]);
+	c[0][1] = c[1][0] = static_cast<float>(ss[3] * oon - m[0] * m[1]);
+	c[0][2] = c[2][0] = static_cast<float>(ss[4] * oon - m[0] * m[2]);
+	c[1][2] = c[2][1] = static_cast<float>(ss[5] * oon - m[1] * m[2]);
+
+	SymmetricEigen(result.covariance, result.eigenvectors, result.eigenvalues);
+	return result;
+}
+
+void BOUNDS::SymmetricEigen(glm::mat3 const& a, glm::mat3& eigenvectors, glm::vec3& eigenvalues)
+{
+	// Eigenvalues from the trigonometric solution of the characteristic cubic
+	double a00 = a[0][0], a11 = a[1][1], a22 = a[2][2];
+	double a01 = a[0][1], a02 = a[0][2], a12 = a[1][2];
+
+	double off = a01 * a01 + a02 * a02 + a12 * a12;
+	double q = (a00 + a11 + a22) / 3.0;
+	double b00 = a00 - q, b11 = a11 - q, b22 = a22 - q;
+	double p = std::sqrt((b00 * b00 + b11 * b11 + b22 * b22 + 2.0 * off) / 6.0);
+
+	double scale = std::fabs(q) + p;
+	if (p <= 1e-12 * (scale > 0.0 ? scale : 1.0))
+	{
+		// Multiple of the identity, any basis works
+		eigenvectors = glm::mat3(1.f);
+		eigenvalues = glm::vec3(static_cast<float>(q));
+		return;
+	}
+
+	double det = b00 * (b11 * b22 - a12 * a12) - a01 * (a01 * b22 - a12 * a02) + a02 * (a01 * a12 - b11 * a02);
+	double r = det / (2.0 * p * p * p);
+	r = r < -1.0 ? -1.0 : (r > 1.0 ? 1.0 : r);
+
+	double phi = std::acos(r) / 3.0;
+	double l0 = q + 2.0 * p * std::cos(phi);
+	double l2 = q + 2.0 * p * std::cos(phi + 2.0 * M_PI / 3.0);
+	double l1 = 3.0 * q - l0 - l2;
+
+	// Eigenvector of an isolated eigenvalue is the largest cross product of two rows of (A - lI)
+	auto eigenvector = [&](double l) -> glm::dvec3
+	{
+		glm::dvec3 r0(a00 - l, a01, a02);
+		glm::dvec3 r1(a01, a11 - l, a12);
+		glm::dvec3 r2(a02, a12, a22 - l);
+
+		glm::dvec3 c0 = glm::cross(r0, r1);
+		glm::dvec3 c1 = glm::cross(r0, r2);
+		glm::dvec3 c2 = glm::cross(r1, r2);
+		double d0 = glm::dot(c0, c0), d1 = glm::dot(c1, c1), d2 = glm::dot(c2, c2);
+
+		glm::dvec3 best = c0;
+		double best_d = d0;
+		if (d1 > best_d) best = c1, best_d = d1;
+		if (d2 > best_d) best = c2, best_d = d2;
+		return best_d > 0.0 ? best / std::sqrt(best_d) : glm::dvec3(0.0);
+	};
+
+	// Any unit vector orthogonal to v
+	auto orthogonal = [](glm::dvec3 const& v) -> glm::dvec3
+	{
+		glm::dvec3 o = std::fabs(v.x) > std::fabs(v.z) ? glm::dvec3(-v.y, v.x, 0.0) : glm::dvec3(0.0, -v.z, v.y);
+		return glm::normalize(o);
+	};
+
+	// Start from whichever end eigenvalue is best separated, then build the rest orthogonal to it
+	glm::dvec3 v0, v1, v2;
+	if (l0 - l1 >= l1 - l2)
+	{
+		v0 = eigenvector(l0);
+		if (glm::dot(v0, v0) == 0.0) v0 = glm::dvec3(1.0, 0.0, 0.0);
+
+		v1 = eigenvector(l1);
+		v1 -= v0 * glm::dot(v0, v1);
+		double len = glm::length(v1);
+		v1 = len > 1e-6 ? v1 / len : orthogonal(v0);
+		v2 = glm::cross(v0, v1);
+	}
+	else
+	{
+		v2 = eigenvector(l2);
+		if (glm::dot(v2, v2) == 0.0) v2 = glm::dvec3(0.0, 0.0, 1.0);
+
+		v1 = eigenvector(l1);
+		v1 -= v2 * glm::dot(v2, v1);
+		double len = glm::length(v1);
+		v1 = len > 1e-6 ? v1 / len : orthogonal(v2);
+		v0 = glm::cross(v1, v2);
+	}
+
+	eigenvectors = glm::mat3(glm::vec3(v0), glm::vec3(v1), glm::vec3(v2));
+	eigenvalues = glm::vec3(static_cast<float>(l0), static_cast<float>(l1), static_cast<float>(l2));
+}
@@ -0,0 +1,424 @@
+#include "CollisionWorld.h"
+
+#include "CustomMath.h"
+#include "SIMD.h"
+
+namespace
+{
+	/*
+	* SCALAR KERNELS
+	*/
+	inline bool SphereSphere(float x1, float y1, float z1, float r1, float x2, float y2, float z2, float r2)
+	{
+		float dx = x2 - x1;
+		float dy = y2 - y1;
+		float dz = z2 - z1;
+		float r = r1 + r2;
+		return dx * dx + dy * dy + dz * dz <= r * r;
+	}
+
+	inline bool AABBAABB(AABBPool const& pool, size_t i, glm::vec3 const& min_p, glm::vec3 const& max_p)
+	{
+		return pool.min_x[i] <= max_p.x && pool.max_x[i] >= min_p.x &&
+			pool.min_y[i] <= max_p.y && pool.max_y[i] >= min_p.y &&
+			pool.min_z[i] <= max_p.z && pool.max_z[i] >= min_p.z;
+	}
+
+	inline bool RayAABB(AABBPool const& pool, size_t i, glm::vec3 const& origin, glm::vec3 const& inv_dir)
+	{
+		float tx1 = (pool.min_x[i] - origin.x) * inv_dir.x;
+		float tx2 = (pool.max_x[i] - origin.x) * inv_dir.x;
+		float ty1 = (pool.min_y[i] - origin.y) * inv_dir.y;
+		float ty2 = (pool.max_y[i] - origin.y) * inv_dir.y;
+		float tz1 = (pool.min_z[i] - origin.z) * inv_dir.z;
+		float tz2 = (pool.max_z[i] - origin.z) * inv_dir.z;
+
+		float t_near = glm::max(glm::max(glm::min(tx1, tx2), glm::min(ty1, ty2)), glm::min(tz1, tz2));
+		float t_far = glm::min(glm::min(glm::max(tx1, tx2), glm::max(ty1, ty2)), glm::max(tz1, tz2));
+
+		return t_near <= t_far && t_far > 0.f;
+	}
+
+	/*
+	* SIMD KERNELS
+	*/
+	template <typename V>
+	size_t SphereSphereLanes(SpherePool const& pool, BoundingSphere const& s, size_t begin, size_t end, unsigned char* hits)
+	{
+		const V sx = V::Set1(s.position.p.x);
+		const V sy = V::Set1(s.position.p.y);
+		const V sz = V::Set1(s.position.p.z);
+		const V sr = V::Set1(s.radius);
+
+		size_t i = begin;
+		for (; i + V::WIDTH <= end; i += V::WIDTH)
+		{
+			V dx = V::Load(&pool.x[i]) - sx;
+			V dy = V::Load(&pool.y[i]) - sy;
+			V dz = V::Load(&pool.z[i]) - sz;
+			V r = V::Load(&pool.r[i]) + sr;
+
+			int mask = SIMD::Mask(dx * dx + dy * dy + dz * dz <= r * r);
+			for (int k{}; k < V::WIDTH; ++k)
+				hits[i - begin + k] = static_cast<unsigned char>((mask >> k) & 1);
+		}
+		return i;
+	}
+
+	template <typename V>
+	size_t AABBAABBLanes(AABBPool const& pool, glm::vec3 const& min_p, glm::vec3 const& max_p, size_t begin, size_t end, unsigned char* hits)
+	{
+		const V bmin_x = V::Set1(min_p.x), bmin_y = V::Set1(min_p.y), bmin_z = V::Set1(min_p.z);
+		const V bmax_x = V::Set1(max_p.x), bmax_y = V::Set1(max_p.y), bmax_z = V::Set1(max_p.z);
+
+		size_t i = begin;
+		for (; i + V::WIDTH <= end; i += V::WIDTH)
+		{
+			V overlap = (V::Load(&pool.min_x[i]) <= bmax_x) & (V::Load(&pool.max_x[i]) >= bmin_x);
+			overlap = overlap & (V::Load(&pool.min_y[i]) <= bmax_y) & (V::Load(&pool.max_y[i]) >= bmin_y);
+			overlap = overlap & (V::Load(&pool.min_z[i]) <= bmax_z) & (V::Load(&pool.max_z[i]) >= bmin_z);
+
+			int mask = SIMD::Mask(overlap);
+			for (int k{}; k < V::WIDTH; ++k)
+				hits[i - begin + k] = static_cast<unsigned char>((mask >> k) & 1);
+		}
+		return i;
+	}
+
+	template <typename V>
+	size_t RayAABBLanes(AABBPool const& pool, glm::vec3 const& origin, glm::vec3 const& inv_dir, size_t begin, size_t end, unsigned char* hits)
+	{
+		const V ox = V::Set1(origin.x), oy = V::Set1(origin.y), oz = V::Set1(origin.z);
+		const V ix = V::Set1(inv_dir.x), iy = V::Set1(inv_dir.y), iz = V::Set1(inv_dir.z);
+		const V zero = V::Zero();
+
+		size_t i = begin;
+		for (; i + V::WIDTH <= end; i += V::WIDTH)
+		{
+			V tx1 = (V::Load(&pool.min_x[i]) - ox) * ix;
+			V tx2 = (V::Load(&pool.max_x[i]) - ox) * ix;
+			V ty1 = (V::Load(&pool.min_y[i]) - oy) * iy;
+			V ty2 = (V::Load(&pool.max_y[i]) - oy) * iy;
+			V tz1 = (V::Load(&pool.min_z[i]) - oz) * iz;
+			V tz2 = (V::Load(&pool.max_z[i]) - oz) * iz;
+
+			V t_near = SIMD::Max(SIMD::Max(SIMD::Min(tx1, tx2), SIMD::Min(ty1, ty2)), SIMD::Min(tz1, tz2));
+			V t_far = SIMD::Min(SIMD::Min(SIMD::Max(tx1, tx2), SIMD::Max(ty1, ty2)), SIMD::Max(tz1, tz2));
+
+			int mask = SIMD::Mask((t_near <= t_far) & (t_far > zero));
+			for (int k{}; k < V::WIDTH; ++k)
+				hits[i - begin + k] = static_cast<unsigned char>((mask >> k) & 1);
+		}
+		return i;
+	}
+
+	/*
+	* DISPATCH TABLE ENTRIES
+	* Each returns whether the pair touches. The plane tests classify the other primitive against the plane, only
+	* COPLANAR (straddling) is a hit; the classification goes to result. Everything else leaves 1.
+	*/
+	inline bool Hit(bool hit, int& result)							{ result = 1; return hit; }
+	inline bool PlaneHit(int side, int& result)						{ result = side; return side == COPLANAR; }
+
+	bool PointPlane(CollisionWorld const& w, unsigned int a, unsigned int b, int& result)		{ return PlaneHit(TESTS::PointPlane(w.GetPoint(a), w.GetPlane(b)), result); }
+	bool PointTriangle(CollisionWorld const& w, unsigned int a, unsigned int b, int& result)	{ return Hit(TESTS::PointTriangle(w.GetPoint(a), w.GetTriangle(b)), result); }
+	bool PointSphere(CollisionWorld const& w, unsigned int a, unsigned int b, int& result)		{ return Hit(TESTS::PointSphere(w.GetPoint(a), w.GetSphere(b)), result); }
+	bool PointAABB(CollisionWorld const& w, unsigned int a, unsigned int b, int& result)		{ return Hit(TESTS::PointAABB(w.GetPoint(a), w.GetAABB(b)), result); }
+	bool PlaneSphere(CollisionWorld const& w, unsigned int a, unsigned int b, int& result)		{ return PlaneHit(TESTS::PlaneSphere(w.GetPlane(a), w.GetSphere(b)), result); }
+	bool PlaneAABB(CollisionWorld const& w, unsigned int a, unsigned int b, int& result)		{ return PlaneHit(TESTS::PlaneAABB(w.GetPlane(a), w.GetAABB(b)), result); }
+	bool SphereAABB(CollisionWorld const& w, unsigned int a, unsigned int b, int& result)		{ return Hit(TESTS::SphereAABB(w.GetSphere(a), w.GetAABB(b)), result); }
+	bool RayPlane(CollisionWorld const& w, unsigned int a, unsigned int b, int& result)		{ return Hit(TESTS::RayPlane(w.GetRay(a), w.GetPlane(b)), result); }
+	bool RayTriangle(CollisionWorld const& w, unsigned int a, unsigned int b, int& result)		{ return Hit(TESTS::RayTriangle(w.GetRay(a), w.GetTriangle(b)), result); }
+	bool RaySphere(CollisionWorld const& w, unsigned int a, unsigned int b, int& result)		{ return Hit(TESTS::RaySphere(w.GetRay(a), w.GetSphere(b)), result); }
+
+	bool SphereSphereEntry(CollisionWorld const& w, unsigned int a, unsigned int b, int& result)
+	{
+		SpherePool const& s = w.GetSpheres();
+		return Hit(SphereSphere(s.x[a], s.y[a], s.z[a], s.r[a], s.x[b], s.y[b], s.z[b], s.r[b]), result);
+	}
+
+	bool AABBAABBEntry(CollisionWorld const& w, unsigned int a, unsigned int b, int& result)
+	{
+		AABBPool const& pool = w.GetAABBs();
+		glm::vec3 min_p(pool.min_x[b], pool.min_y[b], pool.min_z[b]);
+		glm::vec3 max_p(pool.max_x[b], pool.max_y[b], pool.max_z[b]);
+		return Hit(AABBAABB(pool, a, min_p, max_p), result);
+	}
+
+	bool RayAABBEntry(CollisionWorld const& w, unsigned int a, unsigned int b, int& result)
+	{
+		Ray ray = w.GetRay(a);
+		return Hit(RayAABB(w.GetAABBs(), b, ray.origin.p, 1.f / ray.direction.p), result);
+	}
+
+	template <CollisionWorld::PairTest F>
+	bool Swapped(CollisionWorld const& w, unsigned int a, unsigned int b, int& result)
+	{
+		return F(w, b, a, result);
+	}
+}
+
+const CollisionWorld::PairTest CollisionWorld::s_dispatch[P_COUNT][P_COUNT] =
+{
+	/*				POINT							PLANE						TRIANGLE					SPHERE						AABB						RAY */
+	/* POINT */		{ nullptr,						PointPlane,					PointTriangle,				PointSphere,				PointAABB,					nullptr },
+	/* PLANE */		{ Swapped<PointPlane>,			nullptr,					nullptr,					PlaneSphere,				PlaneAABB,					Swapped<RayPlane> },
+	/* TRIANGLE */	{ Swapped<PointTriangle>,		nullptr,					nullptr,					nullptr,					nullptr,					Swapped<RayTriangle> },
+	/* SPHERE */	{ Swapped<PointSphere>,			Swapped<PlaneSphere>,		nullptr,					SphereSphereEntry,			SphereAABB,					Swapped<RaySphere> },
+	/* AABB */		{ Swapped<PointAABB>,			Swapped<PlaneAABB>,			nullptr,					Swapped<SphereAABB>,		AABBAABBEntry,				Swapped<RayAABBEntry> },
+	/* RAY */		{ nullptr,						RayPlane,					RayTriangle,				RaySphere,					RayAABBEntry,				nullptr }
+};
+
+void CollisionWorld::Clear()
+{
+	m_points.Clear();
+	m_planes.Clear();
+	m_triangles.Clear();
+	m_spheres.Clear();
+	m_aabbs.Clear();
+	m_rays.Clear();
+	m_contacts.clear();
+}
+
+ColliderHandle CollisionWorld::AddPoint(glm::vec3 const& point, unsigned int owner)
+{
+	m_points.x.push_back(point.x);
+	m_points.y.push_back(point.y);
+	m_points.z.push_back(point.z);
+	m_points.owner.push_back(owner);
+	return ColliderHandle{ P_POINT, static_cast<unsigned int>(m_points.Size() - 1) };
+}
+
+ColliderHandle CollisionWorld::AddPlane(Plane const& plane, unsigned int owner)
+{
+	m_planes.nx.push_back(plane.normal.x);
+	m_planes.ny.push_back(plane.normal.y);
+	m_planes.nz.push_back(plane.normal.z);
+	m_planes.d.push_back(plane.normal.w);
+	m_planes.owner.push_back(owner);
+	return ColliderHandle{ P_PLANE, static_cast<unsigned int>(m_planes.Size() - 1) };
+}
+
+ColliderHandle CollisionWorld::AddTriangle(Triangle const& triangle, unsigned int owner)
+{
+	m_triangles.ax.push_back(triangle.p1.p.x);
+	m_triangles.ay.push_back(triangle.p1.p.y);
+	m_triangles.az.push_back(triangle.p1.p.z);
+	m_triangles.bx.push_back(triangle.p2.p.x);
+	m_triangles.by.push_back(triangle.p2.p.y);
+	m_triangles.bz.push_back(triangle.p2.p.z);
+	m_triangles.cx.push_back(triangle.p3.p.x);
+	m_triangles.cy.push_back(triangle.p3.p.y);
+	m_triangles.cz.push_back(triangle.p3.p.z);
+	m_triangles.owner.push_back(owner);
+	return ColliderHandle{ P_TRIANGLE, static_cast<unsigned int>(m_triangles.Size() - 1) };
+}
+
+ColliderHandle CollisionWorld::AddSphere(BoundingSphere const& sphere, unsigned int owner)
+{
+	m_spheres.x.push_back(sphere.position.p.x);
+	m_spheres.y.push_back(sphere.position.p.y);
+	m_spheres.z.push_back(sphere.position.p.z);
+	m_spheres.r.push_back(sphere.radius);
+	m_spheres.owner.push_back(owner);
+	return ColliderHandle{ P_SPHERE, static_cast<unsigned int>(m_spheres.Size() - 1) };
+}
+
+ColliderHandle CollisionWorld::AddAABB(AABB const& aabb, unsigned int owner)
+{
+	glm::vec3 min_p = aabb.center.p - aabb.half_extent.p;
+	glm::vec3 max_p = aabb.center.p + aabb.half_extent.p;
+
+	m_aabbs.min_x.push_back(min_p.x);
+	m_aabbs.min_y.push_back(min_p.y);
+	m_aabbs.min_z.push_back(min_p.z);
+	m_aabbs.max_x.push_back(max_p.x);
+	m_aabbs.max_y.push_back(max_p.y);
+	m_aabbs.max_z.push_back(max_p.z);
+	m_aabbs.owner.push_back(owner);
+	return ColliderHandle{ P_AABB, static_cast<unsigned int>(m_aabbs.Size() - 1) };
+}
+
+ColliderHandle CollisionWorld::AddRay(Ray const& ray, unsigned int owner)
+{
+	m_rays.ox.push_back(ray.origin.p.x);
+	m_rays.oy.push_back(ray.origin.p.y);
+	m_rays.oz.push_back(ray.origin.p.z);
+	m_rays.dx.push_back(ray.direction.p.x);
+	m_rays.dy.push_back(ray.direction.p.y);
+	m_rays.dz.push_back(ray.direction.p.z);
+	m_rays.owner.push_back(owner);
+	return ColliderHandle{ P_RAY, static_cast<unsigned int>(m_rays.Size() - 1) };
+}
+
+bool CollisionWorld::Test(ColliderHandle a, ColliderHandle b, int* result) const
+{
+	PairTest test = s_dispatch[a.type][b.type];
+	int side{};
+	bool hit = test && test(*this, a.index, b.index, side);
+	if (result)
+		*result = side;
+	return hit;
+}
+
+void CollisionWorld::Update()
+{
+	m_contacts.clear();
+	m_hits.resize(CMAX(m_spheres.Size(), m_aabbs.Size()));
+
+	// Hot pairs: one primitive against a contiguous run of the pool
+	for (unsigned int i{}; i < m_spheres.Size(); ++i)
+	{
+		SphereSphereBatch(m_spheres, GetSphere(i), i + 1, m_spheres.Size(), m_hits.data());
+		PushBatchHits(P_SPHERE, i, P_SPHERE, i + 1, m_spheres.Size());
+	}
+
+	for (unsigned int i{}; i < m_aabbs.Size(); ++i)
+	{
+		glm::vec3 min_p(m_aabbs.min_x[i], m_aabbs.min_y[i], m_aabbs.min_z[i]);
+		glm::vec3 max_p(m_aabbs.max_x[i], m_aabbs.max_y[i], m_aabbs.max_z[i]);
+		AABBAABBBatch(m_aabbs, min_p, max_p, i + 1, m_aabbs.Size(), m_hits.data());
+		PushBatchHits(P_AABB, i, P_AABB, i + 1, m_aabbs.Size());
+	}
+
+	for (unsigned int i{}; i < m_rays.Size(); ++i)
+	{
+		RayAABBBatch(m_aabbs, GetRay(i), 0, m_aabbs.Size(), m_hits.data());
+		PushBatchHits(P_RAY, i, P_AABB, 0, m_aabbs.Size());
+	}
+
+	// Everything else goes through the table, once per unordered pair
+	for (int ta{}; ta < P_COUNT; ++ta)
+	{
+		for (int tb{ ta }; tb < P_COUNT; ++tb)
+		{
+			PRIMTYPE type_a = static_cast<PRIMTYPE>(ta);
+			PRIMTYPE type_b = static_cast<PRIMTYPE>(tb);
+			PairTest test = s_dispatch[ta][tb];
+
+			if (!test || IsBatched(type_a, type_b))
+				continue;
+
+			unsigned int count_a = static_cast<unsigned int>(Count(type_a));
+			unsigned int count_b = static_cast<unsigned int>(Count(type_b));
+
+			for (unsigned int i{}; i < count_a; ++i)
+			{
+				for (unsigned int j{ ta == tb ? i + 1 : 0 }; j < count_b; ++j)
+				{
+					int result{};
+					if (test(*this, i, j, result))
+						m_contacts.push_back(Contact{ { type_a, i }, { type_b, j }, result });
+				}
+			}
+		}
+	}
+}
+
+size_t CollisionWorld::Count(PRIMTYPE type) const
+{
+	switch (type)
+	{
+		case P_POINT:		return m_points.Size();
+		case P_PLANE:		return m_planes.Size();
+		case P_TRIANGLE:	return m_triangles.Size();
+		case P_SPHERE:		return m_spheres.Size();
+		case P_AABB:		return m_aabbs.Size();
+		case P_RAY:			return m_rays.Size();
+		default:			return 0;
+	}
+}
+
+unsigned int CollisionWorld::GetOwner(ColliderHandle handle) const
+{
+	switch (handle.type)
+	{
+		case P_POINT:		return m_points.owner[handle.index];
+		case P_PLANE:		return m_planes.owner[handle.index];
+		case P_TRIANGLE:	return m_triangles.owner[handle.index];
+		case P_SPHERE:		return m_spheres.owner[handle.index];
+		case P_AABB:		return m_aabbs.owner[handle.index];
+		case P_RAY:			return m_rays.owner[handle.index];
+		default:			return 0;
+	}
+}
+
+Point3D CollisionWorld::GetPoint(unsigned int i) const
+{
+	return Point3D(glm::vec3(m_points.x[i], m_points.y[i], m_points.z[i]));
+}
+
+Plane CollisionWorld::GetPlane(unsigned int i) const
+{
+	Plane plane;
+	plane.normal = glm::vec4(m_planes.nx[i], m_planes.ny[i], m_planes.nz[i], m_planes.d[i]);
+	return plane;
+}
+
+Triangle CollisionWorld::GetTriangle(unsigned int i) const
+{
+	Triangle triangle;
+	triangle.p1 = glm::vec3(m_triangles.ax[i], m_triangles.ay[i], m_triangles.az[i]);
+	triangle.p2 = glm::vec3(m_triangles.bx[i], m_triangles.by[i], m_triangles.bz[i]);
+	triangle.p3 = glm::vec3(m_triangles.cx[i], m_triangles.cy[i], m_triangles.cz[i]);
+	return triangle;
+}
+
+BoundingSphere CollisionWorld::GetSphere(unsigned int i) const
+{
+	return BoundingSphere{ Point3D(glm::vec3(m_spheres.x[i], m_spheres.y[i], m_spheres.z[i])), m_spheres.r[i] };
+}
+
+AABB CollisionWorld::GetAABB(unsigned int i) const
+{
+	glm::vec3 min_p(m_aabbs.min_x[i], m_aabbs.min_y[i], m_aabbs.min_z[i]);
+	glm::vec3 max_p(m_aabbs.max_x[i], m_aabbs.max_y[i], m_aabbs.max_z[i]);
+	return AABB{ (min_p + max_p) * 0.5f, (max_p - min_p) * 0.5f };
+}
+
+Ray CollisionWorld::GetRay(unsigned int i) const
+{
+	Ray ray;
+	ray.origin = glm::vec3(m_rays.ox[i], m_rays.oy[i], m_rays.oz[i]);
+	ray.direction = glm::vec3(m_rays.dx[i], m_rays.dy[i], m_rays.dz[i]);
+	return ray;
+}
+
+void CollisionWorld::SphereSphereBatch(SpherePool const& pool, BoundingSphere const& sphere, size_t begin, size_t end, unsigned char* hits)
+{
+	size_t i = SphereSphereLanes<SIMD::FN>(pool, sphere, begin, end, hits);
+	for (; i < end; ++i)
+		hits[i - begin] = SphereSphere(sphere.position.p.x, sphere.position.p.y, sphere.position.p.z, sphere.radius, pool.x[i], pool.y[i], pool.z[i], pool.r[i]);
+}
+
+void CollisionWorld::AABBAABBBatch(AABBPool const& pool, glm::vec3 const& min_p, glm::vec3 const& max_p, size_t begin, size_t end, unsigned char* hits)
+{
+	size_t i = AABBAABBLanes<SIMD::FN>(pool, min_p, max_p, begin, end, hits);
+	for (; i < end; ++i)
+		hits[i - begin] = AABBAABB(pool, i, min_p, max_p);
+}
+
+void CollisionWorld::RayAABBBatch(AABBPool const& pool, Ray const& ray, size_t begin, size_t end, unsigned char* hits)
+{
+	glm::vec3 inv_dir = 1.f / ray.direction.p;
+	size_t i = RayAABBLanes<SIMD::FN>(pool, ray.origin.p, inv_dir, begin, end, hits);
+	for (; i < end; ++i)
+		hits[i - begin] = RayAABB(pool, i, ray.origin.p, inv_dir);
+}
+
+bool CollisionWorld::IsBatched(PRIMTYPE a, PRIMTYPE b)
+{
+	return (a == P_SPHERE && b == P_SPHERE) ||
+		(a == P_AABB && b == P_AABB) ||
+		(a == P_AABB && b == P_RAY) ||
+		(a == P_RAY && b == P_AABB);
+}
+
+void CollisionWorld::PushBatchHits(PRIMTYPE a, unsigned int i, PRIMTYPE b, size_t begin, size_t end)
+{
+	for (size_t j = begin; j < end; ++j)
+	{
+		if (m_hits[j - begin])
+			m_contacts.push_back(Contact{ { a, i }, { b, static_cast<unsigned int>(j) }, 1 });
+	}
+}
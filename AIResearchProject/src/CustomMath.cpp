@@ -29,3 +29,21 @@ float CMATH::Clamp(float val, float min_v, float max_v)
 {
 	return CMAX(min_v, CMIN(val, max_v));
 }
+
+void CMATH::SinCosDegrees(double degrees, double& sin, double& cos)
+{
+	const double x = CMAX(0.0, CMIN(degrees, 90.0)) * (3.14159265358979323846 / 180.0);
+	const double x2 = x * x;
+
+	// Taylor terms up to x^25, the first one dropped is below 1e-19 at 90 degrees
+	double s_term = x, c_term = 1.0;
+	sin = s_term;
+	cos = c_term;
+	for (int k = 1; k <= 12; ++k)
+	{
+		s_term *= -x2 / ((2.0 * k) * (2.0 * k + 1.0));
+		c_term *= -x2 / ((2.0 * k - 1.0) * (2.0 * k));
+		sin += s_term;
+		cos += c_term;
+	}
+}
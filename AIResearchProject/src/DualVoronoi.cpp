@@ -0,0 +1,91 @@
+#include "DualVoronoi.h"
+#include "Utils.h"
+
+#include <cmath>
+
+namespace
+{
+	constexpr size_t CIRCUMCENTRE_CHUNK = 4096;
+	constexpr double DEGENERATE_DET = 1e-12;
+}
+
+void DualVoronoi::Build(HalfEdgeMesh const& mesh)
+{
+	m_mesh = &mesh;
+	m_circumcentres.resize(mesh.TriangleCount());
+
+	UTILS::ParallelFor(mesh.TriangleCount(), CIRCUMCENTRE_CHUNK, [&](size_t begin, size_t end)
+	{
+		for (size_t t = begin; t < end; ++t)
+		{
+			glm::dvec2 a = mesh.points[mesh.triangles[t * 3]];
+			glm::dvec2 b = mesh.points[mesh.triangles[t * 3 + 1]];
+			glm::dvec2 c = mesh.points[mesh.triangles[t * 3 + 2]];
+
+			// Relative to a to keep the products small
+			glm::dvec2 d = b - a;
+			glm::dvec2 e = c - a;
+			double bl = glm::dot(d, d);
+			double cl = glm::dot(e, e);
+			double det = d.x * e.y - d.y * e.x;
+
+			// Slivers on the hull have a centre near infinity, the centroid keeps the cell finite
+			if (std::fabs(det) < DEGENERATE_DET * (bl + cl))
+			{
+				m_circumcentres[t] = glm::vec2((a + b + c) / 3.0);
+				continue;
+			}
+
+			m_circumcentres[t] = glm::vec2(a + glm::dvec2(e.y * bl - d.y * cl, d.x * cl - e.x * bl) * (0.5 / det));
+		}
+	});
+}
+
+void DualVoronoi::Clear()
+{
+	m_mesh = nullptr;
+	m_circumcentres.clear();
+}
+
+bool DualVoronoi::Cell(unsigned int site, std::vector<glm::vec2>& polygon) const
+{
+	polygon.clear();
+
+	unsigned int start = m_mesh->incoming[site];
+	if (start == HalfEdgeMesh::NONE)
+		return false;
+
+	unsigned int e = start;
+	do
+	{
+		polygon.push_back(m_circumcentres[HalfEdgeMesh::TriangleOf(e)]);
+		e = m_mesh->halfedges[HalfEdgeMesh::Next(e)];
+	} while (e != start && e != HalfEdgeMesh::NONE);
+
+	return e == start;
+}
+
+void DualVoronoi::Neighbours(unsigned int site, std::vector<unsigned int>& sites) const
+{
+	m_mesh->VertexNeighbours(site, sites);
+}
+
+void DualVoronoi::Edges(std::vector<VoronoiEdge>& edges) const
+{
+	edges.clear();
+	edges.reserve(m_mesh->halfedges.size() / 2);
+
+	for (unsigned int e{}; e < m_mesh->halfedges.size(); ++e)
+	{
+		unsigned int twin = m_mesh->halfedges[e];
+		if (twin == HalfEdgeMesh::NONE || twin < e)
+			continue;
+
+		VoronoiEdge edge;
+		edge.start = m_circumcentres[HalfEdgeMesh::TriangleOf(e)];
+		edge.end = m_circumcentres[HalfEdgeMesh::TriangleOf(twin)];
+		edge.left_site = m_mesh->triangles[e];
+		edge.right_site = m_mesh->triangles[twin];
+		edges.push_back(edge);
+	}
+}
@@ -6,6 +6,7 @@
 #include <imgui_toggle.h>
 #include <Engine.h>
 #include <CustomMath.h>
+#include <Export.h>
 #include <ImGuizmo.h>
 #include <glm/gtc/type_ptr.hpp>
 #include <algorithm>
@@ -114,9 +115,58 @@ void Editor::Update()
 	ImGui::InputInt("Point Count", &no_points);
 	if (no_points < 1)
 		no_points = 1;
+	ImGui::Checkbox("Adaptive Density", &adaptive_density);
+	if (adaptive_density)
+	{
+		ImGui::InputFloat("Density Ratio", &density_ratio, 0.5f, 1.f);
+		if (density_ratio < 1.f)
+			density_ratio = 1.f;
+	}
+	// Refinement always seeds the boundary, the box only matters without it
+	bool boundary = seed_boundary || min_angle > 0.f;
+	ImGui::BeginDisabled(min_angle > 0.f);
+	if (ImGui::Checkbox("Seed Boundary", &boundary))
+		seed_boundary = boundary;
+	ImGui::EndDisabled();
+	ImGui::SeparatorText("Refinement");
+	ImGui::InputFloat("Min Angle", &min_angle, 1.f, 5.f);
+	min_angle = std::clamp(min_angle, 0.f, 30.f);
+	ImGui::SeparatorText("Erosion");
+	ImGui::InputInt("Grid Resolution", &erosion_resolution, 64, 256);
+	erosion_resolution = std::clamp(erosion_resolution, 16, 4096);
+	ImGui::Checkbox("Hydraulic", &hydraulic_erosion);
+	if (hydraulic_erosion)
+	{
+		ImGui::InputInt("Droplets", &erosion_droplets, 10000, 100000);
+		if (erosion_droplets < 0)
+			erosion_droplets = 0;
+	}
+	ImGui::Checkbox("Thermal", &thermal_erosion);
+	ImGui::InputInt("Thermal Iterations", &thermal_iterations, 10, 100);
+	if (thermal_iterations < 1)
+		thermal_iterations = 1;
+	ImGui::InputFloat("Talus Angle", &talus_angle, 1.f, 5.f);
+	talus_angle = std::clamp(talus_angle, 0.f, 89.f);
+
+	// Runs on the current terrain without regenerating it
+	if (ImGui::Button("Apply Thermal"))
+	{
+		EROSION::ThermalSettings thermal;
+		thermal.iterations = static_cast<unsigned int>(thermal_iterations);
+		thermal.talus_angle = talus_angle;
+		engine.GetRenderer().ErodeTerrain(thermal);
+	}
 	ImGui::SeparatorText("Map");
 	ImGui::InputFloat3("Map Scale", &map_scale.x);
-	ImGui::SeparatorText("Perlin");
+	ImGui::InputFloat("Rock Slope", &rock_slope, 1.f, 5.f);
+	rock_slope = std::clamp(rock_slope, 0.f, 89.f);
+	ImGui::Checkbox("Biomes", &biomes);
+	ImGui::InputFloat("Biome Size", &biome_size, 1.f, 5.f);
+	if (biome_size < 0.1f)
+		biome_size = 0.1f;
+	ImGui::SeparatorText("Noise");
+	ImGui::Combo("Backend", &noise_backend, "Perlin\0Simplex\0Perlin (float)\0");
+	ImGui::Combo("Landform", &landform, "Octaves\0Alpine\0Mesas\0Badlands\0");
 	ImGui::InputInt("Octave", &perlin_oct, 1, 2);
 	if (perlin_oct < 1)
 		perlin_oct = 1;
@@ -125,9 +175,70 @@ void Editor::Update()
 	ImGui::InputFloat("Resolution", &perlin_freq, 1.f, 10.f);
 	if (perlin_freq < 0.f)
 		perlin_freq = 0.f;
+	ImGui::Combo("Cells", &cell_feature, "None\0Plateaus\0Craters\0Rocks\0");
+	ImGui::InputFloat("Cell Size", &cell_size, 0.5f, 2.f);
+	if (cell_size < 0.1f)
+		cell_size = 0.1f;
+	ImGui::InputFloat("Cell Height", &cell_height, 0.05f, 0.2f);
+	cell_height = std::clamp(cell_height, -1.f, 1.f);
+
+	// Drops the terrain's CPU-side render buffers once they are uploaded, picking goes through the Terrain queries instead
+	if (ImGui::Checkbox("Release CPU Buffers", &release_cpu_buffers))
+		engine.GetRenderer().GetMeshLoader().SetReleaseCPUBuffers(release_cpu_buffers);
 
 	if (ImGui::Button("Generate"))
-		engine.GetRenderer().GenerateTerrain(seed, no_points, map_scale, perlin_oct, perlin_persistance, perlin_freq);
+	{
+		TerrainSettings settings;
+		settings.seed = static_cast<unsigned int>(seed);
+		settings.point_count = static_cast<unsigned int>(no_points);
+		settings.map_scale = map_scale;
+		settings.noise = static_cast<NOISE::Backend>(noise_backend);
+		settings.landform = static_cast<NOISE::Landform>(landform);
+		settings.perlin_oct = static_cast<unsigned int>(perlin_oct);
+		settings.perlin_persistance = perlin_persistance;
+		settings.perlin_freq = perlin_freq;
+		settings.adaptive_density = adaptive_density;
+		settings.density_ratio = density_ratio;
+		settings.min_angle = min_angle;
+		settings.seed_boundary = seed_boundary;
+		settings.rock_slope = rock_slope;
+		settings.biomes = biomes;
+		settings.biome_size = biome_size;
+		settings.cells.feature = static_cast<NOISE::CellFeature>(cell_feature);
+		settings.cells.size = cell_size;
+		settings.cells.amount = cell_height;
+		settings.hydraulic.droplets = hydraulic_erosion ? static_cast<unsigned int>(erosion_droplets) : 0u;
+		settings.erosion_resolution = static_cast<unsigned int>(erosion_resolution);
+		settings.thermal.iterations = thermal_erosion ? static_cast<unsigned int>(thermal_iterations) : 0u;
+		settings.thermal.talus_angle = talus_angle;
+		engine.GetRenderer().GenerateTerrain(settings);
+	}
+
+	ImGui::SeparatorText("Export");
+	ImGui::InputText("Path", export_path, sizeof(export_path));
+	const bool export_glb = ImGui::Button("Export GLB");
+	ImGui::SameLine();
+	const bool export_obj = ImGui::Button("Export OBJ");
+	if (export_glb || export_obj)
+	{
+		const std::string path = std::string(export_path) + (export_glb ? ".glb" : ".obj");
+		if (!EXPORT::Write(engine.GetRenderer().terrain, path, export_glb ? EXPORT::Format::GLB : EXPORT::Format::OBJ))
+			std::cout << "Failed to write " << path << "\n";
+	}
+	ImGui::InputInt2("Heightmap Size", heightmap_size);
+	heightmap_size[0] = std::clamp(heightmap_size[0], 1, 16384);
+	heightmap_size[1] = std::clamp(heightmap_size[1], 1, 16384);
+	const bool export_png = ImGui::Button("Export PNG");
+	ImGui::SameLine();
+	const bool export_r32 = ImGui::Button("Export R32F");
+	if (export_png || export_r32)
+	{
+		EXPORT::Heightmap heightmap;
+		EXPORT::RasteriseHeights(engine.GetRenderer().terrain, heightmap_size[0], heightmap_size[1], heightmap);
+		const std::string path = std::string(export_path) + (export_png ? ".png" : ".r32");
+		if (!EXPORT::WriteHeightmap(heightmap, path, export_png ? EXPORT::HeightmapFormat::PNG16 : EXPORT::HeightmapFormat::R32F))
+			std::cout << "Failed to write " << path << "\n";
+	}
 
 	ImVec2 window_pos = ImGui::GetWindowPos();
 	ImVec2 window_size = ImGui::GetWindowSize();
@@ -10,6 +10,7 @@ void Engine::Init()
 		exit(0);
 	m_editor.Init(m_window.GetWinPtr());
 	m_renderer.Init();
+	m_collision.Init();
 }
 
 void Engine::Update()
@@ -17,6 +18,7 @@ void Engine::Update()
 	while (true)
 	{
 		double start = glfwGetTime();
+		m_collision.Update();
 		m_renderer.Update();
 		m_editor.Update();
 		m_input.Update();
@@ -0,0 +1,383 @@
+#include "Erosion.h"
+#include "Utils.h"
+#include "SIMD.h"
+#include "CustomMath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace
+{
+	constexpr int MIN_TILE = 64;
+	constexpr unsigned int TILE_DROPLETS = 16;
+
+	// splitmix64, one independent stream per tile and batch
+	struct DropletRNG
+	{
+		uint64_t state;
+
+		DropletRNG(unsigned int seed, uint64_t stream) : state((static_cast<uint64_t>(seed) << 32) ^ (stream * 0x9E3779B97F4A7C15ull)) {}
+
+		uint64_t Next()
+		{
+			uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+			return z ^ (z >> 31);
+		}
+
+		// [0, 1)
+		float Float() { return static_cast<float>(Next() >> 40) * (1.f / 16777216.f); }
+	};
+
+	struct Brush
+	{
+		std::pmr::vector<glm::ivec2> offsets;
+		std::pmr::vector<float> weights;
+
+		Brush(int radius, std::pmr::memory_resource* resource) : offsets(resource), weights(resource)
+		{
+			radius = std::max(radius, 1);
+			float sum{};
+			for (int y = -radius; y <= radius; ++y)
+				for (int x = -radius; x <= radius; ++x)
+				{
+					float w = static_cast<float>(radius) - std::sqrt(static_cast<float>(x * x + y * y));
+					if (w <= 0.f)
+						continue;
+					offsets.emplace_back(x, y);
+					weights.push_back(w);
+					sum += w;
+				}
+
+			for (float& w : weights)
+				w /= sum;
+		}
+	};
+
+	// Bilinear height and gradient inside the cell whose top-left sample is (x, y), f is the offset within it
+	float HeightGradient(std::pmr::vector<float> const& h, int width, int x, int y, glm::vec2 const& f, glm::vec2& gradient)
+	{
+		size_t i = static_cast<size_t>(y) * width + x;
+		float nw = h[i], ne = h[i + 1], sw = h[i + width], se = h[i + width + 1];
+
+		gradient.x = (ne - nw) * (1.f - f.y) + (se - sw) * f.y;
+		gradient.y = (sw - nw) * (1.f - f.x) + (se - ne) * f.x;
+		return nw * (1.f - f.x) * (1.f - f.y) + ne * f.x * (1.f - f.y) + sw * (1.f - f.x) * f.y + se * f.x * f.y;
+	}
+
+	void Deposit(std::pmr::vector<float>& h, int width, int x, int y, glm::vec2 const& f, float amount)
+	{
+		size_t i = static_cast<size_t>(y) * width + x;
+		h[i] += amount * (1.f - f.x) * (1.f - f.y);
+		h[i + 1] += amount * f.x * (1.f - f.y);
+		h[i + width] += amount * (1.f - f.x) * f.y;
+		h[i + width + 1] += amount * f.x * f.y;
+	}
+
+	// Clips a tile to where droplets can start, false when nothing of it is left.
+	// Bilinear lookups need the sample after the cell as well.
+	bool ClipTile(glm::vec2& lo, glm::vec2& hi, int width, int height)
+	{
+		hi = glm::min(hi, glm::vec2(width - 1, height - 1));
+		lo = glm::max(lo, glm::vec2(0.f));
+		return hi.x > lo.x && hi.y > lo.y;
+	}
+
+	// Runs droplets that start and stay inside [lo, hi) on the heights h (in cell units).
+	// They touch samples up to the brush radius past that box and nothing else.
+	void RunTile(std::pmr::vector<float>& h, int width, int height, glm::vec2 lo, glm::vec2 hi, Brush const& brush,
+				 EROSION::HydraulicSettings const& s, DropletRNG& rng, unsigned int droplets)
+	{
+		if (!ClipTile(lo, hi, width, height))
+			return;
+
+		for (unsigned int d{}; d < droplets; ++d)
+		{
+			glm::vec2 pos = lo + glm::vec2(rng.Float(), rng.Float()) * (hi - lo);
+			glm::vec2 dir(0.f);
+			float speed = 1.f;
+			float water = 1.f;
+			float sediment{};
+
+			int x{}, y{};
+			glm::vec2 f(0.f);
+			for (unsigned int step{}; step < s.lifetime; ++step)
+			{
+				x = static_cast<int>(pos.x);
+				y = static_cast<int>(pos.y);
+				f = pos - glm::vec2(x, y);
+
+				glm::vec2 gradient;
+				float h0 = HeightGradient(h, width, x, y, f, gradient);
+
+				dir = dir * s.inertia - gradient * (1.f - s.inertia);
+				float len = glm::length(dir);
+				if (len <= 0.f)
+					break;
+				dir /= len;
+
+				glm::vec2 next = pos + dir;
+				if (next.x < lo.x || next.y < lo.y || next.x >= hi.x || next.y >= hi.y)
+					break;
+
+				glm::vec2 unused;
+				int nx = static_cast<int>(next.x);
+				int ny = static_cast<int>(next.y);
+				float dh = HeightGradient(h, width, nx, ny, next - glm::vec2(nx, ny), unused) - h0;
+
+				float capacity = std::max(-dh * speed * water * s.capacity, s.min_capacity);
+				if (sediment > capacity || dh > 0.f)
+				{
+					// Uphill the droplet fills the pit it leaves, otherwise it sheds a share of its excess
+					float deposit = dh > 0.f ? std::min(dh, sediment) : (sediment - capacity) * s.deposit_rate;
+					sediment -= deposit;
+					Deposit(h, width, x, y, f, deposit);
+				}
+				else
+				{
+					// Never dig deeper than the drop to the next position
+					float erode = std::min((capacity - sediment) * s.erode_rate, -dh);
+					for (size_t b{}; b < brush.offsets.size(); ++b)
+					{
+						int bx = x + brush.offsets[b].x;
+						int by = y + brush.offsets[b].y;
+						if (bx < 0 || by < 0 || bx >= width || by >= height)
+							continue;
+						h[static_cast<size_t>(by) * width + bx] -= erode * brush.weights[b];
+					}
+					sediment += erode;
+				}
+
+				speed = std::sqrt(std::max(speed * speed - dh * s.gravity, 0.f));
+				water *= 1.f - s.evaporation;
+				pos = next;
+			}
+
+			// Whatever the droplet still carries settles in its last cell, otherwise sinks at tile and map borders
+			// only ever lose material and deepen without bound
+			Deposit(h, width, x, y, f, sediment);
+		}
+	}
+}
+
+void EROSION::HeightGrid::Resize(glm::vec2 const& min, glm::vec2 const& max, unsigned int resolution)
+{
+	glm::vec2 extent = max - min;
+	resolution = std::max(resolution, 2u);
+
+	origin = min;
+	cell = std::max(std::max(extent.x, extent.y), std::numeric_limits<float>::min()) / static_cast<float>(resolution - 1);
+	width = static_cast<int>(std::ceil(extent.x / cell)) + 1;
+	height = static_cast<int>(std::ceil(extent.y / cell)) + 1;
+	heights.assign(static_cast<size_t>(width) * height, 0.f);
+}
+
+float EROSION::HeightGrid::Sample(float x, float z) const
+{
+	float fx = std::clamp((x - origin.x) / cell, 0.f, static_cast<float>(width - 1));
+	float fz = std::clamp((z - origin.y) / cell, 0.f, static_cast<float>(height - 1));
+	int x0 = std::min(static_cast<int>(fx), width - 2);
+	int z0 = std::min(static_cast<int>(fz), height - 2);
+	float tx = fx - x0;
+	float tz = fz - z0;
+
+	float top = At(x0, z0) + (At(x0 + 1, z0) - At(x0, z0)) * tx;
+	float bottom = At(x0, z0 + 1) + (At(x0 + 1, z0 + 1) - At(x0, z0 + 1)) * tx;
+	return top + (bottom - top) * tz;
+}
+
+glm::vec2 EROSION::HeightGrid::Gradient(float x, float z) const
+{
+	float fx = std::clamp((x - origin.x) / cell, 0.f, static_cast<float>(width - 1));
+	float fz = std::clamp((z - origin.y) / cell, 0.f, static_cast<float>(height - 1));
+	int x0 = std::min(static_cast<int>(fx), width - 2);
+	int z0 = std::min(static_cast<int>(fz), height - 2);
+	float tx = fx - x0;
+	float tz = fz - z0;
+
+	float top = At(x0, z0) + (At(x0 + 1, z0) - At(x0, z0)) * tx;
+	float bottom = At(x0, z0 + 1) + (At(x0 + 1, z0 + 1) - At(x0, z0 + 1)) * tx;
+	float slope_top = At(x0 + 1, z0) - At(x0, z0);
+	float slope_bottom = At(x0 + 1, z0 + 1) - At(x0, z0 + 1);
+	return glm::vec2(slope_top + (slope_bottom - slope_top) * tz, bottom - top) / cell;
+}
+
+void EROSION::Hydraulic(HeightGrid& grid, HydraulicSettings const& settings, unsigned int seed, std::pmr::memory_resource* scratch)
+{
+	if (settings.droplets == 0 || grid.width < 2 || grid.height < 2)
+		return;
+
+	// Heights in cell units make the slope per step the real gradient, independent of resolution and map size
+	const float to_cells = 1.f / grid.cell;
+	std::pmr::vector<float> h(grid.heights.size(), scratch);
+	for (size_t i{}; i < h.size(); ++i)
+		h[i] = grid.heights[i] * to_cells;
+
+	Brush brush(settings.radius, scratch);
+
+	// Tiles of one colour in a 2 x 2 colouring are a tile apart, wider than two brush radii,
+	// so their droplets never touch the same samples and can run concurrently in any order
+	const int tile = std::max(MIN_TILE, 2 * std::max(settings.radius, 1) + 2);
+	const int tiles_x = (grid.width + tile - 1) / tile + 1;
+	const int tiles_y = (grid.height + tile - 1) / tile + 1;
+	const unsigned int tile_count = static_cast<unsigned int>(tiles_x * tiles_y);
+
+	std::pmr::vector<unsigned int> counts(tile_count, scratch);
+	std::pmr::vector<unsigned int> colour_tiles(scratch);
+	unsigned int left = settings.droplets;
+	for (unsigned int batch{}; left > 0; ++batch)
+	{
+		// A fresh tiling offset per batch keeps the tile borders, where droplets stop, from lining up into seams
+		DropletRNG offset_rng(seed, static_cast<uint64_t>(batch) << 32 | 0xFFFFFFFFu);
+		glm::vec2 offset(-offset_rng.Float() * tile, -offset_rng.Float() * tile);
+		auto tile_lo = [&](unsigned int t)
+		{
+			return offset + glm::vec2(static_cast<float>(t % tiles_x), static_cast<float>(t / tiles_x)) * static_cast<float>(tile);
+		};
+
+		// Tiles on the grid run TILE_DROPLETS each until the last batch, which spreads what is left over them with the
+		// first ones taking the remainder. Tiles shifted off the grid run none, so exactly settings.droplets run.
+		unsigned int live{};
+		for (unsigned int t{}; t < tile_count; ++t)
+		{
+			glm::vec2 lo = tile_lo(t), hi = lo + glm::vec2(static_cast<float>(tile));
+			counts[t] = ClipTile(lo, hi, grid.width, grid.height) ? 1u : 0u;
+			live += counts[t];
+		}
+		const unsigned int budget = std::min(left, live * TILE_DROPLETS);
+		left -= budget;
+		for (unsigned int t{}, rank{}; t < tile_count; ++t)
+			if (counts[t])
+				counts[t] = budget / live + (rank++ < budget % live ? 1u : 0u);
+
+		for (int colour{}; colour < 4; ++colour)
+		{
+			colour_tiles.clear();
+			for (int ty = colour / 2; ty < tiles_y; ty += 2)
+				for (int tx = colour % 2; tx < tiles_x; tx += 2)
+				{
+					unsigned int t = static_cast<unsigned int>(ty * tiles_x + tx);
+					if (counts[t])
+						colour_tiles.push_back(t);
+				}
+
+			UTILS::ParallelFor(colour_tiles.size(), 1, [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; ++i)
+				{
+					unsigned int t = colour_tiles[i];
+					glm::vec2 lo = tile_lo(t);
+
+					DropletRNG rng(seed, static_cast<uint64_t>(batch) << 32 | t);
+					RunTile(h, grid.width, grid.height, lo, lo + glm::vec2(static_cast<float>(tile)), brush, settings, rng, counts[t]);
+				}
+			});
+		}
+	}
+
+	for (size_t i{}; i < h.size(); ++i)
+		grid.heights[i] = h[i] * grid.cell;
+}
+
+void EROSION::Thermal(HeightGrid& grid, ThermalSettings const& settings, std::pmr::memory_resource* scratch)
+{
+	using FN = SIMD::FN;
+	constexpr int W = FN::WIDTH;
+
+	if (settings.iterations == 0 || grid.width < 2 || grid.height < 2)
+		return;
+
+	// Padded buffers: one ring of walls around the grid, rows rounded up to whole vectors plus the ring so every
+	// stencil load stays in bounds. Walls are too high to receive material and never shed any.
+	constexpr float WALL = 1e30f;
+	const int width = grid.width;
+	const int height = grid.height;
+	const int stride = (width + W - 1) / W * W + 2;
+	const size_t padded = static_cast<size_t>(stride) * (height + 2);
+
+	std::pmr::vector<float> h(padded, WALL, scratch), next(padded, WALL, scratch);
+	std::pmr::vector<float> share(padded, 0.f, scratch);	// Outflow per unit of a neighbour's excess
+	std::pmr::vector<float> out(padded, 0.f, scratch);	// Total outflow
+	for (int y{}; y < height; ++y)
+		std::copy_n(&grid.heights[static_cast<size_t>(y) * width], width, &h[static_cast<size_t>(y + 1) * stride + 1]);
+
+	double talus_sin, talus_cos;
+	CMATH::SinCosDegrees(std::clamp(settings.talus_angle, 0.f, 89.f), talus_sin, talus_cos);
+	const float talus = static_cast<float>(talus_sin / talus_cos) * grid.cell;
+	const float rate = std::clamp(settings.rate, 0.f, 1.f) * 0.5f;
+
+	// Neighbour offsets and their talus drops, diagonals are sqrt(2) further away
+	const int offsets[8] = { -stride - 1, -stride, -stride + 1, -1, 1, stride - 1, stride, stride + 1 };
+	FN drops[8];
+	for (int n{}; n < 8; ++n)
+		drops[n] = FN::Set1(n == 0 || n == 2 || n == 5 || n == 7 ? talus * 1.41421356f : talus);
+
+	const FN zero = FN::Zero();
+	const FN half_rate = FN::Set1(rate);
+
+	for (unsigned int it{}; it < settings.iterations; ++it)
+	{
+		// Outflow: each cell's excess over its lower neighbours
+		UTILS::ParallelFor(static_cast<size_t>(height), 16, [&](size_t begin, size_t end)
+		{
+			for (size_t y = begin + 1; y < end + 1; ++y)
+			{
+				size_t row = y * stride;
+				for (int x = 1; x <= width; x += W)
+				{
+					const float* c = &h[row + x];
+					FN hc = FN::Load(c);
+					FN total = zero, largest = zero;
+					for (int n{}; n < 8; ++n)
+					{
+						FN excess = SIMD::Max(hc - FN::Load(c + offsets[n]) - drops[n], zero);
+						total = total + excess;
+						largest = SIMD::Max(largest, excess);
+					}
+
+					FN moved = half_rate * largest;
+					FN has_flow = total > zero;
+					SIMD::Select(has_flow, moved / SIMD::Max(total, FN::Set1(1e-30f)), zero).Store(&share[row + x]);
+					SIMD::Select(has_flow, moved, zero).Store(&out[row + x]);
+				}
+
+				// The last vector reads past the row into the walls, those cells never shed
+				for (int x = width + 1; x < stride; ++x)
+					share[row + x] = out[row + x] = 0.f;
+			}
+		});
+
+		// Gather: keep what did not leave, take each higher neighbour's share of its excess over this cell
+		UTILS::ParallelFor(static_cast<size_t>(height), 16, [&](size_t begin, size_t end)
+		{
+			for (size_t y = begin + 1; y < end + 1; ++y)
+			{
+				size_t row = y * stride;
+				for (int x = 1; x <= width; x += W)
+				{
+					const float* c = &h[row + x];
+					const float* s = &share[row + x];
+					FN hc = FN::Load(c);
+					FN sum = hc - FN::Load(&out[row + x]);
+					for (int n{}; n < 8; ++n)
+					{
+						FN excess = SIMD::Max(FN::Load(c + offsets[n]) - hc - drops[n], zero);
+						sum = sum + FN::Load(s + offsets[n]) * excess;
+					}
+					sum.Store(&next[row + x]);
+				}
+
+				for (int x = width + 1; x < stride; ++x)
+					next[row + x] = WALL;
+			}
+		});
+
+		h.swap(next);
+	}
+
+	for (int y{}; y < height; ++y)
+		std::copy_n(&h[static_cast<size_t>(y + 1) * stride + 1], width, &grid.heights[static_cast<size_t>(y) * width]);
+}
@@ -0,0 +1,692 @@
+#include "Export.h"
+#include "Utils.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cmath>
+#include <charconv>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <io.h>
+#include <share.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace
+{
+	int OpenForWrite(const char* path)
+	{
+#ifdef _WIN32
+		int fd = -1;
+		return _sopen_s(&fd, path, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _SH_DENYWR, _S_IREAD | _S_IWRITE) == 0 ? fd : -1;
+#else
+		return open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+	}
+
+	void CloseFile(int fd)
+	{
+#ifdef _WIN32
+		_close(fd);
+#else
+		close(fd);
+#endif
+	}
+
+	// Writes all of bytes, retrying after partial writes
+	bool WriteAll(int fd, const char* data, size_t bytes)
+	{
+		while (bytes > 0)
+		{
+			const unsigned int part = static_cast<unsigned int>(std::min<size_t>(bytes, 1u << 30));
+#ifdef _WIN32
+			const int written = _write(fd, data, part);
+#else
+			const ssize_t written = write(fd, data, part);
+#endif
+			if (written <= 0)
+				return false;
+			data += written;
+			bytes -= static_cast<size_t>(written);
+		}
+		return true;
+	}
+
+	// Lower case extension after the last dot, empty without one
+	std::string Extension(std::string const& path)
+	{
+		const size_t dot = path.find_last_of('.');
+		if (dot == std::string::npos)
+			return std::string();
+
+		std::string extension = path.substr(dot + 1);
+		std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+		return extension;
+	}
+
+	// Shortest text that reads back as the same float
+	char* AppendFloat(char* p, float value)
+	{
+		return std::to_chars(p, p + 32, value).ptr;
+	}
+
+	char* AppendUint(char* p, size_t value)
+	{
+		return std::to_chars(p, p + 24, value).ptr;
+	}
+
+	char* AppendText(char* p, const char* text)
+	{
+		const size_t length = std::strlen(text);
+		std::memcpy(p, text, length);
+		return p + length;
+	}
+
+	/*
+	* Formats count lines of at most max_line bytes each through format(p, i), which writes line i at p and returns its end.
+	* Blocks of lines are formatted in parallel into buffers reused from group to group and written in order, so the
+	* output is the same for any number of workers and memory stays at one group of blocks.
+	*/
+	template <typename F>
+	void WriteLines(EXPORT::StreamWriter& out, size_t count, size_t max_line, F&& format)
+	{
+		constexpr size_t BLOCK = 4096;	// Lines per block
+
+		const size_t group = static_cast<size_t>(UTILS::GetWorkerCount()) * 2;
+		std::vector<std::vector<char>> blocks(std::min(group, (count + BLOCK - 1) / BLOCK));
+		std::vector<size_t> lengths(blocks.size());
+		for (auto& block : blocks)
+			block.resize(BLOCK * max_line);
+
+		for (size_t first{}; first < count && out.Good(); first += blocks.size() * BLOCK)
+		{
+			const size_t n = std::min(blocks.size(), (count - first + BLOCK - 1) / BLOCK);
+			UTILS::ParallelFor(n, 1, [&](size_t begin, size_t end)
+			{
+				for (size_t b = begin; b < end; ++b)
+				{
+					char* p = blocks[b].data();
+					const size_t last = std::min(count, first + (b + 1) * BLOCK);
+					for (size_t i = first + b * BLOCK; i < last; ++i)
+						p = format(p, i);
+					lengths[b] = static_cast<size_t>(p - blocks[b].data());
+				}
+			});
+
+			for (size_t b{}; b < n; ++b)
+				out.Write(blocks[b].data(), lengths[b]);
+		}
+	}
+
+	// glTF constants, component types and buffer targets take their GL values
+	constexpr uint32_t GLB_MAGIC = 0x46546C67;		// "glTF"
+	constexpr uint32_t GLB_VERSION = 2;
+	constexpr uint32_t GLB_CHUNK_JSON = 0x4E4F534A;	// "JSON"
+	constexpr uint32_t GLB_CHUNK_BIN = 0x004E4942;	// "BIN\0"
+	constexpr int GLTF_FLOAT = 5126;
+	constexpr int GLTF_UNSIGNED_INT = 5125;
+	constexpr int GLTF_ARRAY_BUFFER = 34962;
+	constexpr int GLTF_ELEMENT_ARRAY_BUFFER = 34963;
+
+	constexpr size_t GLB_STRIDE = 3 * sizeof(glm::vec3);	// Position, normal, colour
+
+	constexpr int RASTER_TILE = 64;	// Pixels along a rasteriser tile's side
+
+	/* PNG */
+	void StoreBE32(unsigned char* p, uint32_t value)
+	{
+		p[0] = static_cast<unsigned char>(value >> 24);
+		p[1] = static_cast<unsigned char>(value >> 16);
+		p[2] = static_cast<unsigned char>(value >> 8);
+		p[3] = static_cast<unsigned char>(value);
+	}
+
+	// CRC-32 of ISO 3309 as PNG chunks use it, continued from crc (0 to start)
+	uint32_t Crc32(uint32_t crc, const unsigned char* data, size_t bytes)
+	{
+		static const std::array<uint32_t, 256> table = []
+		{
+			std::array<uint32_t, 256> t{};
+			for (uint32_t n{}; n < 256; ++n)
+			{
+				uint32_t c = n;
+				for (int k{}; k < 8; ++k)
+					c = (c & 1u) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+				t[n] = c;
+			}
+			return t;
+		}();
+
+		crc = ~crc;
+		for (size_t i{}; i < bytes; ++i)
+			crc = table[(crc ^ data[i]) & 0xFFu] ^ (crc >> 8);
+		return ~crc;
+	}
+
+	// Adler-32 of the zlib stream, continued from adler (1 to start)
+	uint32_t Adler32(uint32_t adler, const unsigned char* data, size_t bytes)
+	{
+		constexpr uint32_t MOD = 65521;
+		constexpr size_t RUN = 5552;	// Longest run before the sums can overflow 32 bits
+
+		uint32_t a = adler & 0xFFFFu, b = adler >> 16;
+		while (bytes > 0)
+		{
+			const size_t n = std::min(bytes, RUN);
+			for (size_t i{}; i < n; ++i)
+			{
+				a += data[i];
+				b += a;
+			}
+			a %= MOD;
+			b %= MOD;
+			data += n;
+			bytes -= n;
+		}
+		return (b << 16) | a;
+	}
+
+	void WritePngChunk(EXPORT::StreamWriter& out, const char* type, const unsigned char* data, size_t bytes)
+	{
+		unsigned char head[8];
+		StoreBE32(head, static_cast<uint32_t>(bytes));
+		std::memcpy(head + 4, type, 4);
+		out.Write(head, sizeof(head));
+		out.Write(data, bytes);
+
+		unsigned char crc[4];
+		StoreBE32(crc, Crc32(Crc32(0, head + 4, 4), data, bytes));
+		out.Write(crc, sizeof(crc));
+	}
+
+	/*
+	* The image data as a zlib stream of stored (uncompressed) deflate blocks, cut into IDAT chunks as it fills.
+	* Heightmaps are noisy in their low bits and compress poorly, stored blocks keep the export at disk speed.
+	*/
+	class PngImageStream
+	{
+	public:
+		explicit PngImageStream(EXPORT::StreamWriter& out) : m_out(out)
+		{
+			m_idat.reserve(IDAT_BYTES + BLOCK_BYTES + 16);
+			m_idat.push_back(0x78);	// Deflate, 32K window
+			m_idat.push_back(0x01);	// No preset dictionary, fastest level; 0x7801 is a multiple of 31
+		}
+
+		void Append(const unsigned char* data, size_t bytes)
+		{
+			m_adler = Adler32(m_adler, data, bytes);
+			while (bytes > 0)
+			{
+				const size_t n = std::min(bytes, BLOCK_BYTES - m_block.size());
+				m_block.insert(m_block.end(), data, data + n);
+				data += n;
+				bytes -= n;
+				if (m_block.size() == BLOCK_BYTES)
+					EmitBlock(false);
+			}
+		}
+
+		void Finish()
+		{
+			EmitBlock(true);
+			unsigned char adler[4];
+			StoreBE32(adler, m_adler);
+			m_idat.insert(m_idat.end(), adler, adler + 4);
+			WritePngChunk(m_out, "IDAT", m_idat.data(), m_idat.size());
+			m_idat.clear();
+		}
+
+	private:
+		static constexpr size_t BLOCK_BYTES = 65535;	// Largest stored block
+		static constexpr size_t IDAT_BYTES = 1 << 20;
+
+		void EmitBlock(bool last)
+		{
+			const uint16_t length = static_cast<uint16_t>(m_block.size());
+			const unsigned char head[5] = { static_cast<unsigned char>(last ? 1 : 0),
+											static_cast<unsigned char>(length), static_cast<unsigned char>(length >> 8),
+											static_cast<unsigned char>(~length), static_cast<unsigned char>(~length >> 8) };
+			m_idat.insert(m_idat.end(), head, head + 5);
+			m_idat.insert(m_idat.end(), m_block.begin(), m_block.end());
+			m_block.clear();
+
+			if (!last && m_idat.size() >= IDAT_BYTES)
+			{
+				WritePngChunk(m_out, "IDAT", m_idat.data(), m_idat.size());
+				m_idat.clear();
+			}
+		}
+
+		EXPORT::StreamWriter& m_out;
+		std::vector<unsigned char> m_idat;
+		std::vector<unsigned char> m_block;
+		uint32_t m_adler{ 1 };
+	};
+
+	bool WritePNG16(EXPORT::Heightmap const& heightmap, std::string const& path)
+	{
+		EXPORT::StreamWriter out(path.c_str());
+
+		const unsigned char signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+		out.Write(signature, sizeof(signature));
+
+		unsigned char ihdr[13];
+		StoreBE32(ihdr, static_cast<uint32_t>(heightmap.width));
+		StoreBE32(ihdr + 4, static_cast<uint32_t>(heightmap.height));
+		ihdr[8] = 16;	// Bit depth
+		ihdr[9] = 0;	// Greyscale
+		ihdr[10] = 0;	// Deflate
+		ihdr[11] = 0;	// Adaptive filtering, every row uses filter 0
+		ihdr[12] = 0;	// Not interlaced
+		WritePngChunk(out, "IHDR", ihdr, sizeof(ihdr));
+
+		// The world heights of black and white, for tools that import the range
+		char text[128];
+		char* p = text;
+		p = AppendText(p, "Comment");
+		*p++ = '\0';
+		p = AppendText(p, "height range ");
+		p = AppendFloat(p, heightmap.min_height);
+		*p++ = ' ';
+		p = AppendFloat(p, heightmap.max_height);
+		WritePngChunk(out, "tEXt", reinterpret_cast<const unsigned char*>(text), static_cast<size_t>(p - text));
+
+		const float range = heightmap.max_height - heightmap.min_height;
+		const float scale = range > 0.f ? 65535.f / range : 0.f;
+		std::vector<unsigned char> row(1 + 2 * static_cast<size_t>(heightmap.width));
+		PngImageStream image(out);
+		for (int y{}; y < heightmap.height && out.Good(); ++y)
+		{
+			const float* heights = heightmap.heights.data() + static_cast<size_t>(y) * heightmap.width;
+			row[0] = 0;	// No filter
+			for (int x{}; x < heightmap.width; ++x)
+			{
+				const uint16_t v = static_cast<uint16_t>(std::clamp((heights[x] - heightmap.min_height) * scale + 0.5f, 0.f, 65535.f));
+				row[1 + 2 * x] = static_cast<unsigned char>(v >> 8);	// Samples are big endian
+				row[2 + 2 * x] = static_cast<unsigned char>(v);
+			}
+			image.Append(row.data(), row.size());
+		}
+		image.Finish();
+
+		WritePngChunk(out, "IEND", nullptr, 0);
+		return out.Close();
+	}
+}
+
+EXPORT::StreamWriter::StreamWriter(const char* path, size_t chunk_size)
+	: m_fd(OpenForWrite(path)), m_chunk(std::max<size_t>(chunk_size, 4096))
+{
+}
+
+EXPORT::StreamWriter::~StreamWriter()
+{
+	Close();
+}
+
+void EXPORT::StreamWriter::Write(const void* data, size_t bytes)
+{
+	// Empty writes may pass a null data, which memcpy must not see even for 0 bytes
+	if (bytes == 0)
+		return;
+
+	if (m_used + bytes > m_chunk.size())
+		Flush();
+
+	// Larger than a chunk, it goes out as it is
+	if (bytes >= m_chunk.size())
+	{
+		if (Good() && !WriteAll(m_fd, static_cast<const char*>(data), bytes))
+			m_good = false;
+		return;
+	}
+
+	std::memcpy(m_chunk.data() + m_used, data, bytes);
+	m_used += bytes;
+}
+
+char* EXPORT::StreamWriter::Reserve(size_t bytes)
+{
+	if (m_used + bytes > m_chunk.size())
+		Flush();
+	return m_chunk.data() + m_used;
+}
+
+bool EXPORT::StreamWriter::Close()
+{
+	if (m_fd < 0)
+		return false;
+
+	Flush();
+	CloseFile(m_fd);
+	m_fd = -1;
+	return m_good;
+}
+
+void EXPORT::StreamWriter::Flush()
+{
+	if (Good() && m_used > 0 && !WriteAll(m_fd, m_chunk.data(), m_used))
+		m_good = false;
+	m_used = 0;
+}
+
+bool EXPORT::FormatFromPath(std::string const& path, Format& format)
+{
+	const std::string extension = Extension(path);
+	if (extension == "glb")
+		format = Format::GLB;
+	else if (extension == "obj")
+		format = Format::OBJ;
+	else
+		return false;
+	return true;
+}
+
+bool EXPORT::Write(Terrain const& terrain, std::string const& path, Format format)
+{
+	return format == Format::GLB ? WriteGLB(terrain, path) : WriteOBJ(terrain, path);
+}
+
+bool EXPORT::WriteGLB(Terrain const& terrain, std::string const& path)
+{
+	std::vector<glm::vec3> const& positions = terrain.GetSharedVtx();
+	std::vector<glm::vec3> const& normals = terrain.GetSharedNml();
+	std::vector<glm::vec3> const& colours = terrain.GetSharedClr();
+	std::vector<unsigned int> const& indices = terrain.GetIndices();
+	if (positions.empty() || indices.empty() || normals.size() != positions.size() || colours.size() != positions.size())
+		return false;
+
+	glm::vec3 min(std::numeric_limits<float>::max()), max(std::numeric_limits<float>::lowest());
+	for (glm::vec3 const& p : positions)
+	{
+		min = glm::min(min, p);
+		max = glm::max(max, p);
+	}
+
+	const size_t vertex_bytes = positions.size() * GLB_STRIDE;
+	const size_t index_bytes = indices.size() * sizeof(uint32_t);
+	const size_t bin_bytes = vertex_bytes + index_bytes;
+
+	// Bounds are required on POSITION and written exactly, everything else is sizes
+	auto vec3 = [](glm::vec3 const& v)
+	{
+		char text[128];
+		char* p = text;
+		*p++ = '[';
+		p = AppendFloat(p, v.x);
+		*p++ = ',';
+		p = AppendFloat(p, v.y);
+		*p++ = ',';
+		p = AppendFloat(p, v.z);
+		*p++ = ']';
+		return std::string(text, p);
+	};
+	const std::string vertices = std::to_string(positions.size());
+	std::string json =
+		"{\"asset\":{\"version\":\"2.0\",\"generator\":\"TerrainGenerator\"},\"scene\":0,\"scenes\":[{\"nodes\":[0]}],"
+		"\"nodes\":[{\"mesh\":0,\"name\":\"terrain\"}],"
+		"\"meshes\":[{\"primitives\":[{\"attributes\":{\"POSITION\":0,\"NORMAL\":1,\"COLOR_0\":2},\"indices\":3,\"mode\":4}]}],"
+		"\"buffers\":[{\"byteLength\":" + std::to_string(bin_bytes) + "}],"
+		"\"bufferViews\":["
+		"{\"buffer\":0,\"byteOffset\":0,\"byteLength\":" + std::to_string(vertex_bytes) + ",\"byteStride\":" + std::to_string(GLB_STRIDE) +
+		",\"target\":" + std::to_string(GLTF_ARRAY_BUFFER) + "},"
+		"{\"buffer\":0,\"byteOffset\":" + std::to_string(vertex_bytes) + ",\"byteLength\":" + std::to_string(index_bytes) +
+		",\"target\":" + std::to_string(GLTF_ELEMENT_ARRAY_BUFFER) + "}],"
+		"\"accessors\":["
+		"{\"bufferView\":0,\"byteOffset\":0,\"componentType\":" + std::to_string(GLTF_FLOAT) + ",\"count\":" + vertices +
+		",\"type\":\"VEC3\",\"min\":" + vec3(min) + ",\"max\":" + vec3(max) + "},"
+		"{\"bufferView\":0,\"byteOffset\":12,\"componentType\":" + std::to_string(GLTF_FLOAT) + ",\"count\":" + vertices + ",\"type\":\"VEC3\"},"
+		"{\"bufferView\":0,\"byteOffset\":24,\"componentType\":" + std::to_string(GLTF_FLOAT) + ",\"count\":" + vertices + ",\"type\":\"VEC3\"},"
+		"{\"bufferView\":1,\"byteOffset\":0,\"componentType\":" + std::to_string(GLTF_UNSIGNED_INT) + ",\"count\":" + std::to_string(indices.size()) +
+		",\"type\":\"SCALAR\"}]}";
+	json.resize((json.size() + 3) & ~size_t{ 3 }, ' ');	// Chunks are 4 byte aligned, JSON pads with spaces
+
+	const size_t total = 12 + 8 + json.size() + 8 + bin_bytes;
+	if (total > std::numeric_limits<uint32_t>::max())
+		return false;
+
+	StreamWriter out(path.c_str());
+
+	// Header and chunk headers are little endian like every platform the project builds for
+	const uint32_t header[5] = { GLB_MAGIC, GLB_VERSION, static_cast<uint32_t>(total), static_cast<uint32_t>(json.size()), GLB_CHUNK_JSON };
+	out.Write(header, sizeof(header));
+	out.Write(json.data(), json.size());
+	const uint32_t bin_header[2] = { static_cast<uint32_t>(bin_bytes), GLB_CHUNK_BIN };
+	out.Write(bin_header, sizeof(bin_header));
+
+	// Interleaved straight into the writer's chunk, a chunk's worth of vertices at a time
+	constexpr size_t BATCH = (1 << 20) / GLB_STRIDE;
+	for (size_t first{}; first < positions.size() && out.Good(); first += BATCH)
+	{
+		const size_t n = std::min(BATCH, positions.size() - first);
+		char* p = out.Reserve(n * GLB_STRIDE);
+		for (size_t i = first; i < first + n; ++i)
+		{
+			std::memcpy(p, &positions[i], sizeof(glm::vec3));
+			std::memcpy(p + 12, &normals[i], sizeof(glm::vec3));
+			std::memcpy(p + 24, &colours[i], sizeof(glm::vec3));
+			p += GLB_STRIDE;
+		}
+		out.Commit(n * GLB_STRIDE);
+	}
+
+	static_assert(sizeof(unsigned int) == sizeof(uint32_t), "Indices are written as they are stored");
+	out.Write(indices.data(), index_bytes);
+
+	return out.Close();
+}
+
+bool EXPORT::WriteOBJ(Terrain const& terrain, std::string const& path)
+{
+	std::vector<glm::vec3> const& positions = terrain.GetSharedVtx();
+	std::vector<glm::vec3> const& normals = terrain.GetSharedNml();
+	std::vector<glm::vec3> const& colours = terrain.GetSharedClr();
+	std::vector<unsigned int> const& indices = terrain.GetIndices();
+	if (positions.empty() || indices.empty() || normals.size() != positions.size() || colours.size() != positions.size())
+		return false;
+
+	StreamWriter out(path.c_str());
+	const char header[] = "# TerrainGenerator\no terrain\n";
+	out.Write(header, sizeof(header) - 1);
+
+	// Upper bounds per line: 32 bytes a float, 24 an index
+	WriteLines(out, positions.size(), 2 + 6 * 33 + 1, [&](char* p, size_t i)
+	{
+		p = AppendText(p, "v ");
+		p = AppendFloat(p, positions[i].x);	*p++ = ' ';
+		p = AppendFloat(p, positions[i].y);	*p++ = ' ';
+		p = AppendFloat(p, positions[i].z);	*p++ = ' ';
+		p = AppendFloat(p, colours[i].r);	*p++ = ' ';
+		p = AppendFloat(p, colours[i].g);	*p++ = ' ';
+		p = AppendFloat(p, colours[i].b);	*p++ = '\n';
+		return p;
+	});
+
+	WriteLines(out, normals.size(), 3 + 3 * 33 + 1, [&](char* p, size_t i)
+	{
+		p = AppendText(p, "vn ");
+		p = AppendFloat(p, normals[i].x);	*p++ = ' ';
+		p = AppendFloat(p, normals[i].y);	*p++ = ' ';
+		p = AppendFloat(p, normals[i].z);	*p++ = '\n';
+		return p;
+	});
+
+	// OBJ indices start at 1, every corner uses its vertex's normal
+	WriteLines(out, indices.size() / 3, 2 + 3 * (2 * 24 + 3) + 1, [&](char* p, size_t t)
+	{
+		p = AppendText(p, "f");
+		for (size_t k{}; k < 3; ++k)
+		{
+			const size_t index = static_cast<size_t>(indices[3 * t + k]) + 1;
+			*p++ = ' ';
+			p = AppendUint(p, index);
+			p = AppendText(p, "//");
+			p = AppendUint(p, index);
+		}
+		*p++ = '\n';
+		return p;
+	});
+
+	return out.Close();
+}
+
+void EXPORT::RasteriseHeights(Terrain const& terrain, int width, int height, Heightmap& out)
+{
+	std::vector<glm::vec3> const& positions = terrain.GetSharedVtx();
+	std::vector<unsigned int> const& indices = terrain.GetIndices();
+
+	out.width = width;
+	out.height = height;
+	out.heights.clear();
+	if (positions.empty() || indices.empty() || width <= 0 || height <= 0)
+		return;
+
+	out.min = glm::vec2(std::numeric_limits<float>::max());
+	out.max = glm::vec2(std::numeric_limits<float>::lowest());
+	for (glm::vec3 const& p : positions)
+	{
+		out.min = glm::min(out.min, glm::vec2(p.x, p.z));
+		out.max = glm::max(out.max, glm::vec2(p.x, p.z));
+	}
+
+	// Pixel (i, j) is centred on (i, j) in raster space
+	const glm::dvec2 origin(out.min);
+	const glm::dvec2 extent = glm::max(glm::dvec2(out.max) - origin, glm::dvec2(1e-12));
+	const glm::dvec2 to_raster(width / extent.x, height / extent.y);
+	auto raster = [&](glm::vec3 const& p) { return (glm::dvec2(p.x, p.z) - origin) * to_raster - 0.5; };
+
+	const int tiles_x = (width + RASTER_TILE - 1) / RASTER_TILE;
+	const int tiles_y = (height + RASTER_TILE - 1) / RASTER_TILE;
+	const size_t triangle_count = indices.size() / 3;
+
+	// Pixel bounds of a triangle, false when it covers no pixel centre
+	auto bounds = [&](size_t t, int& x0, int& y0, int& x1, int& y1)
+	{
+		const glm::dvec2 a = raster(positions[indices[3 * t]]);
+		const glm::dvec2 b = raster(positions[indices[3 * t + 1]]);
+		const glm::dvec2 c = raster(positions[indices[3 * t + 2]]);
+		x0 = std::max(0, static_cast<int>(std::ceil(std::min({ a.x, b.x, c.x }))));
+		y0 = std::max(0, static_cast<int>(std::ceil(std::min({ a.y, b.y, c.y }))));
+		x1 = std::min(width - 1, static_cast<int>(std::floor(std::max({ a.x, b.x, c.x }))));
+		y1 = std::min(height - 1, static_cast<int>(std::floor(std::max({ a.y, b.y, c.y }))));
+		return x0 <= x1 && y0 <= y1;
+	};
+
+	// Bin triangles by the tiles their bounds overlap: count, prefix sum, fill
+	std::vector<uint32_t> offsets(static_cast<size_t>(tiles_x) * tiles_y + 1, 0u);
+	for (size_t t{}; t < triangle_count; ++t)
+	{
+		int x0, y0, x1, y1;
+		if (!bounds(t, x0, y0, x1, y1))
+			continue;
+		for (int ty = y0 / RASTER_TILE; ty <= y1 / RASTER_TILE; ++ty)
+			for (int tx = x0 / RASTER_TILE; tx <= x1 / RASTER_TILE; ++tx)
+				++offsets[static_cast<size_t>(ty) * tiles_x + tx + 1];
+	}
+	for (size_t i = 1; i < offsets.size(); ++i)
+		offsets[i] += offsets[i - 1];
+
+	std::vector<uint32_t> bins(offsets.back());
+	std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+	for (size_t t{}; t < triangle_count; ++t)
+	{
+		int x0, y0, x1, y1;
+		if (!bounds(t, x0, y0, x1, y1))
+			continue;
+		for (int ty = y0 / RASTER_TILE; ty <= y1 / RASTER_TILE; ++ty)
+			for (int tx = x0 / RASTER_TILE; tx <= x1 / RASTER_TILE; ++tx)
+				bins[cursor[static_cast<size_t>(ty) * tiles_x + tx]++] = static_cast<uint32_t>(t);
+	}
+
+	// NaN marks pixels no triangle reached
+	out.heights.assign(static_cast<size_t>(width) * height, std::numeric_limits<float>::quiet_NaN());
+	UTILS::ParallelFor(static_cast<size_t>(tiles_x) * tiles_y, 1, [&](size_t begin, size_t end)
+	{
+		for (size_t tile = begin; tile < end; ++tile)
+		{
+			const int tx0 = static_cast<int>(tile % tiles_x) * RASTER_TILE, ty0 = static_cast<int>(tile / tiles_x) * RASTER_TILE;
+			const int tx1 = std::min(tx0 + RASTER_TILE, width) - 1, ty1 = std::min(ty0 + RASTER_TILE, height) - 1;
+			for (uint32_t k = offsets[tile]; k < offsets[tile + 1]; ++k)
+			{
+				const size_t t = bins[k];
+				int x0, y0, x1, y1;
+				bounds(t, x0, y0, x1, y1);
+				x0 = std::max(x0, tx0);
+				y0 = std::max(y0, ty0);
+				x1 = std::min(x1, tx1);
+				y1 = std::min(y1, ty1);
+
+				glm::vec3 const& pa = positions[indices[3 * t]];
+				glm::vec3 const& pb = positions[indices[3 * t + 1]];
+				glm::vec3 const& pc = positions[indices[3 * t + 2]];
+				const glm::dvec2 a = raster(pa), b = raster(pb), c = raster(pc);
+				const double area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+				if (area == 0.0)
+					continue;
+
+				// Barycentric weights from the edge functions, with a little slack so shared edges leave no gaps
+				const double inv_area = 1.0 / area;
+				constexpr double SLACK = -1e-9;
+				for (int y = y0; y <= y1; ++y)
+				{
+					float* row = out.heights.data() + static_cast<size_t>(y) * width;
+					for (int x = x0; x <= x1; ++x)
+					{
+						const double wa = ((b.x - x) * (c.y - y) - (b.y - y) * (c.x - x)) * inv_area;
+						const double wb = ((c.x - x) * (a.y - y) - (c.y - y) * (a.x - x)) * inv_area;
+						const double wc = 1.0 - wa - wb;
+						if (wa >= SLACK && wb >= SLACK && wc >= SLACK)
+							row[x] = static_cast<float>(wa * pa.y + wb * pb.y + wc * pc.y);
+					}
+				}
+			}
+		}
+	});
+
+	out.min_height = std::numeric_limits<float>::max();
+	out.max_height = std::numeric_limits<float>::lowest();
+	for (float h : out.heights)
+	{
+		if (std::isnan(h))
+			continue;
+		out.min_height = std::min(out.min_height, h);
+		out.max_height = std::max(out.max_height, h);
+	}
+	if (out.min_height > out.max_height)
+		out.min_height = out.max_height = 0.f;
+	for (float& h : out.heights)
+		if (std::isnan(h))
+			h = out.min_height;
+}
+
+bool EXPORT::HeightmapFormatFromPath(std::string const& path, HeightmapFormat& format)
+{
+	const std::string extension = Extension(path);
+	if (extension == "png")
+		format = HeightmapFormat::PNG16;
+	else if (extension == "r32" || extension == "raw")
+		format = HeightmapFormat::R32F;
+	else
+		return false;
+	return true;
+}
+
+bool EXPORT::WriteHeightmap(Heightmap const& heightmap, std::string const& path, HeightmapFormat format)
+{
+	if (heightmap.heights.empty() || heightmap.heights.size() != static_cast<size_t>(heightmap.width) * heightmap.height)
+		return false;
+
+	if (format == HeightmapFormat::PNG16)
+		return WritePNG16(heightmap, path);
+
+	static_assert(sizeof(float) == 4, "R32F is written as it is stored");
+	StreamWriter out(path.c_str());
+	out.Write(heightmap.heights.data(), heightmap.heights.size() * sizeof(float));
+	return out.Close();
+}
@@ -0,0 +1,432 @@
+#include "FortuneVoronoi.h"
+#include "Predicates.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	// Sites closer than this in y to the first site are treated as lying on the same sweep line
+	constexpr double SAME_LINE_EPSILON = 1e-9;
+}
+
+void FortuneVoronoi::Reserve(size_t site_count)
+{
+	// Each site adds two edge halves and each circle event one more, with fewer than 2n circle events
+	m_nodes.reserve(site_count * 2);
+	m_edges.reserve(site_count * 4);
+	m_events.reserve(site_count * 2);
+	m_heap.reserve(site_count);
+	m_site_order.reserve(site_count);
+	m_output.reserve(site_count * 3);
+}
+
+std::vector<VoronoiEdge> const& FortuneVoronoi::Compute(std::vector<glm::dvec2> const& sites, double width, double height)
+{
+	m_sites = &sites;
+	m_width = width;
+	m_height = height;
+	m_root = NIL;
+
+	m_nodes.clear();
+	m_free_nodes.clear();
+	m_edges.clear();
+	m_events.clear();
+	m_heap.clear();
+	m_output.clear();
+
+	Reserve(sites.size());
+
+	// Sweep runs from the top (largest y) down
+	m_site_order.resize(sites.size());
+	for (size_t i{}; i < sites.size(); ++i)
+		m_site_order[i] = static_cast<int>(i);
+	std::sort(m_site_order.begin(), m_site_order.end(), [&sites](int a, int b)
+	{
+		return sites[a].y != sites[b].y ? sites[a].y > sites[b].y : sites[a].x < sites[b].x;
+	});
+	// A repeated site would be a zero width arc, only the first keeps a cell
+	m_site_order.erase(std::unique(m_site_order.begin(), m_site_order.end(), [&sites](int a, int b)
+	{
+		return sites[a] == sites[b];
+	}), m_site_order.end());
+
+	size_t next_site{};
+	while (next_site < m_site_order.size() || !m_heap.empty())
+	{
+		bool site_event = next_site < m_site_order.size() &&
+			(m_heap.empty() || sites[m_site_order[next_site]].y >= m_heap.front().y);
+
+		if (site_event)
+		{
+			int site = m_site_order[next_site++];
+			m_ly = sites[site].y;
+			InsertParabola(site);
+			continue;
+		}
+
+		std::pop_heap(m_heap.begin(), m_heap.end());
+		int event = m_heap.back().event;
+		m_heap.pop_back();
+
+		CircleEvent const& e = m_events[event];
+		if (m_nodes[e.arc].stamp != e.stamp)
+			continue;
+
+		m_ly = e.point.y;
+		RemoveParabola(event);
+	}
+
+	FinishEdges();
+
+	for (auto& edge : m_edges)
+	{
+		if (!edge.output)
+			continue;
+
+		if (edge.neighbour != NIL)
+			edge.start = m_edges[edge.neighbour].end;
+
+		m_output.push_back(VoronoiEdge{ edge.start, edge.end, static_cast<unsigned int>(edge.left_site), static_cast<unsigned int>(edge.right_site) });
+	}
+
+	return m_output;
+}
+
+int FortuneVoronoi::NewNode(bool leaf, int site)
+{
+	int node;
+	if (!m_free_nodes.empty())
+	{
+		node = m_free_nodes.back();
+		m_free_nodes.pop_back();
+	}
+	else
+	{
+		node = static_cast<int>(m_nodes.size());
+		m_nodes.emplace_back();
+	}
+
+	// Keep the stamp moving forward so events pointing at an earlier use of this slot stay stale
+	BeachNode& n = m_nodes[node];
+	unsigned int stamp = n.stamp + 1;
+	n = BeachNode{};
+	n.stamp = stamp;
+	n.leaf = leaf;
+	n.site = site;
+	return node;
+}
+
+void FortuneVoronoi::FreeNode(int node)
+{
+	++m_nodes[node].stamp;
+	m_free_nodes.push_back(node);
+}
+
+void FortuneVoronoi::SetLeft(int node, int child)
+{
+	m_nodes[node].left = child;
+	m_nodes[child].parent = node;
+}
+
+void FortuneVoronoi::SetRight(int node, int child)
+{
+	m_nodes[node].right = child;
+	m_nodes[child].parent = node;
+}
+
+int FortuneVoronoi::NewEdge(glm::dvec2 const& start, int left_site, int right_site)
+{
+	glm::dvec2 const& a = (*m_sites)[left_site];
+	glm::dvec2 const& b = (*m_sites)[right_site];
+
+	Edge edge;
+	edge.start = start;
+	edge.left_site = left_site;
+	edge.right_site = right_site;
+	edge.direction = glm::dvec2(b.y - a.y, -(b.x - a.x));
+
+	m_edges.push_back(edge);
+	return static_cast<int>(m_edges.size() - 1);
+}
+
+void FortuneVoronoi::CancelCircle(int arc)
+{
+	++m_nodes[arc].stamp;
+}
+
+void FortuneVoronoi::InsertParabola(int site)
+{
+	glm::dvec2 const& p = (*m_sites)[site];
+
+	if (m_root == NIL)
+	{
+		m_root = NewNode(true, site);
+		return;
+	}
+
+	int par = GetParabolaByX(p.x);
+	int par_site = m_nodes[par].site;
+
+	if ((*m_sites)[m_site_order[0]].y - p.y < SAME_LINE_EPSILON * (m_width + m_height))
+	{
+		// Degenerate start, the first sites share the sweep line so their bisectors are vertical. They come in order
+		// of x, each next to the last arc, which becomes the breakpoint between the two.
+		glm::dvec2 const& f = (*m_sites)[par_site];
+
+		int left_site = p.x > f.x ? par_site : site;
+		int right_site = p.x > f.x ? site : par_site;
+
+		m_nodes[par].leaf = false;
+		m_nodes[par].site = NIL;
+		int l = NewNode(true, left_site);
+		int r = NewNode(true, right_site);
+		SetLeft(par, l);
+		SetRight(par, r);
+
+		glm::dvec2 start((p.x + f.x) / 2.0, m_height);
+		m_nodes[par].edge = NewEdge(start, left_site, right_site);
+		return;
+	}
+
+	CancelCircle(par);
+
+	glm::dvec2 start(p.x, GetY(par_site, p.x));
+
+	int el = NewEdge(start, par_site, site);
+	int er = NewEdge(start, site, par_site);
+	m_edges[el].neighbour = er;
+	m_edges[er].output = false;
+
+	// Split the arc: par becomes the right breakpoint, a new inner node the left one
+	m_nodes[par].edge = er;
+	m_nodes[par].leaf = false;
+	m_nodes[par].site = NIL;
+
+	int p0 = NewNode(true, par_site);
+	int p1 = NewNode(true, site);
+	int p2 = NewNode(true, par_site);
+	int inner = NewNode(false, NIL);
+
+	SetRight(par, p2);
+	SetLeft(par, inner);
+	m_nodes[inner].edge = el;
+	SetLeft(inner, p0);
+	SetRight(inner, p1);
+
+	CheckCircle(p0);
+	CheckCircle(p2);
+}
+
+void FortuneVoronoi::RemoveParabola(int event)
+{
+	int p1 = m_events[event].arc;
+
+	int xl = GetLeftParent(p1);
+	int xr = GetRightParent(p1);
+	int p0 = GetLeftChild(xl);
+	int p2 = GetRightChild(xr);
+
+	CancelCircle(p0);
+	CancelCircle(p2);
+
+	glm::dvec2 p = m_events[event].centre;
+
+	m_edges[m_nodes[xl].edge].end = p;
+	m_edges[m_nodes[xr].edge].end = p;
+
+	// The higher of the two breakpoints survives and starts tracing the new edge
+	int higher = NIL;
+	for (int node = p1; node != m_root;)
+	{
+		node = m_nodes[node].parent;
+		if (node == xl) higher = xl;
+		if (node == xr) higher = xr;
+	}
+	if (higher == NIL)
+		return;
+
+	m_nodes[higher].edge = NewEdge(p, m_nodes[p0].site, m_nodes[p2].site);
+
+	int parent = m_nodes[p1].parent;
+	int gparent = m_nodes[parent].parent;
+	int sibling = m_nodes[parent].left == p1 ? m_nodes[parent].right : m_nodes[parent].left;
+
+	if (m_nodes[gparent].left == parent)
+		SetLeft(gparent, sibling);
+	else
+		SetRight(gparent, sibling);
+
+	FreeNode(parent);
+	FreeNode(p1);
+
+	CheckCircle(p0);
+	CheckCircle(p2);
+}
+
+void FortuneVoronoi::FinishEdges()
+{
+	if (m_root == NIL)
+		return;
+
+	// Close every edge still traced by the beachline just outside the box
+	m_stack.clear();
+	m_stack.push_back(m_root);
+	while (!m_stack.empty())
+	{
+		int node = m_stack.back();
+		m_stack.pop_back();
+
+		if (m_nodes[node].leaf)
+			continue;
+
+		// Along the edge's direction from its start, far enough to leave the box from anywhere
+		Edge& edge = m_edges[m_nodes[node].edge];
+		double reach = glm::length(edge.start - 0.5 * glm::dvec2(m_width, m_height)) + m_width + m_height;
+		edge.end = edge.start + edge.direction * (reach / glm::length(edge.direction));
+
+		m_stack.push_back(m_nodes[node].left);
+		m_stack.push_back(m_nodes[node].right);
+	}
+}
+
+void FortuneVoronoi::CheckCircle(int arc)
+{
+	int lp = GetLeftParent(arc);
+	int rp = GetRightParent(arc);
+	int a = GetLeftChild(lp);
+	int c = GetRightChild(rp);
+
+	if (a == NIL || c == NIL || m_nodes[a].site == m_nodes[c].site)
+		return;
+
+	// The breakpoints either side of the arc converge exactly when its left, own and right sites turn clockwise.
+	// Taken from the sites with the exact predicate, not from intersecting the traced edges, which loses all
+	// precision once a bisector is close to vertical.
+	glm::dvec2 const& pa = (*m_sites)[m_nodes[a].site];
+	glm::dvec2 const& pb = (*m_sites)[m_nodes[arc].site];
+	glm::dvec2 const& pc = (*m_sites)[m_nodes[c].site];
+	if (PREDICATES::Orient2D(pa.x, pa.y, pb.x, pb.y, pc.x, pc.y) >= 0.0)
+		return;
+
+	// Circumcentre relative to the middle site
+	glm::dvec2 ab = pa - pb, cb = pc - pb;
+	double den = 2.0 * (ab.x * cb.y - ab.y * cb.x);
+	if (den == 0.0)
+		return;
+	double ab2 = glm::dot(ab, ab), cb2 = glm::dot(cb, cb);
+	glm::dvec2 s = pb + glm::dvec2(cb.y * ab2 - ab.y * cb2, ab.x * cb2 - cb.x * ab2) / den;
+
+	// Converging breakpoints put the bottom at or below the sweep line. Right at it the arc has zero length, from a
+	// site just under a breakpoint, and still has to go, so rounding must not leave the bottom above.
+	double d = glm::length(pb - s);
+
+	CircleEvent e;
+	e.centre = s;
+	e.point = glm::dvec2(s.x, std::min(s.y - d, m_ly));
+	e.arc = arc;
+	e.stamp = m_nodes[arc].stamp;
+	m_events.push_back(e);
+
+	m_heap.push_back(HeapEntry{ e.point.y, static_cast<int>(m_events.size() - 1) });
+	std::push_heap(m_heap.begin(), m_heap.end());
+}
+
+double FortuneVoronoi::GetXOfEdge(int node, double y) const
+{
+	// The breakpoint's edge records the arcs on either side, no need to walk down to the neighbouring leaves
+	Edge const& edge = m_edges[m_nodes[node].edge];
+	glm::dvec2 const& p = (*m_sites)[edge.left_site];
+	glm::dvec2 const& r = (*m_sites)[edge.right_site];
+
+	// A site on the sweep line is still a vertical ray, the breakpoint is straight above it, or halfway between two
+	if (p.y == r.y)
+		return 0.5 * (p.x + r.x);
+	if (p.y == y)
+		return p.x;
+	if (r.y == y)
+		return r.x;
+
+	// Where the parabolas cross with the left one going under, relative to the left site. With k and l the sites'
+	// heights over the sweep line that is t = (s - k dx) / (l - k), s = sqrt(k l) |r - p|; multiplied out as
+	// k (dx^2 + l (l - k)) / (s + k dx) when dx >= 0, which stays exact for sites at the same height.
+	double k = p.y - y, l = r.y - y;
+	double dx = r.x - p.x;
+	double s = std::sqrt(k * l) * glm::length(r - p);
+	if (dx >= 0.0)
+		return p.x + k * (dx * dx + l * (l - k)) / (s + k * dx);
+	return p.x + (s - k * dx) / (l - k);
+}
+
+int FortuneVoronoi::GetParabolaByX(double x) const
+{
+	int node = m_root;
+	while (!m_nodes[node].leaf)
+		node = GetXOfEdge(node, m_ly) > x ? m_nodes[node].left : m_nodes[node].right;
+	return node;
+}
+
+double FortuneVoronoi::GetY(int site, double x) const
+{
+	glm::dvec2 const& p = (*m_sites)[site];
+
+	// A site on the sweep line has collapsed to a vertical ray, nothing below it but the site itself
+	double dp = 2.0 * (p.y - m_ly);
+	if (dp == 0.0)
+		return p.y;
+	double a1 = 1.0 / dp;
+	double b1 = -2.0 * p.x / dp;
+	double c1 = m_ly + dp / 4.0 + p.x * p.x / dp;
+
+	return a1 * x * x + b1 * x + c1;
+}
+
+int FortuneVoronoi::GetLeftParent(int node) const
+{
+	int last = node;
+	int par = m_nodes[node].parent;
+	while (m_nodes[par].left == last)
+	{
+		if (m_nodes[par].parent == NIL)
+			return NIL;
+		last = par;
+		par = m_nodes[par].parent;
+	}
+	return par;
+}
+
+int FortuneVoronoi::GetRightParent(int node) const
+{
+	int last = node;
+	int par = m_nodes[node].parent;
+	while (m_nodes[par].right == last)
+	{
+		if (m_nodes[par].parent == NIL)
+			return NIL;
+		last = par;
+		par = m_nodes[par].parent;
+	}
+	return par;
+}
+
+int FortuneVoronoi::GetLeftChild(int node) const
+{
+	if (node == NIL)
+		return NIL;
+
+	int child = m_nodes[node].left;
+	while (!m_nodes[child].leaf)
+		child = m_nodes[child].right;
+	return child;
+}
+
+int FortuneVoronoi::GetRightChild(int node) const
+{
+	if (node == NIL)
+		return NIL;
+
+	int child = m_nodes[node].right;
+	while (!m_nodes[child].leaf)
+		child = m_nodes[child].left;
+	return child;
+}
@@ -0,0 +1,924 @@
+#include "HalfEdgeMesh.h"
+#include "triangulation.h"
+#include "Predicates.h"
+#include "CustomMath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace
+{
+	constexpr unsigned int HILBERT_ORDER = 16;
+	constexpr unsigned int BRIO_ROUNDS = 16;
+
+	// Position along a Hilbert curve over a 2^HILBERT_ORDER grid
+	uint32_t HilbertIndex(uint32_t x, uint32_t y)
+	{
+		const uint32_t n = 1u << HILBERT_ORDER;
+		uint32_t d{};
+		for (uint32_t s = n / 2; s > 0; s /= 2)
+		{
+			uint32_t rx = (x & s) > 0;
+			uint32_t ry = (y & s) > 0;
+			d += s * s * ((3 * rx) ^ ry);
+
+			if (ry == 0)
+			{
+				if (rx == 1)
+				{
+					x = n - 1 - x;
+					y = n - 1 - y;
+				}
+				std::swap(x, y);
+			}
+		}
+		return d;
+	}
+
+	// Deterministic stand-in for BRIO's coin flips, a point lands in the last round with probability 1/2,
+	// the one before with 1/4 and so on
+	uint32_t BrioRound(uint32_t i)
+	{
+		i ^= i >> 16;
+		i *= 0x7feb352du;
+		i ^= i >> 15;
+		i *= 0x846ca68bu;
+		i ^= i >> 16;
+
+		uint32_t trailing{};
+		while (trailing < BRIO_ROUNDS - 1 && (i & 1u))
+		{
+			i >>= 1;
+			++trailing;
+		}
+		return BRIO_ROUNDS - 1 - trailing;
+	}
+}
+
+void HalfEdgeMesh::Triangulate(UTILS::Span<const glm::vec2> pts, std::pmr::memory_resource* scratch)
+{
+	Clear();
+	points.assign(pts.begin(), pts.end());
+
+	if (points.size() < 3)
+		return;
+
+	std::pmr::vector<double> coords(scratch);
+	coords.reserve(points.size() * 2);
+	for (auto const& p : points)
+	{
+		coords.push_back(static_cast<double>(p.x));
+		coords.push_back(static_cast<double>(p.y));
+	}
+
+	delaunator::Delaunator d(coords, scratch);
+
+	// Narrow to 32-bit indices, delaunator's INVALID_INDEX maps onto NONE
+	triangles.resize(d.triangles.size());
+	halfedges.resize(d.halfedges.size());
+	constrained.assign(d.triangles.size(), 0);
+	for (size_t e{}; e < d.triangles.size(); ++e)
+	{
+		triangles[e] = static_cast<unsigned int>(d.triangles[e]);
+		halfedges[e] = d.halfedges[e] == delaunator::INVALID_INDEX ? NONE : static_cast<unsigned int>(d.halfedges[e]);
+	}
+
+	size_t v = d.hull_start;
+	do
+	{
+		hull.push_back(static_cast<unsigned int>(v));
+		v = d.hull_next[v];
+	} while (v != d.hull_start);
+
+	BuildIncoming();
+}
+
+void HalfEdgeMesh::Clear()
+{
+	points.clear();
+	triangles.clear();
+	halfedges.clear();
+	incoming.clear();
+	hull.clear();
+	constrained.clear();
+	m_last = 0;
+}
+
+void HalfEdgeMesh::BuildIncoming()
+{
+	// Points dropped as near-duplicates keep NONE
+	incoming.assign(points.size(), NONE);
+
+	for (unsigned int e{}; e < triangles.size(); ++e)
+	{
+		unsigned int v = triangles[Next(e)];
+		if (halfedges[e] == NONE || incoming[v] == NONE)
+			incoming[v] = e;
+	}
+}
+
+unsigned int HalfEdgeMesh::Neighbour(unsigned int triangle, unsigned int k) const
+{
+	unsigned int twin = halfedges[triangle * 3 + k];
+	return twin == NONE ? NONE : TriangleOf(twin);
+}
+
+void HalfEdgeMesh::VertexNeighbours(unsigned int vertex, std::vector<unsigned int>& vertices) const
+{
+	vertices.clear();
+
+	unsigned int start = incoming[vertex];
+	if (start == NONE)
+		return;
+
+	unsigned int e = start;
+	do
+	{
+		vertices.push_back(triangles[e]);
+		unsigned int out = Next(e);
+		e = halfedges[out];
+
+		// Open fan, the last outgoing hull edge leads to one more neighbour
+		if (e == NONE)
+			vertices.push_back(triangles[Next(out)]);
+	} while (e != start && e != NONE);
+}
+
+unsigned int HalfEdgeMesh::Locate(glm::vec2 const& p, unsigned int hint) const
+{
+	if (triangles.empty())
+		return NONE;
+
+	unsigned int t = hint < TriangleCount() ? hint : 0;
+
+	// Walk across any edge with p on its outer side, starting each triangle at a rotating edge
+	// so the walk cannot cycle on degenerate configurations
+	unsigned int rotate{};
+	for (size_t steps{}; steps < triangles.size(); ++steps)
+	{
+		unsigned int next = NONE;
+		for (unsigned int i{}; i < 3; ++i)
+		{
+			unsigned int e = t * 3 + (i + rotate) % 3;
+			glm::vec2 const& a = points[triangles[e]];
+			glm::vec2 const& b = points[triangles[Next(e)]];
+
+			// Triangles are clockwise, so p is outside when it lies left of a -> b
+			if (PREDICATES::Orient2D(a.x, a.y, b.x, b.y, p.x, p.y) > 0.0)
+			{
+				next = halfedges[e];
+				if (next == NONE)
+					return NONE;
+				break;
+			}
+		}
+
+		if (next == NONE)
+			return t;
+
+		t = TriangleOf(next);
+		rotate = (rotate + 1) % 3;
+	}
+
+	return NONE;
+}
+
+void HalfEdgeMesh::Smooth(std::vector<float>& values, unsigned int iterations, float lambda) const
+{
+	std::vector<float> next(values.size());
+	std::vector<unsigned int> ring;
+
+	for (unsigned int it{}; it < iterations; ++it)
+	{
+		for (unsigned int v{}; v < values.size(); ++v)
+		{
+			VertexNeighbours(v, ring);
+			if (ring.empty())
+			{
+				next[v] = values[v];
+				continue;
+			}
+
+			float sum{};
+			for (unsigned int n : ring)
+				sum += values[n];
+			next[v] = values[v] + lambda * (sum / static_cast<float>(ring.size()) - values[v]);
+		}
+		values.swap(next);
+	}
+}
+
+unsigned int HalfEdgeMesh::Insert(glm::vec2 const& p)
+{
+	unsigned int t = Locate(p, m_last);
+	if (t == NONE)
+		return NONE;
+
+	for (unsigned int k{}; k < 3; ++k)
+		if (points[triangles[t * 3 + k]] == p)
+			return triangles[t * 3 + k];
+
+	// Cavity: t plus every triangle reachable over the adjacency whose circumcircle strictly holds p.
+	// The test does not depend on which neighbour reached a triangle, so a rejected edge stays on the boundary.
+	// Constrained edges are walls unless p lies on one, in which case it is split.
+	unsigned int split_a = NONE, split_b = NONE;
+	m_cavity.assign(1, t);
+	m_boundary.clear();
+	for (size_t i{}; i < m_cavity.size(); ++i)
+	{
+		unsigned int c = m_cavity[i];
+		for (unsigned int e = c * 3; e < c * 3 + 3; ++e)
+		{
+			unsigned int twin = halfedges[e];
+			bool on_edge = false;
+			if (twin == NONE || constrained[e])
+			{
+				glm::vec2 const& pa = points[triangles[e]];
+				glm::vec2 const& pb = points[triangles[Next(e)]];
+				on_edge = PREDICATES::Orient2D(pa.x, pa.y, pb.x, pb.y, p.x, p.y) == 0.0;
+				if (on_edge && constrained[e])
+				{
+					split_a = triangles[e];
+					split_b = triangles[Next(e)];
+				}
+			}
+
+			if (twin == NONE || (constrained[e] && !on_edge))
+			{
+				m_boundary.push_back(e);
+				continue;
+			}
+
+			unsigned int n = TriangleOf(twin);
+			if (std::find(m_cavity.begin(), m_cavity.end(), n) != m_cavity.end())
+				continue;
+
+			// Triangles are clockwise, InCircle expects counter-clockwise
+			glm::vec2 const& a = points[triangles[n * 3]];
+			glm::vec2 const& b = points[triangles[n * 3 + 1]];
+			glm::vec2 const& c2 = points[triangles[n * 3 + 2]];
+			if (on_edge || PREDICATES::InCircle(a.x, a.y, c2.x, c2.y, b.x, b.y, p.x, p.y) > 0.0)
+				m_cavity.push_back(n);
+			else
+				m_boundary.push_back(e);
+		}
+	}
+
+	unsigned int v = static_cast<unsigned int>(points.size());
+	points.push_back(p);
+	incoming.push_back(NONE);
+
+	// Fan triangles (a, b, v) for each boundary edge a -> b, keeping the twin on the far side and its constraint.
+	// A hull edge with p on it gets no triangle, it is split in two by the fan instead.
+	unsigned int hull_a = NONE, hull_b = NONE;
+	m_fan.clear();
+	for (unsigned int e : m_boundary)
+	{
+		unsigned int a = triangles[e];
+		unsigned int b = triangles[Next(e)];
+		if (halfedges[e] == NONE)
+		{
+			glm::vec2 const& pa = points[a];
+			glm::vec2 const& pb = points[b];
+			if (PREDICATES::Orient2D(pa.x, pa.y, pb.x, pb.y, p.x, p.y) == 0.0)
+			{
+				hull_a = a;
+				hull_b = b;
+				continue;
+			}
+		}
+		m_fan.push_back(a);
+		m_fan.push_back(b);
+		m_fan.push_back(halfedges[e]);
+		m_fan.push_back(constrained[e]);
+	}
+
+	// Vertices whose incoming half-edge is about to be overwritten pick a new one below
+	for (unsigned int c : m_cavity)
+		for (unsigned int k{}; k < 3; ++k)
+		{
+			unsigned int u = triangles[c * 3 + k];
+			if (incoming[u] != NONE && std::find(m_cavity.begin(), m_cavity.end(), TriangleOf(incoming[u])) != m_cavity.end())
+				incoming[u] = NONE;
+		}
+
+	// The fan always has at least as many triangles as the cavity, reuse its slots first
+	size_t fan_count = m_fan.size() / 4;
+	for (size_t i{}; i < fan_count; ++i)
+	{
+		unsigned int slot;
+		if (i < m_cavity.size())
+			slot = m_cavity[i];
+		else
+		{
+			slot = static_cast<unsigned int>(TriangleCount());
+			triangles.resize(triangles.size() + 3);
+			halfedges.resize(halfedges.size() + 3);
+			constrained.resize(constrained.size() + 3);
+		}
+
+		unsigned int e = slot * 3;
+		unsigned int outer = m_fan[i * 4 + 2];
+		triangles[e] = m_fan[i * 4];
+		triangles[e + 1] = m_fan[i * 4 + 1];
+		triangles[e + 2] = v;
+		halfedges[e] = outer;
+		halfedges[e + 1] = NONE;
+		halfedges[e + 2] = NONE;
+		constrained[e] = static_cast<unsigned char>(m_fan[i * 4 + 3]);
+		constrained[e + 1] = 0;
+		constrained[e + 2] = 0;
+		if (outer != NONE)
+			halfedges[outer] = e;
+
+		// The outer twin is linked, its entry now remembers where the triangle went
+		m_fan[i * 4 + 2] = slot;
+	}
+
+	// b -> v of one fan triangle is twin to v -> a of the fan triangle starting at that b
+	for (size_t i{}; i < fan_count; ++i)
+		for (size_t j{}; j < fan_count; ++j)
+			if (m_fan[j * 4] == m_fan[i * 4 + 1])
+			{
+				unsigned int from = m_fan[i * 4 + 2] * 3 + 1;
+				unsigned int to = m_fan[j * 4 + 2] * 3 + 2;
+				halfedges[from] = to;
+				halfedges[to] = from;
+				break;
+			}
+
+	// Same preference as BuildIncoming: hull edges win so fan walks stay complete
+	for (size_t i{}; i < fan_count; ++i)
+		for (unsigned int e = m_fan[i * 4 + 2] * 3; e < m_fan[i * 4 + 2] * 3 + 3; ++e)
+		{
+			unsigned int u = triangles[Next(e)];
+			if (incoming[u] == NONE || halfedges[e] == NONE)
+				incoming[u] = e;
+		}
+
+	if (hull_a != NONE)
+	{
+		for (size_t i{}; i < hull.size(); ++i)
+		{
+			size_t next = (i + 1) % hull.size();
+			if ((hull[i] == hull_a && hull[next] == hull_b) || (hull[i] == hull_b && hull[next] == hull_a))
+			{
+				hull.insert(hull.begin() + next, v);
+				break;
+			}
+		}
+	}
+
+	// Both halves of a split constraint stay constrained
+	if (split_a != NONE)
+	{
+		for (size_t i{}; i < fan_count; ++i)
+		{
+			unsigned int e = m_fan[i * 4 + 2] * 3;
+			if (m_fan[i * 4] == split_a || m_fan[i * 4] == split_b)
+				SetConstrained(e + 2);
+			if (m_fan[i * 4 + 1] == split_a || m_fan[i * 4 + 1] == split_b)
+				SetConstrained(e + 1);
+		}
+	}
+
+	m_last = m_fan[2];
+	return v;
+}
+
+void HalfEdgeMesh::Insert(std::vector<glm::vec2> const& pts)
+{
+	if (pts.empty())
+		return;
+
+	glm::vec2 lo = pts[0], hi = pts[0];
+	for (auto const& p : pts)
+	{
+		lo = glm::min(lo, p);
+		hi = glm::max(hi, p);
+	}
+	glm::vec2 scale = static_cast<float>((1u << HILBERT_ORDER) - 1) / glm::max(hi - lo, glm::vec2(std::numeric_limits<float>::min()));
+
+	// Round in the high word, curve position in the low word
+	std::vector<std::pair<uint64_t, unsigned int>> order(pts.size());
+	for (unsigned int i{}; i < pts.size(); ++i)
+	{
+		glm::vec2 q = (pts[i] - lo) * scale;
+		uint64_t key = static_cast<uint64_t>(BrioRound(i)) << 32 | HilbertIndex(static_cast<uint32_t>(q.x), static_cast<uint32_t>(q.y));
+		order[i] = { key, i };
+	}
+	std::sort(order.begin(), order.end());
+
+	points.reserve(points.size() + pts.size());
+	incoming.reserve(incoming.size() + pts.size());
+	triangles.reserve(triangles.size() + pts.size() * 6);
+	halfedges.reserve(halfedges.size() + pts.size() * 6);
+
+	for (auto const& entry : order)
+		Insert(pts[entry.second]);
+}
+
+void HalfEdgeMesh::SetConstrained(unsigned int e)
+{
+	constrained[e] = 1;
+	if (halfedges[e] != NONE)
+		constrained[halfedges[e]] = 1;
+}
+
+unsigned int HalfEdgeMesh::FindEdge(unsigned int a, unsigned int b) const
+{
+	unsigned int start = incoming[a];
+	if (start == NONE)
+		return NONE;
+
+	// Incoming half-edges of a run x -> a, the outgoing a -> y of the same triangle follows.
+	// On the hull the fan is open: incoming[a] is the hull edge x -> a, which has no a -> x to find.
+	unsigned int e = start;
+	do
+	{
+		unsigned int out = Next(e);
+		if (triangles[Next(out)] == b)
+			return out;
+		if (triangles[e] == b && halfedges[e] == NONE)
+			return e;
+		e = halfedges[out];
+	} while (e != start && e != NONE);
+
+	return NONE;
+}
+
+void HalfEdgeMesh::Flip(unsigned int e)
+{
+	//   Before: (a, b, c) holds e = a -> b, (b, a, d) holds t = b -> a
+	//   After:  (d, c, a) holds e = d -> c, (c, d, b) holds t = c -> d
+	unsigned int t = halfedges[e];
+	unsigned int e1 = Next(e), e2 = Prev(e);
+	unsigned int t1 = Next(t), t2 = Prev(t);
+
+	unsigned int a = triangles[e], b = triangles[e1], c = triangles[e2], d = triangles[t2];
+
+	unsigned int oe1 = halfedges[e1], oe2 = halfedges[e2], ot1 = halfedges[t1], ot2 = halfedges[t2];
+	unsigned char ce1 = constrained[e1], ce2 = constrained[e2], ct1 = constrained[t1], ct2 = constrained[t2];
+
+	triangles[e] = d; triangles[e1] = c; triangles[e2] = a;
+	triangles[t] = c; triangles[t1] = d; triangles[t2] = b;
+
+	auto link = [this](unsigned int x, unsigned int y)
+	{
+		halfedges[x] = y;
+		if (y != NONE)
+			halfedges[y] = x;
+	};
+	link(e1, oe2);
+	link(e2, ot1);
+	link(t1, ot2);
+	link(t2, oe1);
+
+	constrained[e] = constrained[t] = 0;
+	constrained[e1] = ce2;
+	constrained[e2] = ct1;
+	constrained[t1] = ct2;
+	constrained[t2] = ce1;
+
+	// Half-edges now ending at each vertex: a <- e1, b <- t1, c <- e or t2, d <- e2 or t
+	auto in_quad = [&](unsigned int x) { return x == e || x == e1 || x == e2 || x == t || x == t1 || x == t2; };
+	if (in_quad(incoming[a])) incoming[a] = e1;
+	if (in_quad(incoming[b])) incoming[b] = t1;
+	if (in_quad(incoming[c])) incoming[c] = halfedges[t2] == NONE ? t2 : e;
+	if (in_quad(incoming[d])) incoming[d] = halfedges[e2] == NONE ? e2 : t;
+}
+
+bool HalfEdgeMesh::IsLocallyDelaunay(unsigned int e) const
+{
+	unsigned int t = halfedges[e];
+	if (t == NONE || constrained[e])
+		return true;
+
+	glm::vec2 const& a = points[triangles[e]];
+	glm::vec2 const& b = points[triangles[Next(e)]];
+	glm::vec2 const& c = points[triangles[Prev(e)]];
+	glm::vec2 const& d = points[triangles[Prev(t)]];
+
+	// Clockwise (a, b, c) is counter-clockwise as (a, c, b)
+	return PREDICATES::InCircle(a.x, a.y, c.x, c.y, b.x, b.y, d.x, d.y) <= 0.0;
+}
+
+void HalfEdgeMesh::Legalize()
+{
+	// Lawson flips from the edges in m_new_edges outwards, constrained edges are never flipped
+	while (!m_new_edges.empty())
+	{
+		unsigned int e = m_new_edges.back();
+		m_new_edges.pop_back();
+
+		if (IsLocallyDelaunay(e))
+			continue;
+
+		unsigned int t = halfedges[e];
+		Flip(e);
+		m_new_edges.push_back(Next(e));
+		m_new_edges.push_back(Prev(e));
+		m_new_edges.push_back(Next(t));
+		m_new_edges.push_back(Prev(t));
+	}
+}
+
+bool HalfEdgeMesh::InsertSegment(unsigned int a, unsigned int b)
+{
+	if (a == b || incoming[a] == NONE || incoming[b] == NONE)
+		return false;
+
+	unsigned int existing = FindEdge(a, b);
+	if (existing != NONE)
+	{
+		SetConstrained(existing);
+		return true;
+	}
+
+	glm::vec2 const pa = points[a];
+	glm::vec2 const pb = points[b];
+	auto orient = [&](unsigned int v)
+	{
+		return PREDICATES::Orient2D(pa.x, pa.y, pb.x, pb.y, points[v].x, points[v].y);
+	};
+
+	// Find the triangle around a that the segment leaves through, its edge opposite a is the first crossing
+	unsigned int crossing = NONE;
+	unsigned int start = incoming[a];
+	unsigned int in = start;
+	do
+	{
+		unsigned int out = Next(in);		// a -> y
+		unsigned int x = triangles[in];
+		unsigned int y = triangles[Next(out)];
+
+		// b itself next to a: the edge exists, whatever FindEdge made of it
+		if (y == b)
+		{
+			SetConstrained(out);
+			return true;
+		}
+		if (x == b)
+		{
+			SetConstrained(in);
+			return true;
+		}
+
+		double oy = orient(y), ox = orient(x);
+		if (oy == 0.0 && glm::dot(points[y] - pa, pb - pa) > 0.f)
+			return InsertSegment(a, y) && InsertSegment(y, b);
+		if (ox == 0.0 && glm::dot(points[x] - pa, pb - pa) > 0.f)
+			return InsertSegment(a, x) && InsertSegment(x, b);
+
+		// Clockwise (a, y, x): b is inside the wedge when it is right of a -> y and left of a -> x
+		if (oy > 0.0 && ox < 0.0)
+		{
+			crossing = Prev(in);		// y -> x
+			break;
+		}
+		in = halfedges[out];
+	} while (in != start && in != NONE);
+
+	if (crossing == NONE)
+		return false;
+
+	// Collect every edge crossed on the way to b, splitting at vertices that lie on the segment
+	// Edges are kept as vertex pairs, a flip moves the outer edges of its quad to other half-edge slots
+	m_crossing.clear();
+	while (true)
+	{
+		if (constrained[crossing] || halfedges[crossing] == NONE)
+			return false;
+		m_crossing.push_back(triangles[crossing]);
+		m_crossing.push_back(triangles[Next(crossing)]);
+
+		unsigned int g = halfedges[crossing];
+		unsigned int z = triangles[Prev(g)];
+		if (z == b)
+			break;
+
+		double oz = orient(z);
+		if (oz == 0.0)
+			return InsertSegment(a, z) && InsertSegment(z, b);
+
+		// Across g = p -> q the triangle is (p, q, z); with z on p's side the segment leaves through q -> z
+		double ox = orient(triangles[g]);
+		crossing = (oz > 0.0) == (ox > 0.0) ? Next(g) : Prev(g);
+	}
+
+	// Flip crossing edges away; a flip is only legal in a strictly convex quad, otherwise retry later
+	m_created.clear();
+	size_t head{};
+	while (head < m_crossing.size())
+	{
+		unsigned int u = m_crossing[head++];
+		unsigned int w = m_crossing[head++];
+		unsigned int e = FindEdge(u, w);
+		unsigned int t = halfedges[e];
+		glm::vec2 const& qa = points[triangles[e]];
+		glm::vec2 const& qb = points[triangles[Next(e)]];
+		glm::vec2 const& qc = points[triangles[Prev(e)]];
+		glm::vec2 const& qd = points[triangles[Prev(t)]];
+
+		double oa = PREDICATES::Orient2D(qc.x, qc.y, qd.x, qd.y, qa.x, qa.y);
+		double ob = PREDICATES::Orient2D(qc.x, qc.y, qd.x, qd.y, qb.x, qb.y);
+		if (!((oa > 0.0 && ob < 0.0) || (oa < 0.0 && ob > 0.0)))
+		{
+			m_crossing.push_back(u);
+			m_crossing.push_back(w);
+			continue;
+		}
+
+		Flip(e);
+
+		// The new diagonal still crosses when it and the segment straddle each other's lines
+		unsigned int c = triangles[e], d = triangles[Next(e)];
+		glm::vec2 const& pc = points[c];
+		glm::vec2 const& pd = points[d];
+		double oc = orient(c), od = orient(d);
+		double sa = PREDICATES::Orient2D(pc.x, pc.y, pd.x, pd.y, pa.x, pa.y);
+		double sb = PREDICATES::Orient2D(pc.x, pc.y, pd.x, pd.y, pb.x, pb.y);
+		bool crosses = ((oc > 0.0 && od < 0.0) || (oc < 0.0 && od > 0.0)) && ((sa > 0.0 && sb < 0.0) || (sa < 0.0 && sb > 0.0));
+		if (crosses)
+		{
+			m_crossing.push_back(c);
+			m_crossing.push_back(d);
+		}
+		else if (!((c == a && d == b) || (c == b && d == a)))
+		{
+			m_created.push_back(c);
+			m_created.push_back(d);
+		}
+	}
+
+	m_new_edges.clear();
+	for (size_t i{}; i < m_created.size(); i += 2)
+		m_new_edges.push_back(FindEdge(m_created[i], m_created[i + 1]));
+
+	SetConstrained(FindEdge(a, b));
+	Legalize();
+	return true;
+}
+
+bool HalfEdgeMesh::InsertPolyline(std::vector<glm::vec2> const& polyline)
+{
+	std::vector<unsigned int> vertices;
+	vertices.reserve(polyline.size());
+	for (auto const& p : polyline)
+	{
+		unsigned int v = Insert(p);
+		if (v == NONE)
+			return false;
+		vertices.push_back(v);
+	}
+
+	bool ok = true;
+	for (size_t i = 1; i < vertices.size(); ++i)
+		ok = InsertSegment(vertices[i - 1], vertices[i]) && ok;
+	return ok;
+}
+
+bool HalfEdgeMesh::IsSkinny(unsigned int t, double sin2_bound) const
+{
+	glm::dvec2 a = points[triangles[t * 3]];
+	glm::dvec2 b = points[triangles[t * 3 + 1]];
+	glm::dvec2 c = points[triangles[t * 3 + 2]];
+
+	double ab = glm::dot(b - a, b - a);
+	double bc = glm::dot(c - b, c - b);
+	double ca = glm::dot(a - c, a - c);
+	double area2 = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+
+	// sin of the smallest angle is shortest / (2 * circumradius), and the circumradius is ab * bc * ca / (2 * area2).
+	// Squared on both sides so only adds and multiplies decide it.
+	return std::min({ ab, bc, ca }) * (area2 * area2) < sin2_bound * ab * bc * ca;
+}
+
+unsigned int HalfEdgeMesh::BlockingSegment(unsigned int t, glm::vec2 const& c) const
+{
+	glm::vec2 g = (points[triangles[t * 3]] + points[triangles[t * 3 + 1]] + points[triangles[t * 3 + 2]]) / 3.f;
+
+	// Straight walk from the centroid of t towards c, leaving each triangle through the edge the walk line crosses
+	for (size_t steps{}; steps < triangles.size(); ++steps)
+	{
+		unsigned int exit = NONE;
+		for (unsigned int e = t * 3; e < t * 3 + 3; ++e)
+		{
+			glm::vec2 const& pa = points[triangles[e]];
+			glm::vec2 const& pb = points[triangles[Next(e)]];
+			if (PREDICATES::Orient2D(pa.x, pa.y, pb.x, pb.y, c.x, c.y) <= 0.0)
+				continue;
+
+			double oa = PREDICATES::Orient2D(g.x, g.y, c.x, c.y, pa.x, pa.y);
+			double ob = PREDICATES::Orient2D(g.x, g.y, c.x, c.y, pb.x, pb.y);
+			if ((oa > 0.0 && ob > 0.0) || (oa < 0.0 && ob < 0.0))
+				continue;
+
+			exit = e;
+			break;
+		}
+
+		if (exit == NONE)
+		{
+			// c is inside t, a segment of t still blocks it when c is inside its diametral circle
+			for (unsigned int e = t * 3; e < t * 3 + 3; ++e)
+			{
+				if (halfedges[e] != NONE && !constrained[e])
+					continue;
+
+				glm::vec2 const& pa = points[triangles[e]];
+				glm::vec2 const& pb = points[triangles[Next(e)]];
+				if (glm::dot(pa - c, pb - c) < 0.f)
+					return e;
+			}
+			return NONE;
+		}
+
+		if (halfedges[exit] == NONE || constrained[exit])
+			return exit;
+		t = TriangleOf(halfedges[exit]);
+	}
+
+	return NONE;
+}
+
+unsigned int HalfEdgeMesh::SplitSegment(unsigned int e, glm::vec2 const& p)
+{
+	//   Before: (a, b, c) holds e = a -> b, (b, a, d) holds t = b -> a when e is not on the hull
+	//   After:  (a, m, c) and (m, b, c) in e's slot and a new one, (b, m, d) and (m, a, d) likewise
+	unsigned int t = halfedges[e];
+	unsigned int e1 = Next(e), e2 = Prev(e);
+	unsigned int a = triangles[e], b = triangles[e1], c = triangles[e2];
+
+	// p is taken as on the segment, but rounded off it may still fall beside a vertex near the line
+	auto same_side = [this](unsigned int u, unsigned int v, unsigned int w, glm::vec2 const& q)
+	{
+		glm::vec2 const& pu = points[u];
+		glm::vec2 const& pv = points[v];
+		glm::vec2 const& pw = points[w];
+		double before = PREDICATES::Orient2D(pu.x, pu.y, pv.x, pv.y, pw.x, pw.y);
+		double left = PREDICATES::Orient2D(pu.x, pu.y, q.x, q.y, pw.x, pw.y);
+		double right = PREDICATES::Orient2D(q.x, q.y, pv.x, pv.y, pw.x, pw.y);
+		return (left > 0.0) == (before > 0.0) && (right > 0.0) == (before > 0.0) && left != 0.0 && right != 0.0;
+	};
+	if (!same_side(a, b, c, p) || (t != NONE && !same_side(b, a, triangles[Prev(t)], p)))
+		return NONE;
+
+	unsigned int m = static_cast<unsigned int>(points.size());
+	points.push_back(p);
+	incoming.push_back(e);
+
+	auto add_triangle = [this]()
+	{
+		unsigned int slot = static_cast<unsigned int>(TriangleCount());
+		triangles.resize(triangles.size() + 3);
+		halfedges.resize(halfedges.size() + 3);
+		constrained.resize(constrained.size() + 3);
+		return slot * 3;
+	};
+	auto link = [this](unsigned int x, unsigned int y)
+	{
+		halfedges[x] = y;
+		if (y != NONE)
+			halfedges[y] = x;
+	};
+
+	// (m, b, c) takes over b -> c with its twin and constraint, c -> m pairs with the shortened e1
+	unsigned int f = add_triangle();
+	triangles[f] = m; triangles[f + 1] = b; triangles[f + 2] = c;
+	link(f + 1, halfedges[e1]);
+	constrained[f + 1] = constrained[e1];
+	triangles[e1] = m;
+	link(e1, f + 2);
+	constrained[e1] = constrained[f + 2] = 0;
+	constrained[f] = constrained[e];
+	if (incoming[b] == e) incoming[b] = f;
+	if (incoming[c] == e1) incoming[c] = f + 1;
+	m_new_edges.assign({ e2, f + 1 });
+
+	if (t == NONE)
+	{
+		halfedges[f] = NONE;
+		for (size_t i{}; i < hull.size(); ++i)
+		{
+			size_t next = (i + 1) % hull.size();
+			if ((hull[i] == a && hull[next] == b) || (hull[i] == b && hull[next] == a))
+			{
+				hull.insert(hull.begin() + next, m);
+				break;
+			}
+		}
+	}
+	else
+	{
+		// Same on the twin's side: (m, a, d) takes over a -> d
+		unsigned int t1 = Next(t), t2 = Prev(t);
+		unsigned int d = triangles[t2];
+		unsigned int g = add_triangle();
+		triangles[g] = m; triangles[g + 1] = a; triangles[g + 2] = d;
+		link(g + 1, halfedges[t1]);
+		constrained[g + 1] = constrained[t1];
+		triangles[t1] = m;
+		link(t1, g + 2);
+		constrained[t1] = constrained[g + 2] = 0;
+		constrained[g] = constrained[t];
+		if (incoming[a] == t) incoming[a] = g;
+		if (incoming[d] == t1) incoming[d] = g + 1;
+
+		link(e, g);
+		link(t, f);
+		m_new_edges.push_back(t2);
+		m_new_edges.push_back(g + 1);
+	}
+
+	Legalize();
+	return m;
+}
+
+unsigned int HalfEdgeMesh::Refine(float min_angle, unsigned int max_steiner)
+{
+	if (triangles.empty() || min_angle <= 0.f)
+		return 0;
+
+	if (max_steiner == NONE)
+		max_steiner = static_cast<unsigned int>(points.size());
+
+	double sin_bound, cos_bound;
+	CMATH::SinCosDegrees(min_angle, sin_bound, cos_bound);
+	const double sin2_bound = sin_bound * sin_bound;
+
+	std::vector<unsigned int>& queue = m_queue;
+	queue.resize(TriangleCount());
+	for (unsigned int t{}; t < queue.size(); ++t)
+		queue[t] = t;
+
+	unsigned int added{};
+	while (!queue.empty() && added < max_steiner)
+	{
+		unsigned int t = queue.back();
+		queue.pop_back();
+
+		// Entries go stale as slots are reused, the test reads whatever the slot holds now
+		if (!IsSkinny(t, sin2_bound))
+			continue;
+
+		glm::dvec2 a = points[triangles[t * 3]];
+		glm::dvec2 d = glm::dvec2(points[triangles[t * 3 + 1]]) - a;
+		glm::dvec2 e = glm::dvec2(points[triangles[t * 3 + 2]]) - a;
+		double bl = glm::dot(d, d);
+		double cl = glm::dot(e, e);
+		double det = d.x * e.y - d.y * e.x;
+		if (det == 0.0)
+			continue;
+
+		glm::vec2 p = glm::vec2(a + glm::dvec2(e.y * bl - d.y * cl, d.x * cl - e.x * bl) * (0.5 / det));
+
+		unsigned int segment = BlockingSegment(t, p);
+		if (segment != NONE)
+		{
+			glm::vec2 const& pa = points[triangles[segment]];
+			glm::vec2 const& pb = points[triangles[Next(segment)]];
+			glm::vec2 mid = (pa + pb) * 0.5f;
+			if (mid == pa || mid == pb)
+				continue;
+
+			if (PREDICATES::Orient2D(pa.x, pa.y, pb.x, pb.y, mid.x, mid.y) != 0.0)
+			{
+				// Rounded off the segment, inserting it as a free point would leave a sliver against the segment.
+				// It splits the segment's half-edges instead and every triangle it ends up in is checked again.
+				unsigned int v = SplitSegment(segment, mid);
+				if (v == NONE)
+					continue;
+
+				// Both ways round v, flips may have left incoming[v] off the hull
+				++added;
+				queue.push_back(t);
+				unsigned int start = incoming[v], in = start;
+				do
+				{
+					queue.push_back(TriangleOf(in));
+					in = halfedges[Next(in)];
+				} while (in != start && in != NONE);
+				if (in == NONE)
+					for (in = halfedges[start]; in != NONE; in = halfedges[Prev(in)])
+						queue.push_back(TriangleOf(in));
+				continue;
+			}
+			p = mid;
+			queue.push_back(t);
+		}
+
+		size_t count = points.size();
+		m_last = t;
+		if (Insert(p) == NONE || points.size() == count)
+			continue;
+
+		++added;
+		for (size_t i{}; i < m_fan.size(); i += 4)
+			queue.push_back(m_fan[i + 2]);
+	}
+
+	return added;
+}
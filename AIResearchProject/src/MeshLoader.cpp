@@ -78,11 +78,16 @@ void MeshLoader::LoadMesh(std::string path)
 	OGLWRAPPER::BindVAO();
 }
 
-void MeshLoader::LoadTerrain(Terrain& terrain, unsigned int seed, unsigned int no_pts, glm::vec3 map_scale, unsigned int perlin_oct, float perlin_persistance, float perlin_freq)
+void MeshLoader::LoadTerrain(Terrain& terrain, TerrainSettings const& settings)
+{
+	terrain.GeneratePoints(settings);
+	UploadTerrain(terrain.TakeOutput());
+}
+
+void MeshLoader::UploadTerrain(TerrainOutput&& output)
 {
 	/*PLANE*/
 	Mesh& mesh_plane = m_meshes["debug_terrain"];
-	Mesh& mesh_poisson_plane = m_meshes["debug_poisson"];
 
 	OGLWRAPPER::DeleteVAO(mesh_plane.vao);
 	OGLWRAPPER::DeleteVBO(mesh_plane.pos_vbo);
@@ -90,13 +95,6 @@ void MeshLoader::LoadTerrain(Terrain& terrain, unsigned int seed, unsigned int n
 	OGLWRAPPER::DeleteVBO(mesh_plane.ebo_vbo);
 	OGLWRAPPER::DeleteVBO(mesh_plane.clr_vbo);
 
-
-	OGLWRAPPER::DeleteVAO(mesh_poisson_plane.vao);
-	OGLWRAPPER::DeleteVBO(mesh_poisson_plane.pos_vbo);
-	OGLWRAPPER::DeleteVBO(mesh_poisson_plane.nml_vbo);
-	OGLWRAPPER::DeleteVBO(mesh_poisson_plane.ebo_vbo);
-	OGLWRAPPER::DeleteVBO(mesh_poisson_plane.clr_vbo);
-
 	mesh_plane.vao = OGLWRAPPER::CreateVAO();
 	mesh_plane.pos_vbo = OGLWRAPPER::CreateVBO();
 	mesh_plane.nml_vbo = OGLWRAPPER::CreateVBO();
@@ -105,14 +103,15 @@ void MeshLoader::LoadTerrain(Terrain& terrain, unsigned int seed, unsigned int n
 
 	mesh_plane.m_mesh_entries.resize(1);
 
-	terrain.GeneratePoints(seed, no_pts, map_scale, perlin_oct, perlin_persistance, perlin_freq);
-
-	mesh_plane.m_position_buffer = terrain.GetVtx();
-	mesh_plane.m_normal_buffer = terrain.GetNml();
-
-	if (mesh_plane.m_position_buffer.size() % 3 != 0)
+	if (output.positions.size() % 3 != 0)
 		throw std::runtime_error("The number of vertices is not a multiple of 3.");
 
+	mesh_plane.m_position_buffer = std::move(output.positions);
+	mesh_plane.m_normal_buffer = std::move(output.normals);
+	mesh_plane.m_vertex_cnt = static_cast<unsigned int>(mesh_plane.m_position_buffer.size());
+
+	mesh_plane.m_indices.clear();
+	mesh_plane.m_indices.reserve(mesh_plane.m_position_buffer.size() * 2);
 	for (size_t i = 0; i < mesh_plane.m_position_buffer.size(); i += 3)
 	{
 		mesh_plane.m_indices.push_back(static_cast<unsigned int>(i));
@@ -125,16 +124,41 @@ void MeshLoader::LoadTerrain(Terrain& terrain, unsigned int seed, unsigned int n
 
 	OGLWRAPPER::PopulateBuffer(mesh_plane.pos_vbo, mesh_plane.m_position_buffer, sizeof(glm::vec3), GL_FLOAT, 0, 3);
 	OGLWRAPPER::PopulateBuffer(mesh_plane.nml_vbo, mesh_plane.m_normal_buffer, sizeof(glm::vec3), GL_FLOAT, 1, 3);
-	OGLWRAPPER::PopulateBuffer(mesh_plane.clr_vbo, terrain.GetClr(), sizeof(glm::vec3), GL_FLOAT, 2, 3);
+	OGLWRAPPER::PopulateBuffer(mesh_plane.clr_vbo, output.colours, sizeof(glm::vec3), GL_FLOAT, 2, 3);
 	OGLWRAPPER::PopulateEBO(mesh_plane.ebo_vbo, mesh_plane.m_indices);
 
+	// Colours only live on the GPU
+	std::vector<glm::vec3>().swap(output.colours);
+
+	if (m_release_cpu_buffers)
+	{
+		std::vector<glm::vec3>().swap(mesh_plane.m_position_buffer);
+		std::vector<glm::vec3>().swap(mesh_plane.m_normal_buffer);
+		std::vector<unsigned int>().swap(mesh_plane.m_indices);
+	}
+
+	if (output.poisson.empty())
+		return;
+
+	Mesh& mesh_poisson_plane = m_meshes["debug_poisson"];
+
+	OGLWRAPPER::DeleteVAO(mesh_poisson_plane.vao);
+	OGLWRAPPER::DeleteVBO(mesh_poisson_plane.pos_vbo);
+	OGLWRAPPER::DeleteVBO(mesh_poisson_plane.nml_vbo);
+	OGLWRAPPER::DeleteVBO(mesh_poisson_plane.ebo_vbo);
+	OGLWRAPPER::DeleteVBO(mesh_poisson_plane.clr_vbo);
+
 	mesh_poisson_plane.vao = OGLWRAPPER::CreateVAO();
 	mesh_poisson_plane.pos_vbo = OGLWRAPPER::CreateVBO();
 
 	mesh_poisson_plane.m_mesh_entries.resize(1);
 
-	mesh_poisson_plane.m_position_buffer = terrain.GetPoisson();
+	mesh_poisson_plane.m_position_buffer = std::move(output.poisson);
+	mesh_poisson_plane.m_vertex_cnt = static_cast<unsigned int>(mesh_poisson_plane.m_position_buffer.size());
 	OGLWRAPPER::PopulateBuffer(mesh_poisson_plane.pos_vbo, mesh_poisson_plane.m_position_buffer, sizeof(glm::vec3), GL_FLOAT, 0, 3);
+
+	if (m_release_cpu_buffers)
+		std::vector<glm::vec3>().swap(mesh_poisson_plane.m_position_buffer);
 }
 
 Mesh* MeshLoader::GetMesh(std::string name)
@@ -315,31 +339,7 @@ void MeshLoader::LoadDebugMesh()
 
 	//mesh_plane.m_mesh_entries[0].indices_cnt = static_cast<unsigned int>(mesh_plane.m_indices.size());
 
-	Terrain terrain;
-	terrain.GeneratePoints();
-	mesh_plane.m_position_buffer = terrain.GetVtx();
-	mesh_plane.m_normal_buffer = terrain.GetNml();
-
-	if (mesh_plane.m_position_buffer.size() % 3 != 0)
-	{
-		throw std::runtime_error("The number of vertices is not a multiple of 3.");
-	}
-
-	for (size_t i = 0; i < mesh_plane.m_position_buffer.size(); i += 3)
-	{
-		mesh_plane.m_indices.push_back(static_cast<unsigned int>(i));
-		mesh_plane.m_indices.push_back(static_cast<unsigned int>(i + 1));
-		mesh_plane.m_indices.push_back(static_cast<unsigned int>(i + 1));
-		mesh_plane.m_indices.push_back(static_cast<unsigned int>(i + 2));
-		mesh_plane.m_indices.push_back(static_cast<unsigned int>(i + 2));
-		mesh_plane.m_indices.push_back(static_cast<unsigned int>(i));
-	}
-
-	OGLWRAPPER::PopulateBuffer(mesh_plane.pos_vbo, mesh_plane.m_position_buffer, sizeof(glm::vec3), GL_FLOAT, 0, 3);
-	OGLWRAPPER::PopulateBuffer(mesh_plane.nml_vbo, mesh_plane.m_normal_buffer, sizeof(glm::vec3), GL_FLOAT, 1, 3);
-	OGLWRAPPER::PopulateBuffer(mesh_plane.clr_vbo, terrain.GetClr(), sizeof(glm::vec3), GL_FLOAT, 2, 3);
-	OGLWRAPPER::PopulateEBO(mesh_plane.ebo_vbo, mesh_plane.m_indices);
-
+	// Left empty, the generated terrain goes to "debug_terrain" through LoadTerrain
 	OGLWRAPPER::BindVAO();
 
 	/*AXIS*/
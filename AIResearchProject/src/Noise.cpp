@@ -0,0 +1,487 @@
+#include "Noise.h"
+#include "NoiseGraph.h"
+
+#include <algorithm>
+#include <utility>
+#include <variant>
+
+namespace
+{
+	// splitmix64, the shuffle must not depend on the standard library's distributions
+	uint64_t NextRandom(uint64_t& state)
+	{
+		uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		return z ^ (z >> 31);
+	}
+
+	// Landform graphs, f is the base frequency in world units; seed offsets keep the layers uncorrelated
+	auto MakeAlpine(unsigned int seed, int octaves, float f)
+	{
+		using namespace NOISE::GRAPH;
+		auto lowlands = ScaleBias(FBm(Simplex2D(seed, f), octaves), 0.35f, -0.45f);
+		auto ranges = Ridged(Simplex2D(seed + 1, f * 1.5f), octaves);
+		auto mask = FBm(Simplex2D(seed + 2, f * 0.5f), 2);
+		return Select(mask, lowlands, ranges, 0.f, 0.3f);
+	}
+
+	auto MakeMesas(unsigned int seed, int octaves, float f)
+	{
+		using namespace NOISE::GRAPH;
+		auto warped = Warp(FBm(Simplex2D(seed, f), octaves), FBm(Simplex2D(seed + 1, f), 2), FBm(Simplex2D(seed + 2, f), 2), 0.3f / f);
+		return Terrace(warped, 6, 0.35f);
+	}
+
+	auto MakeBadlands(unsigned int seed, int octaves, float f)
+	{
+		using namespace NOISE::GRAPH;
+		auto hills = Billow(Simplex2D(seed, f), octaves);
+		auto basins = Curve(Worley2D(seed + 1, f * 2.f), std::array<glm::vec2, 3>{ glm::vec2(-1.f, -1.f), glm::vec2(-0.3f, 0.1f), glm::vec2(1.f, 0.3f) });
+		return Add(ScaleBias(hills, 0.6f, 0.3f), ScaleBias(basins, 0.4f, 0.f));	// Billow sits low, lift it back towards 0
+	}
+}
+
+namespace
+{
+	// PERLIN_FLOAT kernels, one instantiation per octave count so the lookup happens once per call
+	template <int OCTAVES>
+	float PerlinFixed(siv::PerlinNoiseF const& perlin, float x, float y, float freq_div)
+	{
+		return perlin.octave2D_11SmoothFixed<OCTAVES>(x, y, freq_div);
+	}
+
+	template <int OCTAVES>
+	void PerlinFixedBatch(NOISE::Perlin const& perlin, const glm::vec2* points, float* out, size_t count, float freq_div)
+	{
+		using FN = SIMD::FN;
+		constexpr int W = FN::WIDTH;
+
+		size_t i{};
+		for (; i + W <= count; i += W)
+		{
+			float xs[W], ys[W];
+			for (int l{}; l < W; ++l)
+			{
+				xs[l] = points[i + l].x;
+				ys[l] = points[i + l].y;
+			}
+			perlin.Octave2D_11SmoothFixed<OCTAVES>(FN::Load(xs), FN::Load(ys), freq_div).Store(out + i);
+		}
+
+		for (; i < count; ++i)
+			out[i] = perlin.Octave2D_11SmoothFixed<OCTAVES>(points[i].x, points[i].y, freq_div);
+	}
+
+	template <int OCTAVES>
+	void PerlinFixedGradientBatch(NOISE::Perlin const& perlin, const glm::vec2* points, float* out, glm::vec2* gradients, size_t count, float freq_div)
+	{
+		using FN = SIMD::FN;
+		constexpr int W = FN::WIDTH;
+
+		size_t i{};
+		for (; i + W <= count; i += W)
+		{
+			float xs[W], ys[W], dx[W], dy[W];
+			for (int l{}; l < W; ++l)
+			{
+				xs[l] = points[i + l].x;
+				ys[l] = points[i + l].y;
+			}
+			FN gx, gy;
+			perlin.Octave2D_11SmoothFixed<OCTAVES>(FN::Load(xs), FN::Load(ys), freq_div, gx, gy).Store(out + i);
+			gx.Store(dx);
+			gy.Store(dy);
+			for (int l{}; l < W; ++l)
+				gradients[i + l] = glm::vec2(dx[l], dy[l]);
+		}
+
+		for (; i < count; ++i)
+			out[i] = perlin.Octave2D_11SmoothFixed<OCTAVES>(points[i].x, points[i].y, freq_div, gradients[i].x, gradients[i].y);
+	}
+
+	using PerlinFixedFn = float (*)(siv::PerlinNoiseF const&, float, float, float);
+	using PerlinFixedBatchFn = void (*)(NOISE::Perlin const&, const glm::vec2*, float*, size_t, float);
+	using PerlinFixedGradientBatchFn = void (*)(NOISE::Perlin const&, const glm::vec2*, float*, glm::vec2*, size_t, float);
+
+	template <size_t... I>
+	constexpr std::array<PerlinFixedFn, sizeof...(I)> MakePerlinFixed(std::index_sequence<I...>) { return { &PerlinFixed<I + 1>... }; }
+
+	template <size_t... I>
+	constexpr std::array<PerlinFixedBatchFn, sizeof...(I)> MakePerlinFixedBatch(std::index_sequence<I...>) { return { &PerlinFixedBatch<I + 1>... }; }
+
+	template <size_t... I>
+	constexpr std::array<PerlinFixedGradientBatchFn, sizeof...(I)> MakePerlinFixedGradientBatch(std::index_sequence<I...>)
+	{
+		return { &PerlinFixedGradientBatch<I + 1>... };
+	}
+
+	// Entry o - 1 runs o octaves
+	constexpr auto PERLIN_FIXED = MakePerlinFixed(std::make_index_sequence<NOISE::HeightNoise::MAX_FIXED_OCTAVES>{});
+	constexpr auto PERLIN_FIXED_BATCH = MakePerlinFixedBatch(std::make_index_sequence<NOISE::HeightNoise::MAX_FIXED_OCTAVES>{});
+	constexpr auto PERLIN_FIXED_GRADIENT_BATCH = MakePerlinFixedGradientBatch(std::make_index_sequence<NOISE::HeightNoise::MAX_FIXED_OCTAVES>{});
+}
+
+// One alternative per landform, dispatched once per call so the per-sample loop is the fused graph kernel
+struct NOISE::LandformGraph
+{
+	std::variant<decltype(MakeAlpine(0, 0, 0.f)), decltype(MakeMesas(0, 0, 0.f)), decltype(MakeBadlands(0, 0, 0.f))> graph;
+};
+
+NOISE::Simplex::Simplex(unsigned int seed)
+{
+	std::array<uint8_t, 256> p;
+	for (int i{}; i < 256; ++i)
+		p[i] = static_cast<uint8_t>(i);
+
+	uint64_t state = seed;
+	for (int i = 255; i > 0; --i)
+		std::swap(p[i], p[NextRandom(state) % static_cast<uint64_t>(i + 1)]);
+
+	for (int i{}; i < 512; ++i)
+	{
+		m_perm[i] = p[i & 255];
+		m_grad[i] = static_cast<uint8_t>(m_perm[i] % 12);
+	}
+}
+
+void NOISE::Simplex::Noise2D(const glm::vec2* points, float* out, size_t count) const
+{
+	using FN = SIMD::FN;
+	constexpr int W = FN::WIDTH;
+
+	size_t i{};
+	for (; i + W <= count; i += W)
+	{
+		float xs[W], ys[W];
+		for (int l{}; l < W; ++l)
+		{
+			xs[l] = points[i + l].x;
+			ys[l] = points[i + l].y;
+		}
+		Noise2D(FN::Load(xs), FN::Load(ys)).Store(out + i);
+	}
+
+	for (; i < count; ++i)
+		out[i] = Noise2D(points[i].x, points[i].y);
+}
+
+void NOISE::Simplex::Octave2D_11Smooth(const glm::vec2* points, float* out, size_t count, int octaves, float freq_div) const
+{
+	using FN = SIMD::FN;
+	constexpr int W = FN::WIDTH;
+
+	size_t i{};
+	for (; i + W <= count; i += W)
+	{
+		float xs[W], ys[W];
+		for (int l{}; l < W; ++l)
+		{
+			xs[l] = points[i + l].x;
+			ys[l] = points[i + l].y;
+		}
+		Octave2D_11Smooth(FN::Load(xs), FN::Load(ys), octaves, freq_div).Store(out + i);
+	}
+
+	for (; i < count; ++i)
+		out[i] = Octave2D_11Smooth(points[i].x, points[i].y, octaves, freq_div);
+}
+
+void NOISE::Simplex::Octave2D_11Smooth(const glm::vec2* points, float* out, glm::vec2* gradients, size_t count, int octaves, float freq_div) const
+{
+	using FN = SIMD::FN;
+	constexpr int W = FN::WIDTH;
+
+	size_t i{};
+	for (; i + W <= count; i += W)
+	{
+		float xs[W], ys[W], dx[W], dy[W];
+		for (int l{}; l < W; ++l)
+		{
+			xs[l] = points[i + l].x;
+			ys[l] = points[i + l].y;
+		}
+		FN gx, gy;
+		Octave2D_11Smooth(FN::Load(xs), FN::Load(ys), octaves, freq_div, gx, gy).Store(out + i);
+		gx.Store(dx);
+		gy.Store(dy);
+		for (int l{}; l < W; ++l)
+			gradients[i + l] = glm::vec2(dx[l], dy[l]);
+	}
+
+	for (; i < count; ++i)
+		out[i] = Octave2D_11Smooth(points[i].x, points[i].y, octaves, freq_div, gradients[i].x, gradients[i].y);
+}
+
+void NOISE::Worley::Evaluate(const glm::vec2* points, CellSample<float>* out, size_t count, float frequency) const
+{
+	using FN = SIMD::FN;
+	constexpr int W = FN::WIDTH;
+
+	size_t i{};
+	for (; i + W <= count; i += W)
+	{
+		float xs[W], ys[W];
+		for (int l{}; l < W; ++l)
+		{
+			xs[l] = points[i + l].x * frequency;
+			ys[l] = points[i + l].y * frequency;
+		}
+
+		const CellSample<FN> s = Evaluate(FN::Load(xs), FN::Load(ys));
+		float f1[W], f2[W], id1[W], id2[W], d1x[W], d1y[W], d2x[W], d2y[W];
+		s.f1.Store(f1); s.f2.Store(f2);
+		s.id1.Store(id1); s.id2.Store(id2);
+		s.dir1x.Store(d1x); s.dir1y.Store(d1y);
+		s.dir2x.Store(d2x); s.dir2y.Store(d2y);
+		for (int l{}; l < W; ++l)
+			out[i + l] = { f1[l], f2[l], id1[l], id2[l], d1x[l], d1y[l], d2x[l], d2y[l] };
+	}
+
+	for (; i < count; ++i)
+		out[i] = Evaluate(points[i].x * frequency, points[i].y * frequency);
+}
+
+NOISE::HeightNoise::HeightNoise(Backend backend, unsigned int seed, int octaves, float persistence, float freq_div, Landform landform,
+							   CellSettings const& cells)
+	: m_backend(backend), m_octaves(octaves), m_persistence(persistence), m_freq_div(freq_div),
+	  m_perlin(static_cast<siv::PerlinNoise::seed_type>(seed)), m_perlin_f(static_cast<siv::PerlinNoiseF::seed_type>(seed)), m_perlin_lanes(m_perlin_f),
+	  m_simplex(seed), m_cells(cells), m_worley(seed ^ 0xCE115EEDu)
+{
+	const float f = freq_div > 0.f ? 1.f / freq_div : 1.f;
+	switch (landform)
+	{
+	case Landform::ALPINE:		m_landform = std::make_shared<const LandformGraph>(LandformGraph{ MakeAlpine(seed, octaves, f) }); break;
+	case Landform::MESAS:		m_landform = std::make_shared<const LandformGraph>(LandformGraph{ MakeMesas(seed, octaves, f) }); break;
+	case Landform::BADLANDS:	m_landform = std::make_shared<const LandformGraph>(LandformGraph{ MakeBadlands(seed, octaves, f) }); break;
+	default: break;
+	}
+}
+
+float NOISE::HeightNoise::SampleBase(double x, double y) const
+{
+	if (m_landform)
+	{
+		const float fx = static_cast<float>(x), fy = static_cast<float>(y);
+		const float h = std::visit([&](auto const& graph) { return graph.Eval(fx, fy); }, m_landform->graph);
+		return std::clamp(h, -1.f, 1.f);
+	}
+
+	if (m_backend == Backend::SIMPLEX)
+		return m_simplex.Octave2D_11Smooth(static_cast<float>(x), static_cast<float>(y), m_octaves, m_freq_div);
+
+	if (m_backend == Backend::PERLIN_FLOAT)
+	{
+		const float fx = static_cast<float>(x), fy = static_cast<float>(y);
+		if (m_octaves >= 1 && m_octaves <= MAX_FIXED_OCTAVES)
+			return PERLIN_FIXED[m_octaves - 1](m_perlin_f, fx, fy, m_freq_div);
+		return m_perlin_f.octave2D_11Smooth(fx, fy, m_octaves, m_persistence, m_freq_div);
+	}
+
+	return (float)m_perlin.octave2D_11Smooth(x, y, m_octaves, m_persistence, m_freq_div);
+}
+
+void NOISE::HeightNoise::SampleBase(const glm::vec2* points, float* out, size_t count) const
+{
+	if (m_landform)
+	{
+		std::visit([&](auto const& graph) { GRAPH::Evaluate(graph, points, out, count); }, m_landform->graph);
+		for (size_t i{}; i < count; ++i)
+			out[i] = std::clamp(out[i], -1.f, 1.f);
+		return;
+	}
+
+	if (m_backend == Backend::SIMPLEX)
+	{
+		m_simplex.Octave2D_11Smooth(points, out, count, m_octaves, m_freq_div);
+		return;
+	}
+
+	if (m_backend == Backend::PERLIN_FLOAT)
+	{
+		if (m_octaves >= 1 && m_octaves <= MAX_FIXED_OCTAVES)
+			PERLIN_FIXED_BATCH[m_octaves - 1](m_perlin_lanes, points, out, count, m_freq_div);
+		else
+			for (size_t i{}; i < count; ++i)
+				out[i] = m_perlin_f.octave2D_11Smooth(points[i].x, points[i].y, m_octaves, m_persistence, m_freq_div);
+		return;
+	}
+
+	for (size_t i{}; i < count; ++i)
+		out[i] = (float)m_perlin.octave2D_11Smooth((double)points[i].x, (double)points[i].y, m_octaves, m_persistence, m_freq_div);
+}
+
+float NOISE::HeightNoise::SampleBase(double x, double y, glm::vec2& gradient) const
+{
+	if (m_landform || m_backend != Backend::PERLIN)
+	{
+		const glm::vec2 p(static_cast<float>(x), static_cast<float>(y));
+		float h;
+		SampleBase(&p, &h, &gradient, 1);
+		return h;
+	}
+
+	double dx, dy;
+	const double h = m_perlin_lanes.Octave2D_11Smooth(x, y, m_octaves, static_cast<double>(m_freq_div), dx, dy);
+	gradient = glm::vec2(static_cast<float>(dx), static_cast<float>(dy));
+	return (float)h;
+}
+
+void NOISE::HeightNoise::SampleBase(const glm::vec2* points, float* out, glm::vec2* gradients, size_t count) const
+{
+	if (m_landform)
+	{
+		// Central differences a small fraction of the base feature size apart, a chunk of points at a time
+		constexpr size_t CHUNK = 64;
+		const float step = 1e-3f * (m_freq_div > 0.f ? m_freq_div : 1.f);
+		const glm::vec2 offsets[4] = { { step, 0.f }, { -step, 0.f }, { 0.f, step }, { 0.f, -step } };
+
+		SampleBase(points, out, count);
+		for (size_t begin{}; begin < count; begin += CHUNK)
+		{
+			const size_t n = std::min(CHUNK, count - begin);
+			float h[4][CHUNK];
+			for (int k{}; k < 4; ++k)
+			{
+				glm::vec2 shifted[CHUNK];
+				for (size_t i{}; i < n; ++i)
+					shifted[i] = points[begin + i] + offsets[k];
+				SampleBase(shifted, h[k], n);
+			}
+
+			for (size_t i{}; i < n; ++i)
+				gradients[begin + i] = glm::vec2(h[0][i] - h[1][i], h[2][i] - h[3][i]) / (2.f * step);
+		}
+		return;
+	}
+
+	if (m_backend == Backend::SIMPLEX)
+	{
+		m_simplex.Octave2D_11Smooth(points, out, gradients, count, m_octaves, m_freq_div);
+		return;
+	}
+
+	if (m_backend == Backend::PERLIN_FLOAT)
+	{
+		if (m_octaves >= 1 && m_octaves <= MAX_FIXED_OCTAVES)
+			PERLIN_FIXED_GRADIENT_BATCH[m_octaves - 1](m_perlin_lanes, points, out, gradients, count, m_freq_div);
+		else
+			for (size_t i{}; i < count; ++i)
+				out[i] = m_perlin_lanes.Octave2D_11Smooth(points[i].x, points[i].y, m_octaves, m_freq_div, gradients[i].x, gradients[i].y);
+		return;
+	}
+
+	for (size_t i{}; i < count; ++i)
+		out[i] = SampleBase(static_cast<double>(points[i].x), static_cast<double>(points[i].y), gradients[i]);
+}
+
+float NOISE::HeightNoise::Sample(double x, double y) const
+{
+	if (m_cells.feature == CellFeature::NONE)
+		return SampleBase(x, y);
+
+	const glm::vec2 p(static_cast<float>(x), static_cast<float>(y));
+	float h = SampleBase(x, y);
+	AddCells(&p, &h, nullptr, 1);
+	return h;
+}
+
+void NOISE::HeightNoise::Sample(const glm::vec2* points, float* out, size_t count) const
+{
+	SampleBase(points, out, count);
+	if (m_cells.feature != CellFeature::NONE)
+		AddCells(points, out, nullptr, count);
+}
+
+float NOISE::HeightNoise::Sample(double x, double y, glm::vec2& gradient) const
+{
+	float h = SampleBase(x, y, gradient);
+	if (m_cells.feature != CellFeature::NONE)
+	{
+		const glm::vec2 p(static_cast<float>(x), static_cast<float>(y));
+		AddCells(&p, &h, &gradient, 1);
+	}
+	return h;
+}
+
+void NOISE::HeightNoise::Sample(const glm::vec2* points, float* out, glm::vec2* gradients, size_t count) const
+{
+	SampleBase(points, out, gradients, count);
+	if (m_cells.feature != CellFeature::NONE)
+		AddCells(points, out, gradients, count);
+}
+
+void NOISE::HeightNoise::AddCells(const glm::vec2* points, float* out, glm::vec2* gradients, size_t count) const
+{
+	// Profiles over distances in cell units
+	constexpr float PLATEAU_EDGE = 0.15f;	// F2 - F1 over which a plateau drops to its border
+	constexpr float CRATER_RADIUS = 0.35f;
+	constexpr float CRATER_RIM = 0.25f;		// Rim height against the bowl's depth of 1
+	constexpr float CRATER_FALLOFF = 0.25f;	// Outer slope of the rim
+	constexpr float ROCK_RADIUS = 0.3f;
+
+	constexpr size_t CHUNK = 64;
+	const float frequency = 1.f / (m_cells.size > 0.f ? m_cells.size : 1.f);
+
+	for (size_t begin{}; begin < count; begin += CHUNK)
+	{
+		const size_t n = std::min(CHUNK, count - begin);
+		CellSample<float> cells[CHUNK];
+		m_worley.Evaluate(points + begin, cells, n, frequency);
+
+		for (size_t i{}; i < n; ++i)
+		{
+			CellSample<float> const& c = cells[i];
+			const glm::vec2 dir1(c.dir1x, c.dir1y), dir2(c.dir2x, c.dir2y);
+
+			// Layer value and its gradient in cell units
+			float layer{};
+			glm::vec2 slope{};
+			switch (m_cells.feature)
+			{
+			case CellFeature::PLATEAUS:
+			{
+				const float level = c.id1 * (1.f / 16777216.f);
+				const float t = std::clamp((c.f2 - c.f1) / PLATEAU_EDGE, 0.f, 1.f);
+				layer = level * t * t * (3.f - 2.f * t);
+				slope = level * 6.f * t * (1.f - t) / PLATEAU_EDGE * (dir2 - dir1);
+				break;
+			}
+			case CellFeature::CRATERS:
+				if (c.f1 < CRATER_RADIUS)
+				{
+					const float r = c.f1 / CRATER_RADIUS;
+					layer = r * r * (1.f + CRATER_RIM) - 1.f;
+					slope = 2.f * r / CRATER_RADIUS * (1.f + CRATER_RIM) * dir1;
+				}
+				else
+				{
+					const float u = std::max(1.f - (c.f1 - CRATER_RADIUS) / CRATER_FALLOFF, 0.f);
+					layer = CRATER_RIM * u * u;
+					slope = -2.f * CRATER_RIM * u / CRATER_FALLOFF * dir1;
+				}
+				break;
+			case CellFeature::ROCKS:
+			{
+				const float u = std::max(1.f - c.f1 / ROCK_RADIUS, 0.f);
+				layer = u * u;
+				slope = -2.f * u / ROCK_RADIUS * dir1;
+				break;
+			}
+			default:
+				break;
+			}
+
+			// The sum stays in [-1, 1] like the noise, flat where it is clamped
+			float& h = out[begin + i];
+			h += m_cells.amount * layer;
+			const bool clamped = h < -1.f || h > 1.f;
+			h = std::clamp(h, -1.f, 1.f);
+			if (gradients)
+			{
+				glm::vec2& g = gradients[begin + i];
+				g = clamped ? glm::vec2(0.f) : g + m_cells.amount * frequency * slope;
+			}
+		}
+	}
+}
@@ -1,11 +1,18 @@
 #include "PoissonDiskSampling.h"
 #include <glm/gtx/norm.hpp> 
+#include "CustomMath.h"
+
+#include <algorithm>
+#include <cstring>
 
 inline float Poisson::DefaultPRNG::randomFloat()
 {
 	seed_ *= 521167;
+	// The low 23 bits as the mantissa of a float in [2, 4)
 	uint32_t a = (seed_ & 0x007fffff) | 0x40000000;
-	return 0.5f * (*((float*)&a) - 2.0f);
+	float f;
+	std::memcpy(&f, &a, sizeof(f));
+	return 0.5f * (f - 2.0f);
 }
 
 inline uint32_t Poisson::DefaultPRNG::randomInt(uint32_t maxInt)
@@ -28,18 +35,15 @@ Poisson::GridPoint Poisson::ImageToGrid(const glm::vec2& P, float cellSize)
     return GridPoint((int)(P.x / cellSize), (int)(P.y / cellSize));
 }
 
-Poisson::Grid::Grid(int w, int h, float cellSize)
-    : w_(w), h_(h), cellSize_(cellSize)
+Poisson::Grid::Grid(int w, int h, float cellSize, std::pmr::memory_resource* resource)
+    : w_(w), h_(h), cellSize_(cellSize), grid_(static_cast<size_t>(w) * h, glm::vec2(0.f), resource)
 {
-    grid_.resize(h_);
-    for (auto& i : grid_)
-        i.resize(w);
 }
 
 void Poisson::Grid::insert(const glm::vec2& p)
 {
     const GridPoint g = ImageToGrid(p, cellSize_);
-    grid_[g.x][g.y] = p;
+    grid_[static_cast<size_t>(g.x) * h_ + g.y] = p;
 }
 
 bool Poisson::Grid::IsInNeighbourhood(const glm::vec2& point, float min_dist, float cell_sz)
@@ -50,7 +54,7 @@ bool Poisson::Grid::IsInNeighbourhood(const glm::vec2& point, float min_dist, fl
 		for (int j{ g.y - D }; j <= g.y + D; j++)
             if (i >= 0 && i < w_ && j >= 0 && j < h_)
             {
-                glm::vec2 P = grid_[i][j];
+                glm::vec2 P = grid_[static_cast<size_t>(i) * h_ + j];
                 if (glm::distance2(P, point) < min_dist)
                     return true;
             }
@@ -58,24 +62,28 @@ bool Poisson::Grid::IsInNeighbourhood(const glm::vec2& point, float min_dist, fl
     return false;
 }
 
-std::vector<glm::vec2> Poisson::GeneratePoissonPoints(uint32_t num_p, unsigned int rng, uint32_t newPointsCount, float min_dist)
+std::pmr::vector<glm::vec2> Poisson::GeneratePoissonPoints(uint32_t num_p, unsigned int rng, uint32_t newPointsCount, float min_dist, std::pmr::memory_resource* resource)
 {
 	Poisson::DefaultPRNG gen = Poisson::DefaultPRNG(rng);
 
 	num_p *= 2;
 	if (min_dist < 0.0f)
-		min_dist = sqrt(float(num_p)) / float(num_p);
+		min_dist = std::sqrt(float(num_p)) / float(num_p);
 
 	num_p = static_cast<int>(0.785398163397448309616 * num_p);
 
-	std::vector<glm::vec2> out_points;
-	std::vector<glm::vec2> temp_points;
+	std::pmr::vector<glm::vec2> out_points(resource);
+	std::pmr::vector<glm::vec2> temp_points(resource);
 
 	if (!num_p)
 		return out_points;
 
+	// Sampling stops once past num_p, the last point can still add a full round of candidates
+	out_points.reserve(static_cast<size_t>(num_p) + newPointsCount + 1);
+	temp_points.reserve(static_cast<size_t>(num_p) + newPointsCount + 1);
+
 	float cell_sz = min_dist / 1.414214f;
-	Grid grid((int)ceil(1.f / cell_sz), (int)ceil(1.f / cell_sz), cell_sz);
+	Grid grid((int)ceil(1.f / cell_sz), (int)ceil(1.f / cell_sz), cell_sz, resource);
 
 	glm::vec2 f_p{};
 
@@ -112,12 +120,21 @@ std::vector<glm::vec2> Poisson::GeneratePoissonPoints(uint32_t num_p, unsigned i
 glm::vec2 Poisson::GenerateRandomPointAround(const glm::vec2& p, float min_dist, DefaultPRNG& seed)
 {
 	float radius	= min_dist * (seed.randomFloat() + 1.0f);
-	float angle		= 2.f * 3.141592653589f * seed.randomFloat();
 
-	return glm::vec2(p.x + radius * cos(angle), p.y + radius * sin(angle));
+	// Uniform direction by rejection from the unit disk: arithmetic and a correctly rounded sqrt only, where sin and cos
+	// come from the C runtime and differ between compilers and platforms
+	glm::vec2 dir;
+	float length_sq;
+	do
+	{
+		dir = glm::vec2(2.f * seed.randomFloat() - 1.f, 2.f * seed.randomFloat() - 1.f);
+		length_sq = glm::dot(dir, dir);
+	} while (length_sq > 1.f || length_sq < 1e-6f);
+
+	return p + dir * (radius / std::sqrt(length_sq));
 }
 
-glm::vec2 Poisson::PopRandom(std::vector<glm::vec2>& points, DefaultPRNG& seed)
+glm::vec2 Poisson::PopRandom(std::pmr::vector<glm::vec2>& points, DefaultPRNG& seed)
 {
 	int idx		= static_cast<int>(seed.randomInt(static_cast<int>(points.size()) - 1));
 	glm::vec2 p = points[idx];
@@ -125,4 +142,136 @@ glm::vec2 Poisson::PopRandom(std::vector<glm::vec2>& points, DefaultPRNG& seed)
 	points.erase(points.begin() + idx);
 
 	return p;
-}
\ No newline at end of file
+}
+
+float Poisson::RadiusField::Sample(const glm::vec2& p) const
+{
+	if (resolution < 2)
+		return radii.empty() ? max_radius : radii[0];
+
+	float fx = glm::clamp(p.x, 0.f, 1.f) * (resolution - 1);
+	float fy = glm::clamp(p.y, 0.f, 1.f) * (resolution - 1);
+	int x0 = CMIN(static_cast<int>(fx), resolution - 2);
+	int y0 = CMIN(static_cast<int>(fy), resolution - 2);
+	float tx = fx - x0;
+	float ty = fy - y0;
+
+	const float* row0 = &radii[static_cast<size_t>(y0) * resolution];
+	const float* row1 = row0 + resolution;
+	float top = row0[x0] + (row0[x0 + 1] - row0[x0]) * tx;
+	float bottom = row1[x0] + (row1[x0 + 1] - row1[x0]) * tx;
+	return top + (bottom - top) * ty;
+}
+
+std::pmr::vector<glm::vec2> Poisson::GenerateAdaptivePoissonPoints(const RadiusField& field, unsigned int rng, uint32_t newPointsCount, std::pmr::memory_resource* resource)
+{
+	Poisson::DefaultPRNG gen = Poisson::DefaultPRNG(rng);
+
+	std::pmr::vector<glm::vec2> out_points(resource);
+	std::pmr::vector<float> out_radii(resource);
+	if (field.min_radius <= 0.f || field.max_radius < field.min_radius)
+		return out_points;
+
+	// Every pair is at least min_radius apart, so a cell of min_radius / sqrt(2) holds one point at most
+	float cell_sz = field.min_radius / 1.414214f;
+	int cells = static_cast<int>(ceil(1.f / cell_sz));
+	std::pmr::vector<int> grid(static_cast<size_t>(cells) * cells, -1, resource);
+
+	auto cell_of = [&](const glm::vec2& p)
+	{
+		return glm::ivec2(CMIN(static_cast<int>(p.x / cell_sz), cells - 1), CMIN(static_cast<int>(p.y / cell_sz), cells - 1));
+	};
+
+	auto accept = [&](const glm::vec2& q, float rq)
+	{
+		// Neighbours matter out to (rq + max_radius) / 2
+		int reach = static_cast<int>(ceil(0.5f * (rq + field.max_radius) / cell_sz));
+		glm::ivec2 c = cell_of(q);
+		for (int j = CMAX(c.y - reach, 0); j <= CMIN(c.y + reach, cells - 1); ++j)
+			for (int i = CMAX(c.x - reach, 0); i <= CMIN(c.x + reach, cells - 1); ++i)
+			{
+				int n = grid[static_cast<size_t>(j) * cells + i];
+				if (n < 0)
+					continue;
+
+				float spacing = 0.5f * (rq + out_radii[n]);
+				if (glm::distance2(out_points[n], q) < spacing * spacing)
+					return false;
+			}
+		return true;
+	};
+
+	auto insert = [&](const glm::vec2& p, float r)
+	{
+		glm::ivec2 c = cell_of(p);
+		grid[static_cast<size_t>(c.y) * cells + c.x] = static_cast<int>(out_points.size());
+		out_points.emplace_back(p);
+		out_radii.emplace_back(r);
+	};
+
+	glm::vec2 f_p = glm::vec2(gen.randomFloat(), gen.randomFloat());
+	while (!InRectangle(f_p))
+		f_p = glm::vec2(gen.randomFloat(), gen.randomFloat());
+	insert(f_p, field.Sample(f_p));
+
+	// Active list of indices into out_points, removal swaps with the back
+	std::pmr::vector<int> active(1, 0, resource);
+	while (!active.empty())
+	{
+		uint32_t slot = gen.randomInt(static_cast<uint32_t>(active.size()));
+		if (slot >= active.size())
+			slot = static_cast<uint32_t>(active.size()) - 1;
+
+		int idx = active[slot];
+		glm::vec2 point = out_points[idx];
+		float radius = out_radii[idx];
+
+		bool spawned = false;
+		for (uint32_t i = 0; i < newPointsCount; i++)
+		{
+			glm::vec2 n_p = GenerateRandomPointAround(point, radius, gen);
+			if (!InRectangle(n_p))
+				continue;
+
+			float n_r = field.Sample(n_p);
+			if (accept(n_p, n_r))
+			{
+				active.push_back(static_cast<int>(out_points.size()));
+				insert(n_p, n_r);
+				spawned = true;
+			}
+		}
+
+		// A point stays active while it keeps producing neighbours
+		if (!spawned)
+		{
+			active[slot] = active.back();
+			active.pop_back();
+		}
+	}
+
+	return out_points;
+}
+
+void Poisson::AddBoundaryPoints(std::pmr::vector<glm::vec2>& points, float spacing)
+{
+	if (spacing <= 0.f)
+		return;
+
+	float margin = 0.5f * spacing;
+	points.erase(std::remove_if(points.begin(), points.end(), [margin](const glm::vec2& p)
+	{
+		return p.x < margin || p.y < margin || p.x > 1.f - margin || p.y > 1.f - margin;
+	}), points.end());
+
+	// Each side runs from one corner up to the next, exclusive
+	int segments = CMAX(static_cast<int>(ceil(1.f / spacing)), 1);
+	for (int i{}; i < segments; ++i)
+	{
+		float t = static_cast<float>(i) / segments;
+		points.emplace_back(t, 0.f);
+		points.emplace_back(1.f, t);
+		points.emplace_back(1.f - t, 1.f);
+		points.emplace_back(0.f, 1.f - t);
+	}
+}
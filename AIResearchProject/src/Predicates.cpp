@@ -0,0 +1,201 @@
+#include "Predicates.h"
+
+/*
+* Expansion arithmetic: a value is held as a sum of non-overlapping doubles ordered by increasing magnitude,
+* so the last (largest) component carries the sign of the whole sum.
+* Relies on IEEE round-to-nearest doubles without extended precision or fused multiply-add contraction.
+*/
+namespace
+{
+	// 2^ceil(53 / 2) + 1, splits a double into two halves whose products are exact
+	constexpr double SPLITTER = 134217729.0;
+
+	// Sizes: cross products are 4 components, an orientation minor is 12, scaling by a coordinate doubles the count
+	constexpr int CROSS_LEN = 4;
+	constexpr int MINOR_LEN = CROSS_LEN * 3;
+	constexpr int LIFT_LEN = MINOR_LEN * 8;
+
+	inline void FastTwoSum(double a, double b, double& x, double& y)
+	{
+		x = a + b;
+		double bvirt = x - a;
+		y = b - bvirt;
+	}
+
+	inline void TwoSum(double a, double b, double& x, double& y)
+	{
+		x = a + b;
+		double bvirt = x - a;
+		double avirt = x - bvirt;
+		double bround = b - bvirt;
+		double around = a - avirt;
+		y = around + bround;
+	}
+
+	inline void Split(double a, double& hi, double& lo)
+	{
+		double c = SPLITTER * a;
+		double abig = c - a;
+		hi = c - abig;
+		lo = a - hi;
+	}
+
+	inline void TwoProductPresplit(double a, double b, double bhi, double blo, double& x, double& y)
+	{
+		x = a * b;
+		double ahi, alo;
+		Split(a, ahi, alo);
+		double err1 = x - ahi * bhi;
+		double err2 = err1 - alo * bhi;
+		double err3 = err2 - ahi * blo;
+		y = alo * blo - err3;
+	}
+
+	inline void TwoProduct(double a, double b, double& x, double& y)
+	{
+		double bhi, blo;
+		Split(b, bhi, blo);
+		TwoProductPresplit(a, b, bhi, blo, x, y);
+	}
+
+	// h = e + f, zero components dropped, returns the length of h
+	int ExpansionSum(int elen, double const* e, int flen, double const* f, double* h)
+	{
+		int eindex{}, findex{}, hindex{};
+		double enow = e[0];
+		double fnow = f[0];
+		double q, qnew, hh;
+
+		auto next_e = [&]() { enow = ++eindex < elen ? e[eindex] : 0.0; };
+		auto next_f = [&]() { fnow = ++findex < flen ? f[findex] : 0.0; };
+
+		if ((fnow > enow) == (fnow > -enow)) { q = enow; next_e(); }
+		else { q = fnow; next_f(); }
+
+		if (eindex < elen && findex < flen)
+		{
+			if ((fnow > enow) == (fnow > -enow)) { FastTwoSum(enow, q, qnew, hh); next_e(); }
+			else { FastTwoSum(fnow, q, qnew, hh); next_f(); }
+			q = qnew;
+			if (hh != 0.0) h[hindex++] = hh;
+
+			while (eindex < elen && findex < flen)
+			{
+				if ((fnow > enow) == (fnow > -enow)) { TwoSum(q, enow, qnew, hh); next_e(); }
+				else { TwoSum(q, fnow, qnew, hh); next_f(); }
+				q = qnew;
+				if (hh != 0.0) h[hindex++] = hh;
+			}
+		}
+
+		while (eindex < elen)
+		{
+			TwoSum(q, enow, qnew, hh);
+			next_e();
+			q = qnew;
+			if (hh != 0.0) h[hindex++] = hh;
+		}
+
+		while (findex < flen)
+		{
+			TwoSum(q, fnow, qnew, hh);
+			next_f();
+			q = qnew;
+			if (hh != 0.0) h[hindex++] = hh;
+		}
+
+		if (q != 0.0 || hindex == 0)
+			h[hindex++] = q;
+		return hindex;
+	}
+
+	// h = e * b, zero components dropped, returns the length of h
+	int ScaleExpansion(int elen, double const* e, double b, double* h)
+	{
+		double bhi, blo;
+		Split(b, bhi, blo);
+
+		int hindex{};
+		double q, hh;
+		TwoProductPresplit(e[0], b, bhi, blo, q, hh);
+		if (hh != 0.0) h[hindex++] = hh;
+
+		for (int i = 1; i < elen; ++i)
+		{
+			double product1, product0, sum;
+			TwoProductPresplit(e[i], b, bhi, blo, product1, product0);
+			TwoSum(q, product0, sum, hh);
+			if (hh != 0.0) h[hindex++] = hh;
+			FastTwoSum(product1, sum, q, hh);
+			if (hh != 0.0) h[hindex++] = hh;
+		}
+
+		if (q != 0.0 || hindex == 0)
+			h[hindex++] = q;
+		return hindex;
+	}
+
+	// Exact px * qy - py * qx
+	int Cross(double px, double py, double qx, double qy, double* h)
+	{
+		double l[2], r[2];
+		TwoProduct(px, qy, l[1], l[0]);
+		TwoProduct(-py, qx, r[1], r[0]);
+		return ExpansionSum(2, l, 2, r, h);
+	}
+
+	// Exact orientation minor p x q + q x r + r x p
+	int Minor(double const* p, double const* q, double const* r, double* h)
+	{
+		double pq[CROSS_LEN], qr[CROSS_LEN], rp[CROSS_LEN], sum[CROSS_LEN * 2];
+		int pqlen = Cross(p[0], p[1], q[0], q[1], pq);
+		int qrlen = Cross(q[0], q[1], r[0], r[1], qr);
+		int rplen = Cross(r[0], r[1], p[0], p[1], rp);
+		int sumlen = ExpansionSum(pqlen, pq, qrlen, qr, sum);
+		return ExpansionSum(sumlen, sum, rplen, rp, h);
+	}
+
+	// Exact (px^2 + py^2) * minor
+	int Lift(double const* p, int mlen, double const* minor, double* h)
+	{
+		double x1[MINOR_LEN * 2], x2[MINOR_LEN * 4], y1[MINOR_LEN * 2], y2[MINOR_LEN * 4];
+		int x1len = ScaleExpansion(mlen, minor, p[0], x1);
+		int x2len = ScaleExpansion(x1len, x1, p[0], x2);
+		int y1len = ScaleExpansion(mlen, minor, p[1], y1);
+		int y2len = ScaleExpansion(y1len, y1, p[1], y2);
+		return ExpansionSum(x2len, x2, y2len, y2, h);
+	}
+}
+
+double PREDICATES::Orient2DExact(double ax, double ay, double bx, double by, double cx, double cy)
+{
+	double a[2]{ ax, ay }, b[2]{ bx, by }, c[2]{ cx, cy };
+	double det[MINOR_LEN];
+	int len = Minor(a, b, c, det);
+	return det[len - 1];
+}
+
+double PREDICATES::InCircleExact(double ax, double ay, double bx, double by, double cx, double cy, double dx, double dy)
+{
+	double a[2]{ ax, ay }, b[2]{ bx, by }, c[2]{ cx, cy }, d[2]{ dx, dy };
+
+	// Cofactor expansion of the 4x4 lifted determinant along the lift column:
+	// lift(a) |b c d| - lift(b) |a c d| + lift(c) |a b d| - lift(d) |a b c|, with the minus signs folded into the minors
+	double ma[MINOR_LEN], mb[MINOR_LEN], mc[MINOR_LEN], md[MINOR_LEN];
+	int malen = Minor(b, c, d, ma);
+	int mblen = Minor(a, d, c, mb);
+	int mclen = Minor(a, b, d, mc);
+	int mdlen = Minor(a, c, b, md);
+
+	double la[LIFT_LEN], lb[LIFT_LEN], lc[LIFT_LEN], ld[LIFT_LEN];
+	int lalen = Lift(a, malen, ma, la);
+	int lblen = Lift(b, mblen, mb, lb);
+	int lclen = Lift(c, mclen, mc, lc);
+	int ldlen = Lift(d, mdlen, md, ld);
+
+	double ab[LIFT_LEN * 2], cd[LIFT_LEN * 2], det[LIFT_LEN * 4];
+	int ablen = ExpansionSum(lalen, la, lblen, lb, ab);
+	int cdlen = ExpansionSum(lclen, lc, ldlen, ld, cd);
+	int len = ExpansionSum(ablen, ab, cdlen, cd, det);
+	return det[len - 1];
+}
@@ -1,6 +1,7 @@
 #include "Primitives.h"
 
 #include "CustomMath.h"
+#include "Predicates.h"
 #include <limits>
 #include <glm/gtx/norm.hpp>
 
@@ -113,24 +114,13 @@ bool TESTS::TriContainsVertex(const Triangle2D& triangle, glm::vec2 const& point
 
 bool TESTS::CircumCircleContains(const Triangle2D& triangle, glm::vec2 const& point)
 {
-	const double ab = triangle.p1.x * triangle.p1.x + triangle.p1.y * triangle.p1.y;
-	const double cd = triangle.p2.x * triangle.p2.x + triangle.p2.y * triangle.p2.y;
-	const double ef = triangle.p3.x * triangle.p3.x + triangle.p3.y * triangle.p3.y;
-
-	const double ax = triangle.p1.x;
-	const double ay = triangle.p1.y;
-	const double bx = triangle.p2.x;
-	const double by = triangle.p2.y;
-	const double cx = triangle.p3.x;
-	const double cy = triangle.p3.y;
-
-	const double circum_x = (ab * (cy - by) + cd * (ay - cy) + ef * (by - ay)) / (ax * (cy - by) + bx * (ay - cy) + cx * (by - ay));
-	const double circum_y = (ab * (cx - bx) + cd * (ax - cx) + ef * (bx - ax)) / (ay * (cx - bx) + by * (ax - cx) + cy * (bx - ax));
-
-	const glm::vec2 circum(circum_x / 2, circum_y / 2);
-	const float circum_radius = glm::distance2(triangle.p1, circum);
-	const float dist = glm::distance2(point, circum);
-	return dist <= circum_radius;
+	const double orient = PREDICATES::Orient2D(triangle.p1.x, triangle.p1.y, triangle.p2.x, triangle.p2.y, triangle.p3.x, triangle.p3.y);
+	if (orient == 0.0)
+		return false;
+
+	// Points on the circle count as inside
+	const double incircle = PREDICATES::InCircle(triangle.p1.x, triangle.p1.y, triangle.p2.x, triangle.p2.y, triangle.p3.x, triangle.p3.y, point.x, point.y);
+	return orient > 0.0 ? incircle >= 0.0 : incircle <= 0.0;
 }
 
 bool TESTS::EqualTriangles(const Triangle2D& t1, const Triangle2D& t2)
@@ -156,90 +146,11 @@ bool TESTS::EqualEpsilon(glm::vec2 const& a, glm::vec2 const& b)
 	return EqualEpsilon(a.x, b.x) && EqualEpsilon(a.y, b.y);
 }
 
-std::vector<Triangle2D> TESTS::Triangulate(std::vector<glm::vec2>& vertices)
+HalfEdgeMesh TESTS::Triangulate(std::vector<glm::vec2> const& points)
 {
-	std::vector<Triangle2D> _triangles{};
-	float minX = vertices[0].x;
-	float minY = vertices[0].y;
-	float maxX = minX;
-	float maxY = minY;
-
-	for (std::size_t i = 0; i < vertices.size(); ++i)
-	{
-		if (vertices[i].x < minX) minX = vertices[i].x;
-		if (vertices[i].y < minY) minY = vertices[i].y;
-		if (vertices[i].x > maxX) maxX = vertices[i].x;
-		if (vertices[i].y > maxY) maxY = vertices[i].y;
-	}
-
-	const float dx = maxX - minX;
-	const float dy = maxY - minY;
-	const float deltaMax = CMAX(dx, dy);
-	const float midx = (minX + maxX) / 2;
-	const float midy = (minY + maxY) / 2;
-
-	const glm::vec2 p1(midx - 20 * deltaMax, midy - deltaMax);
-	const glm::vec2 p2(midx, midy + 20 * deltaMax);
-	const glm::vec2 p3(midx + 20 * deltaMax, midy - deltaMax);
-
-	// Create a list of triangles, and add the supertriangle in it
-	_triangles.push_back(Triangle2D(p1, p2, p3));
-
-	for (auto p = begin(vertices); p != end(vertices); p++)
-	{
-		std::vector<Edge2D> polygon;
-
-		for (auto& t : _triangles)
-		{
-			if (CircumCircleContains(t, *p))
-			{
-				t.valid = true;
-				polygon.push_back(Edge2D{ t.p1, t.p2 });
-				polygon.push_back(Edge2D{ t.p2, t.p3 });
-				polygon.push_back(Edge2D{ t.p3, t.p1 });
-			}
-		}
-
-		_triangles.erase(std::remove_if(begin(_triangles), end(_triangles), [](Triangle2D& t)
-										{
-											return t.valid;
-										}), end(_triangles));
-
-		for (auto e1 = begin(polygon); e1 != end(polygon); ++e1)
-		{
-			for (auto e2 = e1 + 1; e2 != end(polygon); ++e2)
-			{
-				if (EqualEdges(*e1, *e2))
-				{
-					e1->valid = true;
-					e2->valid = true;
-				}
-			}
-		}
-
-		polygon.erase(std::remove_if(begin(polygon), end(polygon), [](Edge2D& e)
-									 {
-										 return e.valid;
-									 }), end(polygon));
-
-		for (const auto& e : polygon)
-			_triangles.push_back(Triangle2D(e.p1, e.p2, *p));
-
-	}
-
-	_triangles.erase(std::remove_if(begin(_triangles), end(_triangles), [p1, p2, p3](Triangle2D& t)
-									{
-										return TriContainsVertex(t, p1) || TriContainsVertex(t, p2) || TriContainsVertex(t, p3);
-									}), end(_triangles));
-
-	//for (const auto t : _triangles)
-	//{
-	//	_edges.push_back(Edge<float>{*t.a, * t.b});
-	//	_edges.push_back(Edge<float>{*t.b, * t.c});
-	//	_edges.push_back(Edge<float>{*t.c, * t.a});
-	//}
-
-	return _triangles;
+	HalfEdgeMesh mesh;
+	mesh.Triangulate(points);
+	return mesh;
 }
 
 bool TESTS::PointTriangle(Point3D point, Triangle const& triangle)
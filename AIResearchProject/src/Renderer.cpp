@@ -278,9 +278,15 @@ void Renderer::RenderScene(Camera& camera, bool thicken)
 	//}
 }
 
-void Renderer::GenerateTerrain(unsigned int seed, unsigned int no_pts, glm::vec3 map_scale, unsigned int perlin_oct, float perlin_persistance, float perlin_freq)
+void Renderer::GenerateTerrain(TerrainSettings const& settings)
 {
-	m_mesh_loader.LoadTerrain(terrain, seed, no_pts, map_scale, perlin_oct, perlin_persistance, perlin_freq);
+	m_mesh_loader.LoadTerrain(terrain, settings);
+}
+
+void Renderer::ErodeTerrain(EROSION::ThermalSettings const& thermal)
+{
+	terrain.ApplyThermal(thermal);
+	m_mesh_loader.UploadTerrain(terrain.TakeOutput());
 }
 
 void Renderer::RenderBVH(Camera& camera, BVHNode* root, BVTYPE type, int depth, bool thicken)
@@ -341,7 +347,7 @@ void DebugRenderer::RenderDebugSphere(Mesh const* mesh, Point3D const& position,
 	OGLWRAPPER::SetPolygonMode(GL_LINE);
 	OGLWRAPPER::SetFloat3Uniform(shdr_id, "u_debug_clr", clr);
 	OGLWRAPPER::SetIntUniform(shdr_id, "u_debug_flag", 1);
-	OGLWRAPPER::DrawArrays(GL_TRIANGLES, 0, static_cast<unsigned int>(mesh->m_position_buffer.size()));
+	OGLWRAPPER::DrawArrays(GL_TRIANGLES, 0, mesh->VertexCount());
 	OGLWRAPPER::SetPolygonMode(GL_FILL);
 
 	if (engine.GetEditor().m_render_vertices)
@@ -349,7 +355,7 @@ void DebugRenderer::RenderDebugSphere(Mesh const* mesh, Point3D const& position,
 		OGLWRAPPER::SetPointSize(5.f);
 		OGLWRAPPER::SetFloat3Uniform(shdr_id, "u_debug_clr", glm::vec3(1.f, 0.f, 1.f));
 		OGLWRAPPER::SetIntUniform(shdr_id, "u_debug_flag", 1);
-		OGLWRAPPER::DrawArrays(GL_POINTS, 0, static_cast<unsigned int>(mesh->m_position_buffer.size()));
+		OGLWRAPPER::DrawArrays(GL_POINTS, 0, mesh->VertexCount());
 		OGLWRAPPER::SetPointSize(1.f);
 	}
 
@@ -374,7 +380,7 @@ void DebugRenderer::RenderDebugSphere(Mesh const* mesh, Point3D const& position,
 	OGLWRAPPER::SetPolygonMode(GL_LINE);
 	OGLWRAPPER::SetFloat3Uniform(shdr_id, "u_debug_clr", clr);
 	OGLWRAPPER::SetIntUniform(shdr_id, "u_debug_flag", 1);
-	OGLWRAPPER::DrawArrays(GL_TRIANGLES, 0, static_cast<unsigned int>(mesh->m_position_buffer.size()));
+	OGLWRAPPER::DrawArrays(GL_TRIANGLES, 0, mesh->VertexCount());
 	OGLWRAPPER::SetPolygonMode(GL_FILL);
 
 	if (engine.GetEditor().m_render_vertices)
@@ -382,7 +388,7 @@ void DebugRenderer::RenderDebugSphere(Mesh const* mesh, Point3D const& position,
 		OGLWRAPPER::SetPointSize(5.f);
 		OGLWRAPPER::SetFloat3Uniform(shdr_id, "u_debug_clr", glm::vec3(1.f, 0.f, 1.f));
 		OGLWRAPPER::SetIntUniform(shdr_id, "u_debug_flag", 1);
-		OGLWRAPPER::DrawArrays(GL_POINTS, 0, static_cast<unsigned int>(mesh->m_position_buffer.size()));
+		OGLWRAPPER::DrawArrays(GL_POINTS, 0, mesh->VertexCount());
 		OGLWRAPPER::SetPointSize(1.f);
 	}
 
@@ -444,7 +450,7 @@ void DebugRenderer::RenderDebugPlane(Mesh const* mesh, glm::vec4 normal, unsigne
 
 	OGLWRAPPER::SetLineSize(thickness);
 	OGLWRAPPER::SetPointSize(5.f);
-	OGLWRAPPER::DrawArrays(GL_TRIANGLES, 0, static_cast<unsigned int>(mesh->m_position_buffer.size()));
+	OGLWRAPPER::DrawArrays(GL_TRIANGLES, 0, mesh->VertexCount());
 	OGLWRAPPER::SetPointSize(1.f);
 	OGLWRAPPER::SetLineSize(1.f);
 
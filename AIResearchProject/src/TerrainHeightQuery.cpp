@@ -0,0 +1,175 @@
+#include "TerrainHeightQuery.h"
+#include "CustomMath.h"
+#include "Utils.h"
+
+#include <cmath>
+#include <limits>
+
+namespace
+{
+	constexpr float BARY_EPSILON = 1e-5f;
+	constexpr float TRIANGLES_PER_CELL = 2.f;
+	constexpr size_t SAMPLE_CHUNK = 1024;
+}
+
+void TerrainHeightQuery::Build(std::vector<glm::vec3> const& vertices, std::vector<unsigned int> const& indices, std::pmr::memory_resource* scratch)
+{
+	Clear();
+
+	size_t triangle_count = indices.empty() ? vertices.size() / 3 : indices.size() / 3;
+	if (triangle_count == 0)
+		return;
+
+	m_min = glm::vec2(std::numeric_limits<float>::max());
+	m_max = glm::vec2(std::numeric_limits<float>::lowest());
+
+	std::pmr::vector<glm::vec2> tri_min(scratch), tri_max(scratch);
+	tri_min.reserve(triangle_count);
+	tri_max.reserve(triangle_count);
+	m_triangles.reserve(triangle_count);
+	m_triangle_ids.reserve(triangle_count);
+
+	for (size_t i{}; i < triangle_count; ++i)
+	{
+		glm::vec3 v0, v1, v2;
+		if (indices.empty())
+		{
+			v0 = vertices[i * 3];
+			v1 = vertices[i * 3 + 1];
+			v2 = vertices[i * 3 + 2];
+		}
+		else
+		{
+			v0 = vertices[indices[i * 3]];
+			v1 = vertices[indices[i * 3 + 1]];
+			v2 = vertices[indices[i * 3 + 2]];
+		}
+
+		glm::vec3 e1 = v1 - v0;
+		glm::vec3 e2 = v2 - v0;
+
+		// Triangles with no xz footprint can never be the answer to a height lookup
+		float det = e1.x * e2.z - e2.x * e1.z;
+		if (std::fabs(det) < std::numeric_limits<float>::epsilon())
+			continue;
+
+		GridTriangle tri;
+		tri.origin = glm::vec2(v0.x, v0.z);
+		tri.inv_row0 = glm::vec2(e2.z, -e2.x) / det;
+		tri.inv_row1 = glm::vec2(-e1.z, e1.x) / det;
+		tri.y0 = v0.y;
+		tri.dy1 = e1.y;
+		tri.dy2 = e2.y;
+		tri.normal = glm::normalize(glm::cross(e1, e2));
+		if (tri.normal.y < 0.f)
+			tri.normal = -tri.normal;
+
+		glm::vec2 lo = glm::min(glm::vec2(v0.x, v0.z), glm::min(glm::vec2(v1.x, v1.z), glm::vec2(v2.x, v2.z)));
+		glm::vec2 hi = glm::max(glm::vec2(v0.x, v0.z), glm::max(glm::vec2(v1.x, v1.z), glm::vec2(v2.x, v2.z)));
+		m_min = glm::min(m_min, lo);
+		m_max = glm::max(m_max, hi);
+
+		tri_min.push_back(lo);
+		tri_max.push_back(hi);
+		m_triangles.push_back(tri);
+		m_triangle_ids.push_back(static_cast<unsigned int>(i));
+	}
+
+	if (m_triangles.empty())
+		return;
+
+	// Square-ish cells sized so each holds about TRIANGLES_PER_CELL triangles
+	glm::vec2 extent = glm::max(m_max - m_min, glm::vec2(std::numeric_limits<float>::epsilon()));
+	float cell_size = std::sqrt(extent.x * extent.y * TRIANGLES_PER_CELL / static_cast<float>(m_triangles.size()));
+	m_cells_x = CMAX(1, static_cast<int>(extent.x / cell_size));
+	m_cells_z = CMAX(1, static_cast<int>(extent.y / cell_size));
+	m_inv_cell_size = glm::vec2(m_cells_x / extent.x, m_cells_z / extent.y);
+
+	size_t cell_count = static_cast<size_t>(m_cells_x) * m_cells_z;
+	m_cell_start.assign(cell_count + 1, 0);
+
+	// Two passes: count per cell, prefix sum, then scatter
+	for (size_t i{}; i < m_triangles.size(); ++i)
+	{
+		for (int z = CellZ(tri_min[i].y); z <= CellZ(tri_max[i].y); ++z)
+			for (int x = CellX(tri_min[i].x); x <= CellX(tri_max[i].x); ++x)
+				++m_cell_start[static_cast<size_t>(z) * m_cells_x + x + 1];
+	}
+
+	for (size_t c{}; c < cell_count; ++c)
+		m_cell_start[c + 1] += m_cell_start[c];
+
+	m_cell_triangles.resize(m_cell_start.back());
+	std::pmr::vector<unsigned int> cursor(m_cell_start.begin(), m_cell_start.end() - 1, scratch);
+
+	for (size_t i{}; i < m_triangles.size(); ++i)
+	{
+		for (int z = CellZ(tri_min[i].y); z <= CellZ(tri_max[i].y); ++z)
+			for (int x = CellX(tri_min[i].x); x <= CellX(tri_max[i].x); ++x)
+				m_cell_triangles[cursor[static_cast<size_t>(z) * m_cells_x + x]++] = static_cast<unsigned int>(i);
+	}
+}
+
+void TerrainHeightQuery::Clear()
+{
+	m_triangles.clear();
+	m_triangle_ids.clear();
+	m_cell_start.clear();
+	m_cell_triangles.clear();
+	m_cells_x = m_cells_z = 0;
+}
+
+int TerrainHeightQuery::CellX(float x) const
+{
+	int cell = static_cast<int>((x - m_min.x) * m_inv_cell_size.x);
+	return cell < 0 ? 0 : (cell >= m_cells_x ? m_cells_x - 1 : cell);
+}
+
+int TerrainHeightQuery::CellZ(float z) const
+{
+	int cell = static_cast<int>((z - m_min.y) * m_inv_cell_size.y);
+	return cell < 0 ? 0 : (cell >= m_cells_z ? m_cells_z - 1 : cell);
+}
+
+HeightSample TerrainHeightQuery::Sample(float x, float z) const
+{
+	HeightSample sample;
+	if (m_triangles.empty() || x < m_min.x || x > m_max.x || z < m_min.y || z > m_max.y)
+		return sample;
+
+	size_t cell = static_cast<size_t>(CellZ(z)) * m_cells_x + CellX(x);
+	glm::vec2 p(x, z);
+
+	for (unsigned int k = m_cell_start[cell]; k < m_cell_start[cell + 1]; ++k)
+	{
+		GridTriangle const& tri = m_triangles[m_cell_triangles[k]];
+		glm::vec2 d = p - tri.origin;
+		float u = glm::dot(tri.inv_row0, d);
+		float v = glm::dot(tri.inv_row1, d);
+
+		if (u < -BARY_EPSILON || v < -BARY_EPSILON || u + v > 1.f + BARY_EPSILON)
+			continue;
+
+		sample.height = tri.y0 + u * tri.dy1 + v * tri.dy2;
+		sample.normal = tri.normal;
+		sample.triangle = m_triangle_ids[m_cell_triangles[k]];
+		break;
+	}
+
+	return sample;
+}
+
+float TerrainHeightQuery::Height(float x, float z, float fallback) const
+{
+	HeightSample sample = Sample(x, z);
+	return sample.Valid() ? sample.height : fallback;
+}
+
+void TerrainHeightQuery::Sample(glm::vec2 const* xz, size_t count, HeightSample* samples) const
+{
+	UTILS::ParallelFor(count, SAMPLE_CHUNK, [&](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; ++i)
+			samples[i] = Sample(xz[i].x, xz[i].y);
+	});
+}
@@ -0,0 +1,284 @@
+#include "TerrainRayQuery.h"
+#include "Utils.h"
+
+#include <algorithm>
+
+namespace
+{
+	using FN = SIMD::FN;
+
+	constexpr float RAY_EPSILON = 1e-7f;
+	constexpr int STACK_SIZE = 64;
+	constexpr size_t PACKET_CHUNK = 256;
+
+	inline bool RayBox(glm::vec3 const& origin, glm::vec3 const& inv_dir, glm::vec3 const& min_p, glm::vec3 const& max_p, float t_max, float& t_entry)
+	{
+		glm::vec3 t1 = (min_p - origin) * inv_dir;
+		glm::vec3 t2 = (max_p - origin) * inv_dir;
+		glm::vec3 t_lo = glm::min(t1, t2);
+		glm::vec3 t_hi = glm::max(t1, t2);
+
+		float t_near = glm::max(glm::max(t_lo.x, t_lo.y), glm::max(t_lo.z, 0.f));
+		float t_far = glm::min(glm::min(t_hi.x, t_hi.y), glm::min(t_hi.z, t_max));
+
+		t_entry = t_near;
+		return t_near <= t_far;
+	}
+}
+
+void TerrainRayQuery::Build(std::vector<glm::vec3> const& vertices, std::vector<unsigned int> const& indices, std::pmr::memory_resource* scratch)
+{
+	Clear();
+
+	m_triangle_count = indices.empty() ? vertices.size() / 3 : indices.size() / 3;
+	if (m_triangle_count == 0)
+		return;
+
+	std::pmr::vector<BuildTriangle> tris(m_triangle_count, scratch);
+	for (size_t i{}; i < m_triangle_count; ++i)
+	{
+		BuildTriangle& tri = tris[i];
+		if (indices.empty())
+		{
+			tri.v0 = vertices[i * 3];
+			tri.v1 = vertices[i * 3 + 1];
+			tri.v2 = vertices[i * 3 + 2];
+		}
+		else
+		{
+			tri.v0 = vertices[indices[i * 3]];
+			tri.v1 = vertices[indices[i * 3 + 1]];
+			tri.v2 = vertices[indices[i * 3 + 2]];
+		}
+
+		tri.min = glm::min(tri.v0, glm::min(tri.v1, tri.v2));
+		tri.max = glm::max(tri.v0, glm::max(tri.v1, tri.v2));
+		tri.centroid = (tri.v0 + tri.v1 + tri.v2) / 3.f;
+		tri.id = static_cast<unsigned int>(i);
+	}
+
+	size_t leaf_count = (m_triangle_count + LANES - 1) / LANES;
+	m_nodes.reserve(leaf_count * 2);
+	m_blocks.reserve(leaf_count);
+
+	BuildRecursive(tris, 0, tris.size());
+}
+
+void TerrainRayQuery::Clear()
+{
+	m_nodes.clear();
+	m_blocks.clear();
+	m_triangle_count = 0;
+}
+
+unsigned int TerrainRayQuery::BuildRecursive(std::pmr::vector<BuildTriangle>& tris, size_t begin, size_t end)
+{
+	unsigned int node_index = static_cast<unsigned int>(m_nodes.size());
+	m_nodes.emplace_back();
+
+	glm::vec3 min_p{ std::numeric_limits<float>::max() };
+	glm::vec3 max_p{ std::numeric_limits<float>::lowest() };
+	glm::vec3 centroid_min{ std::numeric_limits<float>::max() };
+	glm::vec3 centroid_max{ std::numeric_limits<float>::lowest() };
+
+	for (size_t i = begin; i < end; ++i)
+	{
+		min_p = glm::min(min_p, tris[i].min);
+		max_p = glm::max(max_p, tris[i].max);
+		centroid_min = glm::min(centroid_min, tris[i].centroid);
+		centroid_max = glm::max(centroid_max, tris[i].centroid);
+	}
+
+	if (end - begin <= LANES)
+	{
+		// Pad unused lanes with degenerate triangles, their zero determinant never reports a hit
+		TriangleBlock block{};
+		for (int lane{}; lane < LANES; ++lane)
+		{
+			block.id[lane] = RayHit::NONE;
+			if (begin + lane >= end)
+				continue;
+
+			BuildTriangle const& tri = tris[begin + lane];
+			glm::vec3 e1 = tri.v1 - tri.v0;
+			glm::vec3 e2 = tri.v2 - tri.v0;
+
+			block.v0x[lane] = tri.v0.x; block.v0y[lane] = tri.v0.y; block.v0z[lane] = tri.v0.z;
+			block.e1x[lane] = e1.x;		block.e1y[lane] = e1.y;		block.e1z[lane] = e1.z;
+			block.e2x[lane] = e2.x;		block.e2y[lane] = e2.y;		block.e2z[lane] = e2.z;
+			block.id[lane] = tri.id;
+		}
+
+		m_nodes[node_index] = Node{ min_p, static_cast<unsigned int>(m_blocks.size()), max_p, 1 };
+		m_blocks.push_back(block);
+		return node_index;
+	}
+
+	// Median split on the longest centroid axis, terrain triangles are close to uniform in xz
+	glm::vec3 extent = centroid_max - centroid_min;
+	int axis = 0;
+	if (extent.y > extent[axis]) axis = 1;
+	if (extent.z > extent[axis]) axis = 2;
+
+	// Keep the left side a multiple of LANES so leaves stay full
+	size_t mid = begin + ((end - begin) / 2 + LANES - 1) / LANES * LANES;
+	if (mid >= end)
+		mid = begin + LANES;
+
+	std::nth_element(tris.begin() + begin, tris.begin() + mid, tris.begin() + end,
+		[axis](BuildTriangle const& a, BuildTriangle const& b) { return a.centroid[axis] < b.centroid[axis]; });
+
+	BuildRecursive(tris, begin, mid);
+	unsigned int right = BuildRecursive(tris, mid, end);
+
+	m_nodes[node_index] = Node{ min_p, right, max_p, 0 };
+	return node_index;
+}
+
+template <bool ANY_HIT>
+bool TerrainRayQuery::Traverse(Ray const& ray, float t_max, RayHit& hit) const
+{
+	if (m_nodes.empty())
+		return false;
+
+	const glm::vec3 origin = ray.origin.p;
+	const glm::vec3 dir = ray.direction.p;
+	const glm::vec3 inv_dir = 1.f / dir;
+
+	const FN ox = FN::Set1(origin.x), oy = FN::Set1(origin.y), oz = FN::Set1(origin.z);
+	const FN dx = FN::Set1(dir.x), dy = FN::Set1(dir.y), dz = FN::Set1(dir.z);
+	const FN zero = FN::Zero(), one = FN::Set1(1.f), eps = FN::Set1(RAY_EPSILON);
+
+	float t_best = t_max;
+	bool found = false;
+
+	unsigned int stack[STACK_SIZE];
+	int top{};
+	stack[top++] = 0;
+
+	while (top)
+	{
+		Node const& node = m_nodes[stack[--top]];
+
+		float t_entry;
+		if (!RayBox(origin, inv_dir, node.min, node.max, t_best, t_entry))
+			continue;
+
+		if (!node.leaf)
+		{
+			// Visit the nearer child first so t_best shrinks early
+			unsigned int left = static_cast<unsigned int>(&node - m_nodes.data()) + 1;
+			unsigned int right = node.index;
+
+			float t_left, t_right;
+			bool hit_left = RayBox(origin, inv_dir, m_nodes[left].min, m_nodes[left].max, t_best, t_left);
+			bool hit_right = RayBox(origin, inv_dir, m_nodes[right].min, m_nodes[right].max, t_best, t_right);
+
+			if (hit_left && hit_right)
+			{
+				if (t_left < t_right)
+					std::swap(left, right);
+				stack[top++] = left;
+				stack[top++] = right;
+			}
+			else if (hit_left)
+				stack[top++] = left;
+			else if (hit_right)
+				stack[top++] = right;
+			continue;
+		}
+
+		// Moller-Trumbore, one ray against LANES triangles
+		TriangleBlock const& block = m_blocks[node.index];
+
+		FN e1x = FN::Load(block.e1x), e1y = FN::Load(block.e1y), e1z = FN::Load(block.e1z);
+		FN e2x = FN::Load(block.e2x), e2y = FN::Load(block.e2y), e2z = FN::Load(block.e2z);
+
+		FN px = dy * e2z - dz * e2y;
+		FN py = dz * e2x - dx * e2z;
+		FN pz = dx * e2y - dy * e2x;
+		FN det = e1x * px + e1y * py + e1z * pz;
+		FN inv_det = one / det;
+
+		FN tx = ox - FN::Load(block.v0x);
+		FN ty = oy - FN::Load(block.v0y);
+		FN tz = oz - FN::Load(block.v0z);
+		FN u = (tx * px + ty * py + tz * pz) * inv_det;
+
+		FN qx = ty * e1z - tz * e1y;
+		FN qy = tz * e1x - tx * e1z;
+		FN qz = tx * e1y - ty * e1x;
+		FN v = (dx * qx + dy * qy + dz * qz) * inv_det;
+		FN t = (e2x * qx + e2y * qy + e2z * qz) * inv_det;
+
+		FN valid = (SIMD::Abs(det) > eps) & (u >= zero) & (v >= zero) & ((u + v) <= one) & (t > eps) & (t <= FN::Set1(t_best));
+		int mask = SIMD::Mask(valid);
+		if (!mask)
+			continue;
+
+		found = true;
+		if (ANY_HIT)
+			return true;
+
+		float t_lane[LANES], u_lane[LANES], v_lane[LANES];
+		t.Store(t_lane);
+		u.Store(u_lane);
+		v.Store(v_lane);
+
+		for (int lane{}; lane < LANES; ++lane)
+		{
+			if (!(mask & (1 << lane)) || t_lane[lane] > t_best)
+				continue;
+
+			t_best = t_lane[lane];
+			hit.t = t_lane[lane];
+			hit.u = u_lane[lane];
+			hit.v = v_lane[lane];
+			hit.triangle = block.id[lane];
+		}
+	}
+
+	return found;
+}
+
+RayHit TerrainRayQuery::Cast(Ray const& ray, float t_max) const
+{
+	RayHit hit;
+	Traverse<false>(ray, t_max, hit);
+	return hit;
+}
+
+bool TerrainRayQuery::Occluded(Ray const& ray, float t_max) const
+{
+	RayHit hit;
+	return Traverse<true>(ray, t_max, hit);
+}
+
+void TerrainRayQuery::Cast(Ray const* rays, size_t count, RayHit* hits, float t_max) const
+{
+	UTILS::ParallelFor(count, PACKET_CHUNK, [&](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; ++i)
+		{
+			hits[i] = RayHit{};
+			Traverse<false>(rays[i], t_max, hits[i]);
+		}
+	});
+}
+
+void TerrainRayQuery::LineOfSight(glm::vec3 const* from, glm::vec3 const* to, size_t count, unsigned char* visible) const
+{
+	UTILS::ParallelFor(count, PACKET_CHUNK, [&](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; ++i)
+		{
+			// Direction is the full segment so t in (0, 1) covers exactly from -> to
+			Ray ray;
+			ray.origin = from[i];
+			ray.direction = to[i] - from[i];
+
+			RayHit hit;
+			visible[i] = !Traverse<true>(ray, 1.f - RAY_EPSILON, hit);
+		}
+	});
+}
@@ -1 +1,189 @@
-#include "Utils.h"
\ No newline at end of file
+#include "Utils.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+namespace
+{
+	unsigned int s_worker_count{};
+	std::atomic<bool> s_pool_busy{};
+	thread_local bool s_in_range{};	// Set on pool threads and on a caller while it runs its own range
+
+	// Every arena allocation starts on a 16 byte boundary, enough for unaligned SIMD loads to stay within a cache line pair
+	constexpr size_t ARENA_ALIGNMENT = 16;
+	constexpr size_t ARENA_GRANULE = 64 * 1024;
+
+	// ParallelFor's workers, started on first use and kept until exit so a call costs a wake-up rather than thread
+	// creation. One call runs at a time: ranges are handed out under the mutex and the caller waits for the last one.
+	class WorkerPool
+	{
+	public:
+		~WorkerPool()
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_stop = true;
+			}
+			m_wake.notify_all();
+			for (auto& thread : m_threads)
+				thread.join();
+		}
+
+		void Run(size_t count, size_t chunk, void (*call)(void*, size_t, size_t), void* context)
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			const size_t ranges = (count + chunk - 1) / chunk;
+			while (m_threads.size() + 1 < ranges)
+				m_threads.emplace_back([this]() { Work(); });
+
+			m_call = call;
+			m_context = context;
+			m_count = count;
+			m_chunk = chunk;
+			m_ranges = ranges;
+			m_next = 1;
+			m_remaining = ranges - 1;
+			lock.unlock();
+			m_wake.notify_all();
+
+			s_in_range = true;
+			call(context, 0, std::min(chunk, count));
+			lock.lock();
+			while (m_next < m_ranges)
+				RunNext(lock);
+			s_in_range = false;
+
+			m_done.wait(lock, [this]() { return m_remaining == 0; });
+		}
+
+	private:
+		void Work()
+		{
+			s_in_range = true;
+			std::unique_lock<std::mutex> lock(m_mutex);
+			for (;;)
+			{
+				m_wake.wait(lock, [this]() { return m_stop || m_next < m_ranges; });
+				if (m_stop)
+					return;
+				RunNext(lock);
+			}
+		}
+
+		// Claims and runs the next range with the lock released, then counts it off
+		void RunNext(std::unique_lock<std::mutex>& lock)
+		{
+			const size_t begin = m_next++ * m_chunk;
+			const size_t end = std::min(begin + m_chunk, m_count);
+			auto call = m_call;
+			void* context = m_context;
+			lock.unlock();
+			call(context, begin, end);
+			lock.lock();
+			if (--m_remaining == 0)
+				m_done.notify_all();
+		}
+
+		std::mutex m_mutex;
+		std::condition_variable m_wake;
+		std::condition_variable m_done;
+		std::vector<std::thread> m_threads;
+		bool m_stop{};
+
+		void (*m_call)(void*, size_t, size_t) { nullptr };
+		void* m_context{ nullptr };
+		size_t m_count{};
+		size_t m_chunk{};
+		size_t m_ranges{};
+		size_t m_next{};
+		size_t m_remaining{};
+	};
+}
+
+UTILS::Arena::Arena(size_t capacity)
+{
+	if (capacity)
+	{
+		m_capacity = (capacity + ARENA_GRANULE - 1) / ARENA_GRANULE * ARENA_GRANULE;
+		m_block = static_cast<unsigned char*>(::operator new(m_capacity, std::align_val_t(ARENA_ALIGNMENT)));
+	}
+}
+
+UTILS::Arena::~Arena()
+{
+	Reset();
+	if (m_block)
+		::operator delete(m_block, std::align_val_t(ARENA_ALIGNMENT));
+}
+
+void UTILS::Arena::Reset()
+{
+	for (Spill const& spill : m_spills)
+		::operator delete(spill.ptr, std::align_val_t(spill.alignment));
+	m_spills.clear();
+
+	// Grow to what the last pass needed, with some slack for passes that come out slightly larger
+	if (m_used > m_capacity)
+	{
+		if (m_block)
+			::operator delete(m_block, std::align_val_t(ARENA_ALIGNMENT));
+
+		size_t target = m_used + m_used / 8;
+		m_capacity = (target + ARENA_GRANULE - 1) / ARENA_GRANULE * ARENA_GRANULE;
+		m_block = static_cast<unsigned char*>(::operator new(m_capacity, std::align_val_t(ARENA_ALIGNMENT)));
+	}
+
+	m_offset = 0;
+	m_used = 0;
+}
+
+void* UTILS::Arena::do_allocate(size_t bytes, size_t alignment)
+{
+	alignment = std::max(alignment, ARENA_ALIGNMENT);
+	size_t start = (m_offset + alignment - 1) & ~(alignment - 1);
+
+	if (m_block && start + bytes <= m_capacity)
+	{
+		m_used += start + bytes - m_offset;
+		m_offset = start + bytes;
+		return m_block + start;
+	}
+
+	// Counted as if it had fit, so the block grows to cover it on the next Reset
+	m_used += bytes + alignment;
+	void* ptr = ::operator new(bytes, std::align_val_t(alignment));
+	m_spills.push_back({ ptr, alignment });
+	return ptr;
+}
+
+void UTILS::SetWorkerCount(unsigned int count)
+{
+	s_worker_count = count;
+}
+
+unsigned int UTILS::GetWorkerCount()
+{
+	if (s_worker_count)
+		return s_worker_count;
+
+	unsigned int hw = std::thread::hardware_concurrency();
+	return hw ? hw : 1;
+}
+
+void UTILS::RunRanges(size_t count, size_t chunk, void (*call)(void*, size_t, size_t), void* context)
+{
+	// Waiting on the pool from inside one of its own ranges would never finish
+	bool expected = false;
+	if (s_in_range || !s_pool_busy.compare_exchange_strong(expected, true))
+	{
+		for (size_t begin{}; begin < count; begin += chunk)
+			call(context, begin, std::min(begin + chunk, count));
+		return;
+	}
+
+	static WorkerPool pool;
+	pool.Run(count, chunk, call, context);
+	s_pool_busy = false;
+}
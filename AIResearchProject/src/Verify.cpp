@@ -0,0 +1,410 @@
+#include "Verify.h"
+#include "Terrain.h"
+#include "CollisionWorld.h"
+#include "HalfEdgeMesh.h"
+#include "DualVoronoi.h"
+#include "Utils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+namespace
+{
+	constexpr const char* DEFAULT_GOLDENS = "verify/goldens.txt";
+
+	// Uneven counts as well, so ranges split at different points
+	constexpr unsigned int WORKER_COUNTS[] = { 1, 2, 5 };
+
+	struct Case
+	{
+		std::string name;
+		TerrainSettings settings;
+	};
+
+	std::vector<Case> MakeCases()
+	{
+		std::vector<Case> cases;
+
+		for (unsigned int seed : { 1234u, 7u, 424242u })
+			for (unsigned int points : { 2000u, 20000u })
+			{
+				Case c{ "seed=" + std::to_string(seed) + " points=" + std::to_string(points), TerrainSettings() };
+				c.settings.seed = seed;
+				c.settings.point_count = points;
+				cases.push_back(c);
+			}
+
+		// Each stage on top of the default terrain
+		auto variant = [&](std::string const& name)
+		{
+			Case c{ "seed=1234 points=20000 " + name, TerrainSettings() };
+			c.settings.point_count = 20000;
+			cases.push_back(c);
+			return &cases.back().settings;
+		};
+		variant("noise=simplex")->noise = NOISE::Backend::SIMPLEX;
+		variant("noise=perlin-float")->noise = NOISE::Backend::PERLIN_FLOAT;
+		variant("landform=alpine")->landform = NOISE::Landform::ALPINE;
+		{
+			TerrainSettings* s = variant("landform=badlands cells=craters");
+			s->landform = NOISE::Landform::BADLANDS;
+			s->cells.feature = NOISE::CellFeature::CRATERS;
+		}
+		variant("adaptive")->adaptive_density = true;
+		{
+			TerrainSettings* s = variant("min-angle=25 seed-boundary");
+			s->min_angle = 25.f;
+			s->seed_boundary = true;
+		}
+		{
+			TerrainSettings* s = variant("droplets=20000 thermal=10 erosion-resolution=256");
+			s->hydraulic.droplets = 20000;
+			s->thermal.iterations = 10;
+			s->erosion_resolution = 256;
+		}
+
+		return cases;
+	}
+
+	// FNV-1a over the bytes as stored
+	uint64_t Hash(uint64_t hash, const void* data, size_t bytes)
+	{
+		const unsigned char* p = static_cast<const unsigned char*>(data);
+		for (size_t i{}; i < bytes; ++i)
+			hash = (hash ^ p[i]) * 0x100000001B3ull;
+		return hash;
+	}
+
+	uint64_t HashTerrain(Terrain const& terrain)
+	{
+		std::vector<glm::vec3> const& positions = terrain.GetSharedVtx();
+		std::vector<unsigned int> const& indices = terrain.GetIndices();
+
+		uint64_t hash = 0xCBF29CE484222325ull;
+		hash = Hash(hash, positions.data(), positions.size() * sizeof(glm::vec3));
+		hash = Hash(hash, indices.data(), indices.size() * sizeof(unsigned int));
+		return hash;
+	}
+
+	std::string ToHex(uint64_t value)
+	{
+		std::ostringstream text;
+		text << std::hex << std::setw(16) << std::setfill('0') << value;
+		return text.str();
+	}
+
+	// One "<hash> <case name>" per line, # starts a comment
+	bool ReadGoldens(std::string const& path, std::map<std::string, std::string>& goldens)
+	{
+		std::ifstream file(path);
+		if (!file)
+			return false;
+
+		std::string line;
+		while (std::getline(file, line))
+		{
+			if (!line.empty() && line.back() == '\r')
+				line.pop_back();
+			if (line.empty() || line[0] == '#')
+				continue;
+
+			const size_t space = line.find(' ');
+			if (space == std::string::npos)
+				continue;
+			goldens[line.substr(space + 1)] = line.substr(0, space);
+		}
+		return true;
+	}
+
+	bool WriteGoldens(std::string const& path, std::vector<Case> const& cases, std::vector<std::string> const& hashes)
+	{
+		std::ofstream file(path, std::ios::trunc);
+		if (!file)
+			return false;
+
+		file << "# Golden terrain hashes for AIResearchProject --verify: FNV-1a of the shared vertex positions then the\n"
+				"# triangle indices. Rewrite with --verify --record only when a change is meant to alter generation.\n";
+		for (size_t i{}; i < cases.size(); ++i)
+			file << hashes[i] << ' ' << cases[i].name << '\n';
+		return static_cast<bool>(file);
+	}
+
+	// Segments along the hull of a grid, where the edge exists only as its hull half-edge, and a hull run through
+	// collinear vertices. These used to recurse until the stack overflowed.
+	bool CheckHullSegments()
+	{
+		std::vector<glm::vec2> grid;
+		for (int y{}; y < 4; ++y)
+			for (int x{}; x < 4; ++x)
+				grid.emplace_back(static_cast<float>(x), static_cast<float>(y));
+
+		HalfEdgeMesh mesh;
+		mesh.Triangulate(grid);
+		auto vertex = [&](float x, float y)
+		{
+			for (unsigned int i{}; i < mesh.points.size(); ++i)
+				if (mesh.points[i] == glm::vec2(x, y))
+					return i;
+			return HalfEdgeMesh::NONE;
+		};
+
+		const unsigned int corner = vertex(0.f, 0.f), next = vertex(1.f, 0.f), far = vertex(3.f, 0.f), top = vertex(3.f, 3.f);
+		if (mesh.FindEdge(corner, next) == HalfEdgeMesh::NONE || mesh.FindEdge(next, corner) == HalfEdgeMesh::NONE)
+			return false;
+		if (!mesh.InsertSegment(corner, next) || !mesh.InsertSegment(far, next) || !mesh.InsertSegment(corner, far) ||
+			!mesh.InsertSegment(far, top))
+			return false;
+
+		// Every piece of both hull runs is constrained
+		for (int x{}; x < 3; ++x)
+		{
+			const unsigned int e = mesh.FindEdge(vertex(static_cast<float>(x), 0.f), vertex(x + 1.f, 0.f));
+			const unsigned int f = mesh.FindEdge(vertex(3.f, static_cast<float>(x)), vertex(3.f, x + 1.f));
+			if (e == HalfEdgeMesh::NONE || f == HalfEdgeMesh::NONE || !mesh.constrained[e] || !mesh.constrained[f])
+				return false;
+		}
+		return true;
+	}
+
+	// The sweep against the dual of the Delaunay mesh, on uniform sites and on rows of sites sharing a height. The
+	// sweep used to drop and invent edges from a few thousand sites up, and divided by zero on sites at one height.
+	bool CheckFortuneVoronoi()
+	{
+		for (bool rows : { false, true })
+		{
+			UTILS::RNG<float> rng(0.f, 100.f, 1234u);
+			std::vector<glm::vec2> points(4000);
+			for (glm::vec2& p : points)
+			{
+				const float x = rng.getRNG(), y = rng.getRNG();
+				p = glm::vec2(x, rows ? std::floor(y / 5.f) * 5.f : y);
+			}
+
+			HalfEdgeMesh mesh;
+			mesh.Triangulate(points);
+			DualVoronoi dual;
+			dual.Build(mesh);
+			std::vector<VoronoiEdge> dual_edges;
+			dual.Edges(dual_edges);
+
+			std::vector<glm::dvec2> sites(points.begin(), points.end());
+			FortuneVoronoi fortune;
+			std::vector<VoronoiEdge> const& edges = fortune.Compute(sites, 100.0, 100.0);
+
+			auto key = [](VoronoiEdge const& e) { return std::make_pair(std::min(e.left_site, e.right_site), std::max(e.left_site, e.right_site)); };
+			std::map<std::pair<unsigned int, unsigned int>, VoronoiEdge const*> swept;
+			for (VoronoiEdge const& e : edges)
+			{
+				// Zero length between sites on one circle, where the mesh may hold either diagonal
+				if (e.start == e.end)
+					continue;
+				for (glm::dvec2 const& q : { e.start, e.end })
+				{
+					const double a = glm::length(q - sites[e.left_site]), b = glm::length(q - sites[e.right_site]);
+					if (std::abs(a - b) > 1e-9 * std::max(a, b))
+						return false;
+				}
+				swept[key(e)] = &e;
+			}
+
+			// One edge per Delaunay edge: the finite ones are the dual's, the hull's run off to infinity
+			size_t expected = std::count(mesh.halfedges.begin(), mesh.halfedges.end(), HalfEdgeMesh::NONE);
+			for (VoronoiEdge const& d : dual_edges)
+			{
+				if (d.start == d.end)
+					continue;
+				++expected;
+				auto found = swept.find(key(d));
+				if (found == swept.end())
+					return false;
+				VoronoiEdge const& e = *found->second;
+				const double tolerance = 1e-3 * (1.0 + glm::length(d.start) + glm::length(d.end));
+				const double forward = glm::length(e.start - d.start) + glm::length(e.end - d.end);
+				const double backward = glm::length(e.start - d.end) + glm::length(e.end - d.start);
+				if (std::min(forward, backward) > tolerance)
+					return false;
+			}
+			if (swept.size() != expected)
+				return false;
+		}
+		return true;
+	}
+
+	// A sphere through the ground plane is a contact and one clear of it is not. Plane tests classify, and the
+	// world used to keep every non-zero class, which is everything except the straddling case.
+	bool CheckPlaneContacts()
+	{
+		CollisionWorld world;
+		Plane ground;
+		world.AddPlane(ground, 0);
+		world.AddSphere(BoundingSphere(Point3D(glm::vec3(0.f, 0.25f, 0.f)), 0.5f), 1);
+		world.AddSphere(BoundingSphere(Point3D(glm::vec3(5.f, 2.f, 0.f)), 0.5f), 2);
+		world.AddSphere(BoundingSphere(Point3D(glm::vec3(-5.f, -2.f, 0.f)), 0.5f), 3);
+		world.Update();
+
+		std::vector<CollisionWorld::Contact> const& contacts = world.GetContacts();
+		return contacts.size() == 1 && world.GetOwner(contacts[0].b) == 1 && contacts[0].result == COPLANAR;
+	}
+
+	// Refinement on otherwise default settings reaches its bound. Unseeded hull edges used to be skipped whenever
+	// their midpoint rounded off the edge, which left hundreds of slivers along the border.
+	bool CheckMinAngle()
+	{
+		TerrainSettings settings;
+		settings.point_count = 5000;
+		settings.min_angle = 30.f;
+		Terrain terrain;
+		terrain.GeneratePoints(settings);
+
+		HalfEdgeMesh const& mesh = terrain.GetMesh();
+		double smallest = 180.0;
+		for (size_t t{}; t < mesh.TriangleCount(); ++t)
+			for (unsigned int k{}; k < 3; ++k)
+			{
+				glm::dvec2 p = mesh.points[mesh.triangles[t * 3 + k]];
+				glm::dvec2 u = glm::normalize(glm::dvec2(mesh.points[mesh.triangles[t * 3 + (k + 1) % 3]]) - p);
+				glm::dvec2 v = glm::normalize(glm::dvec2(mesh.points[mesh.triangles[t * 3 + (k + 2) % 3]]) - p);
+				smallest = std::min(smallest, glm::degrees(std::acos(glm::clamp(glm::dot(u, v), -1.0, 1.0))));
+			}
+		return smallest > settings.min_angle - 1e-3;
+	}
+
+	struct Check
+	{
+		const char* name;
+		bool (*run)();
+	};
+
+	const Check CHECKS[] =
+	{
+		{ "mesh: segments along the hull", CheckHullSegments },
+		{ "voronoi: Fortune sweep matches the Delaunay dual", CheckFortuneVoronoi },
+		{ "collision: sphere straddling a plane", CheckPlaneContacts },
+		{ "mesh: min-angle=30 without seed-boundary", CheckMinAngle },
+	};
+
+	void PrintUsage()
+	{
+		std::cout << "Usage: AIResearchProject --verify [--goldens PATH] [--record]\n";
+	}
+}
+
+bool VERIFY::Requested(int argc, char** argv)
+{
+	return argc > 1 && std::strcmp(argv[1], "--verify") == 0;
+}
+
+int VERIFY::Run(int argc, char** argv)
+{
+	std::string goldens_path = DEFAULT_GOLDENS;
+	bool record = false;
+	for (int i = 2; i < argc; ++i)
+	{
+		if (!std::strcmp(argv[i], "--record"))
+			record = true;
+		else if (!std::strcmp(argv[i], "--goldens") && i + 1 < argc)
+			goldens_path = argv[++i];
+		else
+		{
+			std::cout << "Unknown option " << argv[i] << "\n";
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	std::map<std::string, std::string> goldens;
+	if (!record && !ReadGoldens(goldens_path, goldens))
+	{
+		std::cout << "Cannot read " << goldens_path << ", run with --record to create it\n";
+		return 1;
+	}
+
+	const std::vector<Case> cases = MakeCases();
+	std::vector<std::string> hashes;
+	hashes.reserve(cases.size());
+
+	auto start = std::chrono::steady_clock::now();
+	int failures{};
+	for (Case const& c : cases)
+	{
+		// The same terrain at every worker count
+		std::string hash;
+		std::string disagreement;
+		for (unsigned int workers : WORKER_COUNTS)
+		{
+			UTILS::SetWorkerCount(workers);
+			Terrain terrain;
+			terrain.GeneratePoints(c.settings);
+			const std::string h = ToHex(HashTerrain(terrain));
+			if (hash.empty())
+				hash = h;
+			disagreement += (disagreement.empty() ? "" : ", ") + std::to_string(workers) + " workers " + h;
+			if (h != hash)
+				hash = "mismatch";
+		}
+		UTILS::SetWorkerCount(0);
+		hashes.push_back(hash);
+
+		if (hash == "mismatch")
+		{
+			std::cout << "FAIL " << c.name << ": depends on the worker count (" << disagreement << ")\n";
+			++failures;
+			continue;
+		}
+		if (record)
+		{
+			std::cout << "     " << c.name << ": " << hash << "\n";
+			continue;
+		}
+
+		auto golden = goldens.find(c.name);
+		if (golden == goldens.end())
+		{
+			std::cout << "FAIL " << c.name << ": no golden hash, got " << hash << "\n";
+			++failures;
+		}
+		else if (golden->second != hash)
+		{
+			std::cout << "FAIL " << c.name << ": expected " << golden->second << ", got " << hash << "\n";
+			++failures;
+		}
+		else
+			std::cout << "ok   " << c.name << "\n";
+	}
+	auto end = std::chrono::steady_clock::now();
+
+	int check_failures{};
+	for (Check const& check : CHECKS)
+	{
+		const bool passed = check.run();
+		std::cout << (passed ? "ok   " : "FAIL ") << check.name << "\n";
+		check_failures += passed ? 0 : 1;
+	}
+
+	if (record)
+	{
+		if (failures)
+		{
+			std::cout << "Not recording, " << failures << " of " << cases.size() << " cases depend on the worker count\n";
+			return 1;
+		}
+		if (!WriteGoldens(goldens_path, cases, hashes))
+		{
+			std::cout << "Failed to write " << goldens_path << "\n";
+			return 1;
+		}
+		std::cout << "Recorded " << cases.size() << " golden hashes to " << goldens_path << "\n";
+		return check_failures ? 1 : 0;
+	}
+
+	std::cout << cases.size() - failures << " of " << cases.size() << " cases match in "
+			  << std::chrono::duration<double, std::milli>(end - start).count() << " ms, "
+			  << std::size(CHECKS) - check_failures << " of " << std::size(CHECKS) << " checks pass\n";
+	return failures || check_failures ? 1 : 0;
+}
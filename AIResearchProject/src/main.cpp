@@ -1,10 +1,17 @@
 #include "Engine.h"
+#include "Bake.h"
+#include "Verify.h"
 
-int main()
+int main(int argc, char** argv)
 {
+	if (BAKE::Requested(argc, argv))
+		return BAKE::Run(argc, argv);
+	if (VERIFY::Requested(argc, argv))
+		return VERIFY::Run(argc, argv);
+
 	engine.Init();
 	engine.Update();
 	engine.End();
 
 	return 1;
-}
\ No newline at end of file
+}